@@ -128,6 +128,378 @@ namespace ngbla
 
 
 
+  /*
+    Gauss-Jordan elimination of [A | I] for SIMD<double>::Size() matrices
+    at once, lane k of the entries belongs to matrix k.
+    Rows are exchanged per lane, each pivot step touches only the
+    two rows of every lane.
+  */
+  void CalcInverse (FlatMatrix<SIMD<double>> inv)
+  {
+    constexpr size_t SW = SIMD<double>::Size();
+    size_t n = inv.Height();
+    Matrix<SIMD<double>> a(n, 2*n);
+    for (size_t i = 0; i < n; i++)
+      for (size_t k = 0; k < n; k++)
+        {
+          a(i,k) = inv(i,k);
+          a(i,n+k) = SIMD<double>(i==k ? 1.0 : 0.0);
+        }
+
+    for (size_t j = 0; j < n; j++)
+      {
+        // pivot search per lane
+        SIMD<double> maxval = fabs(a(j,j));
+        SIMD<double> piv = double(j);
+        SIMD<double> rest = 0.0;
+        for (size_t i = j+1; i < n; i++)
+          {
+            SIMD<double> val = fabs(a(i,j));
+            auto larger = val > maxval;
+            maxval = If (larger, val, maxval);
+            piv = If (larger, SIMD<double>(double(i)), piv);
+            rest += val;
+          }
+        for (size_t k = 0; k < SIMD<double>::Size(); k++)
+          if (maxval[k] <= 1e-20*rest[k])
+            throw Exception ("Inverse matrix: Matrix singular");
+
+        // exchange rows j and piv, only in the lanes which pivot
+        for (size_t l = 0; l < SW; l++)
+          {
+            size_t pivl = size_t(piv[l]);
+            if (pivl == j) continue;
+            double * rowj = (double*)&a(j,0);
+            double * rowp = (double*)&a(pivl,0);
+            for (size_t k = j; k < 2*n; k++)
+              swap (rowj[k*SW+l], rowp[k*SW+l]);
+          }
+
+        SIMD<double> hr = 1.0 / a(j,j);
+        for (size_t k = j; k < 2*n; k++)
+          a(j,k) *= hr;
+        for (size_t i = 0; i < n; i++)
+          if (i != j)
+            {
+              SIMD<double> fac = a(i,j);
+              for (size_t k = j; k < 2*n; k++)
+                a(i,k) -= fac * a(j,k);
+            }
+      }
+
+    for (size_t i = 0; i < n; i++)
+      for (size_t k = 0; k < n; k++)
+        inv(i,k) = a(i,n+k);
+  }
+
+
+  /// LU factorization PA = LU in lanes, p[j] is the row of A in row j of PA
+  static void CalcLU (FlatMatrix<SIMD<double>> a, FlatMatrix<int> p)
+  {
+    constexpr size_t SW = SIMD<double>::Size();
+    size_t n = a.Height();
+    for (size_t l = 0; l < SW; l++)
+      for (size_t i = 0; i < n; i++)
+        p(l,i) = i;
+
+    for (size_t j = 0; j < n; j++)
+      {
+        SIMD<double> maxval = fabs(a(j,j));
+        SIMD<double> piv = double(j);
+        SIMD<double> rest = 0.0;
+        for (size_t i = j+1; i < n; i++)
+          {
+            SIMD<double> val = fabs(a(i,j));
+            auto larger = val > maxval;
+            maxval = If (larger, val, maxval);
+            piv = If (larger, SIMD<double>(double(i)), piv);
+            rest += val;
+          }
+        for (size_t k = 0; k < SW; k++)
+          if (maxval[k] <= 1e-20*rest[k])
+            throw Exception ("CalcLU: Matrix singular");
+
+        for (size_t l = 0; l < SW; l++)
+          {
+            size_t pivl = size_t(piv[l]);
+            if (pivl == j) continue;
+            double * rowj = (double*)&a(j,0);
+            double * rowp = (double*)&a(pivl,0);
+            for (size_t k = 0; k < n; k++)
+              swap (rowj[k*SW+l], rowp[k*SW+l]);
+            swap (p(l,j), p(l,pivl));
+          }
+
+        SIMD<double> hr = 1.0 / a(j,j);
+        for (size_t i = j+1; i < n; i++)
+          {
+            SIMD<double> fac = a(i,j) * hr;
+            a(i,j) = fac;
+            for (size_t k = j+1; k < n; k++)
+              a(i,k) -= fac * a(j,k);
+          }
+      }
+  }
+
+  /// Cholesky factorization A = L L^T in lanes, L is stored in the lower triangle
+  static void CalcCholesky (FlatMatrix<SIMD<double>> a)
+  {
+    constexpr size_t SW = SIMD<double>::Size();
+    size_t n = a.Height();
+    for (size_t j = 0; j < n; j++)
+      {
+        SIMD<double> diag = a(j,j);
+        for (size_t k = 0; k < j; k++)
+          diag -= a(j,k) * a(j,k);
+        for (size_t l = 0; l < SW; l++)
+          if (!(diag[l] > 0))
+            throw Exception ("CalcCholesky: Matrix not positive definite");
+        SIMD<double> ljj = sqrt(diag);
+        a(j,j) = ljj;
+        SIMD<double> hr = 1.0 / ljj;
+        for (size_t i = j+1; i < n; i++)
+          {
+            SIMD<double> sum = a(i,j);
+            for (size_t k = 0; k < j; k++)
+              sum -= a(i,k) * a(j,k);
+            a(i,j) = sum * hr;
+          }
+      }
+  }
+
+  static void SolveFromLU (FlatMatrix<SIMD<double>> a, FlatMatrix<int> p, FlatMatrix<SIMD<double>> x)
+  {
+    constexpr size_t SW = SIMD<double>::Size();
+    size_t n = a.Height(), m = x.Width();
+    Matrix<SIMD<double>> hx = x;
+    for (size_t l = 0; l < SW; l++)
+      for (size_t i = 0; i < n; i++)
+        {
+          double * rowi = (double*)&x(i,0);
+          double * rowp = (double*)&hx(p(l,i),0);
+          for (size_t k = 0; k < m; k++)
+            rowi[k*SW+l] = rowp[k*SW+l];
+        }
+
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < i; j++)
+        for (size_t k = 0; k < m; k++)
+          x(i,k) -= a(i,j) * x(j,k);
+    for (size_t i = n; i-- > 0; )
+      {
+        for (size_t j = i+1; j < n; j++)
+          for (size_t k = 0; k < m; k++)
+            x(i,k) -= a(i,j) * x(j,k);
+        SIMD<double> hr = 1.0 / a(i,i);
+        for (size_t k = 0; k < m; k++)
+          x(i,k) *= hr;
+      }
+  }
+
+  static void SolveFromCholesky (FlatMatrix<SIMD<double>> a, FlatMatrix<SIMD<double>> x)
+  {
+    size_t n = a.Height(), m = x.Width();
+    for (size_t i = 0; i < n; i++)
+      {
+        for (size_t j = 0; j < i; j++)
+          for (size_t k = 0; k < m; k++)
+            x(i,k) -= a(i,j) * x(j,k);
+        SIMD<double> hr = 1.0 / a(i,i);
+        for (size_t k = 0; k < m; k++)
+          x(i,k) *= hr;
+      }
+    for (size_t i = n; i-- > 0; )
+      {
+        for (size_t j = i+1; j < n; j++)
+          for (size_t k = 0; k < m; k++)
+            x(i,k) -= a(j,i) * x(j,k);
+        SIMD<double> hr = 1.0 / a(i,i);
+        for (size_t k = 0; k < m; k++)
+          x(i,k) *= hr;
+      }
+  }
+
+
+  // indices of equal keys form batches of up to SW, func is called with the indices of a batch
+  template <typename FUNC>
+  static void ParallelForBatches (FlatArray<size_t> keys, FUNC func)
+  {
+    constexpr size_t SW = SIMD<double>::Size();
+    Array<int> index(keys.Size());
+    for (size_t i = 0; i < keys.Size(); i++)
+      index[i] = i;
+    QuickSortI (keys, index);
+
+    Array<IntRange> batches;
+    for (size_t i = 0; i < keys.Size(); )
+      {
+        size_t first = i;
+        while (i < keys.Size() && i-first < SW && keys[index[i]] == keys[index[first]])
+          i++;
+        batches.Append (IntRange(first, i));
+      }
+
+    ParallelFor (batches.Size(), [&] (size_t bnr)
+      {
+        func (index.Range(batches[bnr]));
+      });
+  }
+
+  // lane k of a gets mats[batch[k]], unused lanes get the identity
+  static void Interleave (FlatArray<FlatMatrix<double>> mats, FlatArray<int> batch,
+                          FlatMatrix<SIMD<double>> a)
+  {
+    constexpr size_t SW = SIMD<double>::Size();
+    double vals[SW];
+    for (size_t i = 0; i < a.Height(); i++)
+      for (size_t j = 0; j < a.Width(); j++)
+        {
+          for (size_t k = 0; k < SW; k++)
+            vals[k] = (k < batch.Size()) ? mats[batch[k]](i,j) : double(i==j);
+          a(i,j) = SIMD<double>(&vals[0]);
+        }
+  }
+
+  static void Deinterleave (FlatMatrix<SIMD<double>> a, FlatArray<FlatMatrix<double>> mats,
+                            FlatArray<int> batch)
+  {
+    constexpr size_t SW = SIMD<double>::Size();
+    double vals[SW];
+    for (size_t i = 0; i < a.Height(); i++)
+      for (size_t j = 0; j < a.Width(); j++)
+        {
+          a(i,j).Store (&vals[0]);
+          for (size_t k = 0; k < batch.Size(); k++)
+            mats[batch[k]](i,j) = vals[k];
+        }
+  }
+
+
+  void CalcInverseBatched (FlatArray<FlatMatrix<double>> mats)
+  {
+    static Timer t("CalcInverseBatched"); RegionTimer reg(t);
+
+    Array<size_t> sizes(mats.Size());
+    for (size_t i = 0; i < mats.Size(); i++)
+      sizes[i] = mats[i].Height();
+
+    ParallelForBatches (sizes, [&] (FlatArray<int> batch)
+      {
+        size_t n = mats[batch[0]].Height();
+        if (n == 0) return;
+        if (batch.Size() == 1 || n >= 100)
+          {
+            for (auto i : batch)
+              CalcInverse (mats[i]);
+            return;
+          }
+
+        Matrix<SIMD<double>> a(n, n);
+        Interleave (mats, batch, a);
+        CalcInverse (a);
+        Deinterleave (a, mats, batch);
+      });
+  }
+
+  void CalcLUBatched (FlatArray<FlatMatrix<double>> mats, FlatArray<FlatArray<int>> pivots)
+  {
+    static Timer t("CalcLUBatched"); RegionTimer reg(t);
+    constexpr size_t SW = SIMD<double>::Size();
+
+    Array<size_t> sizes(mats.Size());
+    for (size_t i = 0; i < mats.Size(); i++)
+      sizes[i] = mats[i].Height();
+
+    ParallelForBatches (sizes, [&] (FlatArray<int> batch)
+      {
+        size_t n = mats[batch[0]].Height();
+        if (n == 0) return;
+        if (batch.Size() == 1 || n >= 100)
+          {
+            for (auto i : batch)
+              CalcLU (mats[i], pivots[i]);
+            return;
+          }
+
+        Matrix<SIMD<double>> a(n, n);
+        Matrix<int> p(SW, n);
+        Interleave (mats, batch, a);
+        CalcLU (a, p);
+        Deinterleave (a, mats, batch);
+        for (size_t k = 0; k < batch.Size(); k++)
+          for (size_t i = 0; i < n; i++)
+            pivots[batch[k]][i] = p(k,i);
+      });
+  }
+
+  void SolveFromLUBatched (FlatArray<FlatMatrix<double>> mats, FlatArray<FlatArray<int>> pivots,
+                           FlatArray<FlatMatrix<double>> x)
+  {
+    static Timer t("SolveFromLUBatched"); RegionTimer reg(t);
+    constexpr size_t SW = SIMD<double>::Size();
+
+    Array<size_t> sizes(mats.Size());
+    for (size_t i = 0; i < mats.Size(); i++)
+      sizes[i] = (size_t(mats[i].Height()) << 32) + x[i].Width();
+
+    ParallelForBatches (sizes, [&] (FlatArray<int> batch)
+      {
+        size_t n = mats[batch[0]].Height(), m = x[batch[0]].Width();
+        if (n == 0 || m == 0) return;
+
+        Matrix<SIMD<double>> a(n, n), hx(n, m);
+        Matrix<int> p(SW, n);
+        for (size_t k = 0; k < SW; k++)
+          for (size_t i = 0; i < n; i++)
+            p(k,i) = (k < batch.Size()) ? pivots[batch[k]][i] : int(i);
+        Interleave (mats, batch, a);
+        Interleave (x, batch, hx);
+        SolveFromLU (a, p, hx);
+        Deinterleave (hx, x, batch);
+      });
+  }
+
+  void CalcCholeskyBatched (FlatArray<FlatMatrix<double>> mats)
+  {
+    static Timer t("CalcCholeskyBatched"); RegionTimer reg(t);
+
+    Array<size_t> sizes(mats.Size());
+    for (size_t i = 0; i < mats.Size(); i++)
+      sizes[i] = mats[i].Height();
+
+    ParallelForBatches (sizes, [&] (FlatArray<int> batch)
+      {
+        size_t n = mats[batch[0]].Height();
+        if (n == 0) return;
+        Matrix<SIMD<double>> a(n, n);
+        Interleave (mats, batch, a);
+        CalcCholesky (a);
+        Deinterleave (a, mats, batch);
+      });
+  }
+
+  void SolveFromCholeskyBatched (FlatArray<FlatMatrix<double>> mats, FlatArray<FlatMatrix<double>> x)
+  {
+    static Timer t("SolveFromCholeskyBatched"); RegionTimer reg(t);
+
+    Array<size_t> sizes(mats.Size());
+    for (size_t i = 0; i < mats.Size(); i++)
+      sizes[i] = (size_t(mats[i].Height()) << 32) + x[i].Width();
+
+    ParallelForBatches (sizes, [&] (FlatArray<int> batch)
+      {
+        size_t n = mats[batch[0]].Height(), m = x[batch[0]].Width();
+        if (n == 0 || m == 0) return;
+        Matrix<SIMD<double>> a(n, n), hx(n, m);
+        Interleave (mats, batch, a);
+        Interleave (x, batch, hx);
+        SolveFromCholesky (a, hx);
+        Deinterleave (hx, x, batch);
+      });
+  }
+
+
+
   void CalcSchurComplement (const FlatMatrix<double> a, 
 			    FlatMatrix<double> s,
 			    const BitArray & used,
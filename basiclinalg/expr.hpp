@@ -1895,6 +1895,22 @@ namespace ngbla
 
   extern NGS_DLL_HEADER void CalcInverse (FlatMatrix<double> inv, INVERSE_LIB il = INVERSE_LIB::INV_CHOOSE);
 
+  /// Calculate SIMD<double>::Size() inverses at once, lane k holds matrix k
+  extern NGS_DLL_HEADER void CalcInverse (FlatMatrix<SIMD<double>> inv);
+
+  /// Calculate many inverses, matrices of equal size are inverted together in SIMD lanes.
+  /// Used for the diagonal blocks of the block Jacobi preconditioner
+  extern NGS_DLL_HEADER void CalcInverseBatched (FlatArray<FlatMatrix<double>> mats);
+  /// LU factorizations as CalcLU, pivots[i] has the size of mats[i]
+  extern NGS_DLL_HEADER void CalcLUBatched (FlatArray<FlatMatrix<double>> mats, FlatArray<FlatArray<int>> pivots);
+  /// solves mats[i] x[i] = b[i] in place, factors from CalcLUBatched
+  extern NGS_DLL_HEADER void SolveFromLUBatched (FlatArray<FlatMatrix<double>> mats, FlatArray<FlatArray<int>> pivots,
+                                                 FlatArray<FlatMatrix<double>> x);
+  /// Cholesky factors L L^T of spd matrices, L is stored in the lower triangle
+  extern NGS_DLL_HEADER void CalcCholeskyBatched (FlatArray<FlatMatrix<double>> mats);
+  /// solves mats[i] x[i] = b[i] in place, factors from CalcCholeskyBatched
+  extern NGS_DLL_HEADER void SolveFromCholeskyBatched (FlatArray<FlatMatrix<double>> mats, FlatArray<FlatMatrix<double>> x);
+
   template <class T, class T2>
   inline void CalcInverse (const FlatMatrix<T> m, FlatMatrix<T2> inv)
   {
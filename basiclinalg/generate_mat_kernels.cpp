@@ -12,6 +12,18 @@ using namespace std;
   #define SIMD_SIZE ngcore::SIMD<double>::Size()
 #endif // SIMD_SIZE
 
+/*
+  target of the generated kernels, defaults to the host flags.
+  can be overwritten by the second command line argument
+  (avx2 or avx512) for the runtime dispatched kernel sets
+*/
+int simd_size = SIMD_SIZE;
+#ifdef __FMA__
+bool have_fma = true;
+#else
+bool have_fma = false;
+#endif
+
 enum OP { ADD, SUB, SET, SETNEG };
 enum ORDERING { ColMajor, RowMajor };
 
@@ -555,42 +567,46 @@ void GenerateMultiVecScalC_nofma (ostream & out, int h, int w, bool c)
 /*
   used in GenerateMultiVecScalC if __FMA__ is defined
 */
-#ifdef __FMA__
 void GenerateMultiVecScalC_fma (ostream & out, int h, int w, bool c)
 {
-  #if defined __AVX512F__
-    const string SIMD_TYPE = "__m512d";
-    const string SIMD_SHUFFLE = "_mm512_shuffle_pd";
-    const string SIMD_MUL = "_mm512_mul_pd";
-    const string SIMD_FMAADDSUB = "_mm512_fmaddsub_pd";
-
-    constexpr int shuffle1 = 0b11111111;
-    constexpr int shuffle2 = 0b01010101;
-
-    if (c) out << "SIMD<double> conj(_mm512_set_pd(-1,1,-1,1,-1,1,-1,1));" << endl;
-
-  #elif defined __AVX__
-    const string SIMD_TYPE = "__m256d";
-    const string SIMD_SHUFFLE = "_mm256_shuffle_pd";
-    const string SIMD_MUL = "_mm256_mul_pd";
-    const string SIMD_FMAADDSUB = "_mm256_fmaddsub_pd";
-
-    constexpr int shuffle1 = 0b1111;
-    constexpr int shuffle2 = 0b0101;
-
-    if (c) out << "SIMD<double> conj(1,-1,1,-1);" << endl;
-
-  #elif defined __SSE__
-    const string SIMD_TYPE = "__m128d";
-    const string SIMD_SHUFFLE = "_mm_shuffle_pd";
-    const string SIMD_MUL = "_mm_mul_pd";
-    const string SIMD_FMAADDSUB = "_mm_fmaddsub_pd";
-
-    constexpr int shuffle1 = 0b11;
-    constexpr int shuffle2 = 0b01;
-
-    if (c) out << "SIMD<double> conj(1,-1);" << endl;
-  #endif
+  string SIMD_TYPE, SIMD_SHUFFLE, SIMD_MUL, SIMD_FMAADDSUB;
+  int shuffle1, shuffle2;
+  if (simd_size == 8)
+    {
+      SIMD_TYPE = "__m512d";
+      SIMD_SHUFFLE = "_mm512_shuffle_pd";
+      SIMD_MUL = "_mm512_mul_pd";
+      SIMD_FMAADDSUB = "_mm512_fmaddsub_pd";
+      
+      shuffle1 = 0b11111111;
+      shuffle2 = 0b01010101;
+      
+      if (c) out << "SIMD<double> conj(_mm512_set_pd(-1,1,-1,1,-1,1,-1,1));" << endl;
+    }
+  else if (simd_size == 4)
+    {
+      SIMD_TYPE = "__m256d";
+      SIMD_SHUFFLE = "_mm256_shuffle_pd";
+      SIMD_MUL = "_mm256_mul_pd";
+      SIMD_FMAADDSUB = "_mm256_fmaddsub_pd";
+      
+      shuffle1 = 0b1111;
+      shuffle2 = 0b0101;
+      
+      if (c) out << "SIMD<double> conj(1,-1,1,-1);" << endl;
+    }
+  else
+    {
+      SIMD_TYPE = "__m128d";
+      SIMD_SHUFFLE = "_mm_shuffle_pd";
+      SIMD_MUL = "_mm_mul_pd";
+      SIMD_FMAADDSUB = "_mm_fmaddsub_pd";
+      
+      shuffle1 = 0b11;
+      shuffle2 = 0b01;
+      
+      if (c) out << "SIMD<double> conj(1,-1);" << endl;
+    }
 
   out << "constexpr int SW = SIMD<double>::Size();" << endl;
 
@@ -656,22 +672,26 @@ void GenerateMultiVecScalC_fma (ostream & out, int h, int w, bool c)
   // store results
   for (int i = 0; i < h; i++) {
     for (int j = 0; j < w; j++) {
-      #if defined __AVX512F__
-        out << "pc[" << j << "+" << i << "*dc].real((sum" << i << "_" << j << "[0] + sum" << i << "_" << j << "[2]) + (sum" << i << "_" << j << "[4] + sum" << i << "_" << j << "[6]));" << endl;
-        out << "pc[" << j << "+" << i << "*dc].imag((sum" << i << "_" << j << "[1] + sum" << i << "_" << j << "[3]) + (sum" << i << "_" << j << "[5] + sum" << i << "_" << j << "[7]));" << endl;
-      #elif defined __AVX__
-        out << "pc[" << j << "+" << i << "*dc].real(sum" << i << "_" << j << "[0] + sum" << i << "_" << j << "[2]);" << endl;
-        out << "pc[" << j << "+" << i << "*dc].imag(sum" << i << "_" << j << "[1] + sum" << i << "_" << j << "[3]);" << endl;
-      #elif defined __SSE__
-        out << "pc[" << j << "+" << i << "*dc].real(sum" << i << "_" << j << "[0]);" << endl;
-        out << "pc[" << j << "+" << i << "*dc].imag(sum" << i << "_" << j << "[1]);" << endl;
-      #endif
+      if (simd_size == 8)
+        {
+          out << "pc[" << j << "+" << i << "*dc].real((sum" << i << "_" << j << "[0] + sum" << i << "_" << j << "[2]) + (sum" << i << "_" << j << "[4] + sum" << i << "_" << j << "[6]));" << endl;
+          out << "pc[" << j << "+" << i << "*dc].imag((sum" << i << "_" << j << "[1] + sum" << i << "_" << j << "[3]) + (sum" << i << "_" << j << "[5] + sum" << i << "_" << j << "[7]));" << endl;
+        }
+      else if (simd_size == 4)
+        {
+          out << "pc[" << j << "+" << i << "*dc].real(sum" << i << "_" << j << "[0] + sum" << i << "_" << j << "[2]);" << endl;
+          out << "pc[" << j << "+" << i << "*dc].imag(sum" << i << "_" << j << "[1] + sum" << i << "_" << j << "[3]);" << endl;
+        }
+      else
+        {
+          out << "pc[" << j << "+" << i << "*dc].real(sum" << i << "_" << j << "[0]);" << endl;
+          out << "pc[" << j << "+" << i << "*dc].imag(sum" << i << "_" << j << "[1]);" << endl;
+        }
     }
   }
 
 out << "}" << endl;
 }
-#endif
 
 /*
   C = A * B^t
@@ -692,11 +712,10 @@ void GenerateMultiVecScalC (ostream & out, int h, int w, bool c)
   // The alternative version using fmaaddsub turned out to be faster
   // If FMA is not available we need
   // SIMD<Complex>, LoadFast and StoreFast
-  #ifdef __FMA__
+  if (have_fma)
     GenerateMultiVecScalC_fma (out, h, w, c);
-  #else
+  else
     GenerateMultiVecScalC_nofma (out, h, w, c);
-  #endif
 
 }
 
@@ -841,36 +860,40 @@ void GenerateMultiScaleAddC_nofma (ostream & out, int h, int w)
 /*
   used in GenerateMultiScaleAddC if __FMA__ is defined
 */
-#ifdef __FMA__
 void GenerateMultiScaleAddC_fma (ostream & out, int h, int w)
 {
-  #if defined __AVX512F__
-    const string SIMD_TYPE = "__m512d";
-    const string SIMD_SET = "_mm512_set1_pd";
-    const string SIMD_SHUFFLE = "_mm512_shuffle_pd";
-    const string SIMD_MUL = "_mm512_mul_pd";
-    const string SIMD_FMAADDSUB = "_mm512_fmaddsub_pd";
-
-    constexpr int swap_pairs = 0b01010101;
-
-  #elif defined __AVX__
-    const string SIMD_TYPE = "__m256d";
-    const string SIMD_SET = "_mm256_set1_pd";
-    const string SIMD_SHUFFLE = "_mm256_shuffle_pd";
-    const string SIMD_MUL = "_mm256_mul_pd";
-    const string SIMD_FMAADDSUB = "_mm256_fmaddsub_pd";
-
-    constexpr int swap_pairs = 0b0101;
-
-  #elif defined __SSE__
-    const string SIMD_TYPE = "__m128d";
-    const string SIMD_SET = "_mm_set1_pd";
-    const string SIMD_SHUFFLE = "_mm_shuffle_pd";
-    const string SIMD_MUL = "_mm_mul_pd";
-    const string SIMD_FMAADDSUB = "_mm_fmaddsub_pd";
-
-    constexpr int swap_pairs = 0b01;
-  #endif
+  string SIMD_TYPE, SIMD_SET, SIMD_SHUFFLE, SIMD_MUL, SIMD_FMAADDSUB;
+  int swap_pairs;
+  if (simd_size == 8)
+    {
+      SIMD_TYPE = "__m512d";
+      SIMD_SET = "_mm512_set1_pd";
+      SIMD_SHUFFLE = "_mm512_shuffle_pd";
+      SIMD_MUL = "_mm512_mul_pd";
+      SIMD_FMAADDSUB = "_mm512_fmaddsub_pd";
+      
+      swap_pairs = 0b01010101;
+    }
+  else if (simd_size == 4)
+    {
+      SIMD_TYPE = "__m256d";
+      SIMD_SET = "_mm256_set1_pd";
+      SIMD_SHUFFLE = "_mm256_shuffle_pd";
+      SIMD_MUL = "_mm256_mul_pd";
+      SIMD_FMAADDSUB = "_mm256_fmaddsub_pd";
+      
+      swap_pairs = 0b0101;
+    }
+  else
+    {
+      SIMD_TYPE = "__m128d";
+      SIMD_SET = "_mm_set1_pd";
+      SIMD_SHUFFLE = "_mm_shuffle_pd";
+      SIMD_MUL = "_mm_mul_pd";
+      SIMD_FMAADDSUB = "_mm_fmaddsub_pd";
+      
+      swap_pairs = 0b01;
+    }
 
   out << "constexpr int SW = SIMD<double>::Size();" << endl;
 
@@ -933,7 +956,6 @@ void GenerateMultiScaleAddC_fma (ostream & out, int h, int w)
   out << "}" << endl;
 
 }
-#endif
 
 /*
   A[i] += sum_j c(j,i) * y[j]
@@ -952,11 +974,10 @@ void GenerateMultiScaleAddC (ostream & out, int h, int w)
   // The alternative version using fmaaddsub turned out to be faster.
   // If FMA is not available we need
   // SIMD<Complex>, LoadFast and StoreFast
-  #ifdef __FMA__
+  if (have_fma)
     GenerateMultiScaleAddC_fma(out, h, w);
-  #else
+  else
     GenerateMultiScaleAddC_nofma(out, h, w);
-  #endif
 }
 
 
@@ -1261,7 +1282,7 @@ void GenerateShortSum (ostream & out, int wa, OP op)
   
   for (int r : { 8, 4, 2, 1})
     {
-      if (r > SIMD_SIZE) continue;
+      if (r > simd_size) continue;
       
       out << "if (rest & " << r << ") {  \n";
       if (wa > 0)
@@ -1644,7 +1665,7 @@ void  GenerateMatVec (ostream & out, int wa, OP op)
   out << "template <> INLINE void KernelMatVec<" << wa << ", " << ToString(op) << ">" << endl
       << "(size_t ha, double * pa, size_t da, double * x, double * y) {" << endl;
 
-  int SW = SIMD_SIZE;  // generate optimal code for my host
+  int SW = simd_size;  // generate optimal code for my host
   // out << "constexpr int SW = SIMD<double>::Size();" << endl;
   int i = 0;
   for ( ; SW*(i+1) <= wa; i++)
@@ -1781,7 +1802,7 @@ void GenerateAddMatVec (ostream & out, int wa)
   out << "template <> INLINE void KernelAddMatVec<" << wa << ">" << endl
       << "(double s, size_t ha, double * pa, size_t da, double * x, double * y) {" << endl;
 
-  int SW = SIMD_SIZE;  // generate optimal code for my host
+  int SW = simd_size;  // generate optimal code for my host
   int i = 0;
   for ( ; SW*(i+1) <= wa; i++)
     out << "SIMD<double," << SW << "> x" << i << "(x+" << i*SW << ");" << endl;
@@ -1916,7 +1937,7 @@ void GenerateAddMatTransVecI (ostream & out, int wa)
       << "inline void KernelAddMatTransVecI<" << wa << ">" << endl
       << "(double s, size_t ha, double * pa, size_t da, double * x, double * y, int * ind) {" << endl;
 
-  int SW = SIMD_SIZE;  // generate optimal code for my host
+  int SW = simd_size;  // generate optimal code for my host
 
   int nfull = wa / SW;
   int rest = wa % SW;
@@ -2312,6 +2333,20 @@ int main (int argn, char **argv)
 {
   ofstream out(argv[1]);
 
+  if (argn > 2)
+    {
+      string isa = argv[2];
+      if (isa == "avx2")
+        { simd_size = 4; have_fma = true; }
+      else if (isa == "avx512")
+        { simd_size = 8; have_fma = true; }
+      else
+        {
+          cerr << "unknown kernel isa " << isa << ", use avx2 or avx512" << endl;
+          return 1;
+        }
+    }
+
 
   out <<
 R"raw_string(
@@ -2371,7 +2406,7 @@ auto Concat (tuple<SIMD<double,N>, Args...> tup)
     "{ sum = FNMA(a,b,sum); }";
 
   
-  out << "static_assert(SIMD<double>::Size() == " << SIMD_SIZE << ", \"inconsistent compile flags for generate_mat_kernels.cpp and matkernel.hpp\");" << endl;
+  out << "static_assert(SIMD<double>::Size() == " << simd_size << ", \"inconsistent compile flags for generate_mat_kernels.cpp and matkernel.hpp\");" << endl;
   out << "enum OPERATION { ADD, SUB, SET, SETNEG };" << endl;
 
   out << " /* *********************** MatKernelMultAB ********************* */" << endl
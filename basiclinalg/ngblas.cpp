@@ -2,6 +2,10 @@
 
 #include <bla.hpp>
 
+#if defined(NGBLAS_DISPATCH_AVX2) || defined(NGBLAS_DISPATCH_AVX512)
+#include <dlfcn.h>
+#endif
+
 
 // do we have 32 vector-registers ?
 #if defined(__AVX512F__) || defined(__arm64__)
@@ -1412,7 +1416,74 @@ namespace ngbla
     // dispatch_matvec[std::size(dispatch_matvec)-1] = &MultMatVec_intern;
     return 1;
   }();
-  
+
+
+  /* ********************* runtime cpu dispatch ************************** */
+
+  // kernel sets compiled from ngblas_isa.cpp into separate modules next
+  // to this library, see USE_KERNEL_DISPATCH
+#if defined(NGBLAS_DISPATCH_AVX2) || defined(NGBLAS_DISPATCH_AVX512)
+  static bool LoadKernelModule (string isa)
+  {
+    Dl_info info;
+    if (!dladdr ((void*)&GetKernelISA, &info) || !info.dli_fname)
+      return false;
+    try
+      {
+        // never unloaded, the dispatch tables point into it
+        auto lib = new SharedLibrary (filesystem::path(info.dli_fname).parent_path()
+                                      / ("libngbla_" + isa + ".so"));
+        lib->GetFunction<void(*)()> ("ngbla_set_dispatch_tables") ();
+        return true;
+      }
+    catch (const std::runtime_error & e)
+      {
+        cout << IM(3) << "could not load " << isa << " kernels: " << e.what() << endl;
+        return false;
+      }
+  }
+#endif
+
+#if defined(__AVX512F__)
+  static string kernel_isa = "avx512 (compiled)";
+#elif defined(__AVX2__)
+  static string kernel_isa = "avx2 (compiled)";
+#elif defined(__AVX__)
+  static string kernel_isa = "avx (compiled)";
+#elif defined(__arm64__)
+  static string kernel_isa = "neon (compiled)";
+#else
+  static string kernel_isa = "sse (compiled)";
+#endif
+
+  // must run after the table initializers above
+  auto init_dispatch_isa = [] ()
+  {
+#ifdef NGBLAS_DISPATCH_AVX512
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") &&
+        __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw") &&
+        LoadKernelModule ("avx512"))
+      {
+        kernel_isa = "avx512 (runtime dispatch)";
+        return 1;
+      }
+#endif
+#ifdef NGBLAS_DISPATCH_AVX2
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+        LoadKernelModule ("avx2"))
+      {
+        kernel_isa = "avx2 (runtime dispatch)";
+        return 1;
+      }
+#endif
+    return 0;
+  }();
+
+  string GetKernelISA ()
+  {
+    return kernel_isa;
+  }
+
   
   template <typename TAB, typename FUNC>
   INLINE void TAddABt4 (size_t wa, size_t hc, size_t wc,
@@ -2860,7 +2931,8 @@ namespace ngbla
   {
     if (what < 0)
       {
-        cout << "Available options timings are:\n"
+        cout << "ngblas kernels: " << GetKernelISA() << "\n"
+             << "Available options timings are:\n"
           "-1 .. this help\n"
           "0 ... run all timings\n"
           "1 ... A = B,   A,B = n*m,   A = aligned, fixed dist\n"
@@ -2898,6 +2970,7 @@ namespace ngbla
       }
 
     list<tuple<string,double>> timings;
+    cout << IM(3) << "ngblas kernels: " << GetKernelISA() << endl;
     constexpr int SW = SIMD<double>::Size();
     if (what == 0 || what == 1)
       {
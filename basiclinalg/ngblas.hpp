@@ -561,6 +561,9 @@ namespace ngbla
   
   extern list<tuple<string,double>> Timing (int what, size_t n, size_t m, size_t k, bool lapack, size_t maxits);
 
+  // instruction set of the small matrix kernels, selected at startup
+  extern NGS_DLL_HEADER string GetKernelISA ();
+
 
   double MatKernelMaskedScalAB (size_t n,
 				double * pa, size_t da,
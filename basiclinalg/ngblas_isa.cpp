@@ -0,0 +1,126 @@
+/*********************************************************************/
+/* File:   ngblas_isa.cpp                                            */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+/*
+  Kernel set for runtime cpu dispatch.
+
+  This file is compiled once per instruction set, with -DNGBLAS_ISA=avx2 or
+  -DNGBLAS_ISA=avx512 and the corresponding -march flags, into the modules
+  libngbla_avx2 and libngbla_avx512. The include path points to the
+  matkernel.hpp generated for this instruction set. All kernels live in
+  the namespace ngbla::NGBLAS_ISA, SetDispatchTables () overwrites the
+  small-size entries of the dispatch tables from ngblas.cpp. The
+  large-size fallbacks stay with the baseline kernels.
+
+  The modules are built with hidden visibility and bind their symbols
+  locally, and ngblas.cpp loads them only after the cpu check. So the
+  inline functions from bla.hpp compiled here never replace the baseline
+  copies in ngbla.
+*/
+
+#define COMPILE_NGBLAS
+
+#include <bla.hpp>
+
+
+namespace ngbla
+{
+  namespace NGBLAS_ISA
+  {
+
+#if defined(__AVX512F__)
+    constexpr bool reg32 = true;
+#else
+    constexpr bool reg32 = false;
+#endif
+
+#include "matkernel.hpp"
+
+    constexpr OPERATION AddOp(OPERATION OP) { return (OP == ADD || OP == SET) ? ADD : SUB; }
+
+
+    template <int SX>
+    void MultMatVecShort (BareSliceMatrix<> a, FlatVector<> x, FlatVector<> y)
+    {
+      KernelMatVec<SX,SET> (y.Size(), &a(0), a.Dist(), &x(0), &y(0));
+    }
+
+    template <int SX>
+    void MultAddMatVecShort (double s, BareSliceMatrix<> a, FlatVector<> x, FlatVector<> y)
+    {
+      KernelAddMatVec<SX> (s, y.Size(), &a(0), a.Dist(), &x(0), &y(0));
+    }
+
+    template <size_t WA, OPERATION OP>
+    REGCALL void MultMatMat_intern2_ShortSumW (size_t ha, size_t /* wa */, size_t wb,
+                                               BareSliceMatrix<> a, BareSliceMatrix<> b, BareSliceMatrix<> c)
+    {
+      if constexpr (WA <= 7 || reg32)
+        MatKernelShortSum2<WA,OP> (ha, wb, a.Data(), a.Dist(), b.Data(), b.Dist(), c.Data(), c.Dist());
+      else
+        {
+          MatKernelShortSum2<6,OP> (ha, wb, a.Data(), a.Dist(), b.Data(), b.Dist(), c.Data(), c.Dist());
+          MatKernelShortSum2<WA-6,AddOp(OP)> (ha, wb, a.Data()+6, a.Dist(), b.Data()+6*b.Dist(), b.Dist(), c.Data(), c.Dist());
+        }
+    }
+
+    template <size_t WA, OPERATION OP>
+    void REGCALL MultAtBSmallWA (size_t ha, size_t /* wa */, size_t wb, BareSliceMatrix<double> a, BareSliceMatrix<double> b,
+                                 BareSliceMatrix<double> c)
+    {
+      if constexpr (WA <= 4)
+        MatKernelAtB_SmallWA2<WA,OP> (ha, wb, a.Data(), a.Dist(), b.Data(), b.Dist(), c.Data(), c.Dist());
+      else
+        MatKernelAtB_SmallWA<WA,OP> (ha, wb, a.Data(), a.Dist(), b.Data(), b.Dist(), c.Data(), c.Dist());
+    }
+
+    template <int SX, OPERATION OP>
+    void REGCALL MultABtSmallWA (size_t ah, size_t bh, BareSliceMatrix<> a, BareSliceMatrix<> b, BareSliceMatrix<> c)
+    {
+      double * pa = a.Data();
+      double * pc = c.Data();
+      for (size_t i = 0; i < ah; i++, pa += a.Dist(), pc += c.Dist())
+        KernelMatVec<SX,OP> (bh, b.Data(), b.Dist(), pa, pc);
+    }
+
+
+    void SetDispatchTables ()
+    {
+      Iterate<std::size(dispatch_matvec)-1> ([&] (auto i)
+      { dispatch_matvec[i] = &MultMatVecShort<i>; });
+      Iterate<std::size(dispatch_addmatvec)-1> ([&] (auto i)
+      { dispatch_addmatvec[i] = &MultAddMatVecShort<i>; });
+
+      Iterate<std::size(dispatch_multAB)-1> ([&] (auto i)
+      {
+        dispatch_multAB[i] = &MultMatMat_intern2_ShortSumW<i,SET>;
+        dispatch_minusmultAB[i] = &MultMatMat_intern2_ShortSumW<i,SETNEG>;
+        dispatch_addAB[i] = &MultMatMat_intern2_ShortSumW<i,ADD>;
+        dispatch_subAB[i] = &MultMatMat_intern2_ShortSumW<i,SUB>;
+      });
+
+      Iterate<std::size(dispatch_atb<false,true>::ptrs)-1> ([&] (auto i)
+      {
+        dispatch_atb<false,true>::ptrs[i] = &MultAtBSmallWA<i,SET>;
+        dispatch_atb<true,true>::ptrs[i] = &MultAtBSmallWA<i,ADD>;
+        dispatch_atb<false,false>::ptrs[i] = &MultAtBSmallWA<i,SETNEG>;
+        dispatch_atb<true,false>::ptrs[i] = &MultAtBSmallWA<i,SUB>;
+      });
+
+      Iterate<std::size(dispatch_abt)> ([&] (auto i)
+      {
+        dispatch_abt[i] = &MultABtSmallWA<i,SET>;
+        dispatch_addabt[i] = &MultABtSmallWA<i,ADD>;
+      });
+    }
+
+  }
+}
+
+// entry point looked up by ngblas.cpp
+extern "C" NGS_DLL_HEADER void ngbla_set_dispatch_tables ()
+{
+  ngbla::NGBLAS_ISA::SetDispatchTables();
+}
@@ -848,6 +848,7 @@ complex : bool
     py::implicitly_convertible<SliceVector<double>, Vector<double>>();
     
     m.def("__timing__", &ngbla::Timing, py::arg("what"), py::arg("n"), py::arg("m"), py::arg("k"), py::arg("lapack")=false, py::arg("maxits")=size_t(1e10));
+    m.def("__kernel_isa__", &ngbla::GetKernelISA, "instruction set of the small matrix kernels");
     m.def("CheckPerformance",
              [] (size_t n, size_t m, size_t k)
                               {
@@ -259,6 +259,7 @@ set_vars( NGSOLVE_CMAKE_ARGS
   USE_VTUNE
   USE_CCACHE
   USE_NATIVE_ARCH
+  USE_KERNEL_DISPATCH
   NETGEN_DIR
   Netgen_DIR
   INSTALL_DEPENDENCIES 
@@ -128,6 +128,7 @@ namespace ngcomp
     geom_free = flags.GetDefineFlag("geom_free");    
     if (spd) symmetric = true;
     SetCheckUnused (!flags.GetDefineFlagX("check_unused").IsFalse());
+    store_elmats = flags.GetDefineFlag ("store_elmats");
   }
 
 
@@ -184,6 +185,7 @@ namespace ngcomp
     precompute = flags.GetDefineFlag ("precompute");
     checksum = flags.GetDefineFlag ("checksum");
     SetCheckUnused (!flags.GetDefineFlagX("check_unused").IsFalse());    
+    store_elmats = flags.GetDefineFlag ("store_elmats");
   }
 
 
@@ -299,7 +301,9 @@ namespace ngcomp
   */
 
   BilinearForm :: ~BilinearForm ()
-  { ; }
+  {
+    DeletePrecomputedData();
+  }
 
   void BilinearForm :: SetPrint (bool ap)
   { 
@@ -706,10 +710,201 @@ namespace ngcomp
 
 
 
+  void BilinearForm :: PrecomputeElementData (LocalHeap & clh)
+  {
+    static Timer t("BilinearForm::PrecomputeElementData"); RegionTimer reg(t);
+    DeletePrecomputedData();
+    if (MixedSpaces()) return;
+
+    size_t ne = max2(max2(ma->GetNE(VOL), ma->GetNE(BND)),ma->GetNE(BBND));
+    precomputed_data.SetSize (ne*NumIntegrators());
+    precomputed_data = nullptr;
+
+    for (VorB vb : {VOL, BND, BBND})
+      if (VB_parts[vb].Size())
+        IterateElements
+          (*fespace, vb, clh,
+           [&] (FESpace::Element el, LocalHeap & lh)
+           {
+             auto & fel = el.GetFE();
+             auto & trafo = el.GetTrafo();
+             for (auto j : Range(parts))
+               {
+                 auto & bfi = parts[j];
+                 if (bfi->VB() != vb) continue;
+                 if (!bfi->DefinedOn (el.GetIndex())) continue;
+                 if (!bfi->DefinedOnElement (el.Nr())) continue;
+                 
+                 auto & mapped_trafo = trafo.AddDeformation(bfi->GetDeformation().get(), lh);
+                 precomputed_data[el.Nr()*NumIntegrators()+j] =
+                   bfi->PrecomputeData (fel, mapped_trafo, lh);
+               }
+           });
+
+    if (facetwise_skeleton_parts[VOL].Size())
+      {
+        precomputed_facet_data.SetSize (ma->GetNFacets()*NumIntegrators());
+        precomputed_facet_data = nullptr;
+
+        Array<int> inner_part_nrs;
+        for (auto & bfi : facetwise_skeleton_parts[VOL])
+          inner_part_nrs.Append (parts.Pos(bfi));
+        
+        for (auto colfacets : GetSkeletonFacets())
+          ParallelForRange
+            (colfacets.Size(), [&] (IntRange r)
+             {
+               LocalHeap lh = clh.Split();
+               Array<int> vnums1(8, lh), vnums2(8, lh);
+               for (auto i : r)
+                 {
+                   HeapReset hr(lh);
+                   auto & sf = colfacets[i];
+                   if (sf.el2 < 0) continue;
+                   
+                   ElementId ei1(VOL, sf.el1), ei2(VOL, sf.el2);
+                   const FiniteElement & fel1 = fespace->GetFE (ei1, lh);
+                   const FiniteElement & fel2 = fespace->GetFE (ei2, lh);
+                   ElementTransformation & eltrans1 = ma->GetTrafo (ei1, lh);
+                   ElementTransformation & eltrans2 = ma->GetTrafo (ei2, lh);
+                   vnums1 = ma->GetElVertices (ei1);
+                   vnums2 = ma->GetElVertices (ei2);
+                   
+                   for (auto j : Range(facetwise_skeleton_parts[VOL]))
+                     {
+                       auto & bfi = facetwise_skeleton_parts[VOL][j];
+                       if (!bfi->DefinedOn (ma->GetElIndex (ei1))) continue; 
+                       if (!bfi->DefinedOn (ma->GetElIndex (ei2))) continue; 
+                       if (!bfi->DefinedOnElement (sf.facet) ) continue;
+                       
+                       auto & mapped_trafo1 = eltrans1.AddDeformation(bfi->GetDeformation().get(), lh);
+                       auto & mapped_trafo2 = eltrans2.AddDeformation(bfi->GetDeformation().get(), lh);
+                       precomputed_facet_data[sf.facet*NumIntegrators()+inner_part_nrs[j]] =
+                         bfi->PrecomputeFacetData (fel1, sf.facnr1, mapped_trafo1, vnums1,
+                                                   fel2, sf.facnr2, mapped_trafo2, vnums2, lh);
+                     }
+                 }
+             });
+      }
+
+    precomputed_timestamp = ma->GetTimeStamp();
+    GetDeformationVersions (precomputed_deformation_versions);
+    num_precomputations++;
+    precomputed_parameters.SetSize0();
+    for (auto & bfi : parts)
+      bfi->GetPrecomputeDependencies (precomputed_parameters);
+  }
+
+  void BilinearForm :: DeletePrecomputedData ()
+  {
+    for (auto data : { &precomputed_data, &precomputed_facet_data })
+      {
+        for (size_t i = 0; i < data->Size(); i++)
+          if ((*data)[i])
+            parts[i % NumIntegrators()] -> DeletePrecomputedData ((*data)[i]);
+        data->SetSize0();
+      }
+  }
+
+  void BilinearForm :: GetDeformationVersions (Array<size_t> & versions) const
+  {
+    versions.SetSize0();
+    versions.Append (ma->GetDeformationVersion());
+    for (auto & bfi : parts)
+      versions.Append (bfi->GetDeformationVersion());
+  }
+
+  bool BilinearForm :: PrecomputedDataValid () const
+  {
+    if (precomputed_timestamp != ma->GetTimeStamp()) return false;
+
+    // a deformation changed in place is seen after setting it again
+    Array<size_t> versions;
+    GetDeformationVersions (versions);
+    if (versions.Size() != precomputed_deformation_versions.Size()) return false;
+    for (size_t i = 0; i < versions.Size(); i++)
+      if (versions[i] != precomputed_deformation_versions[i]) return false;
+
+    Array<double> parameters;
+    for (auto & bfi : parts)
+      bfi->GetPrecomputeDependencies (parameters);
+    if (parameters.Size() != precomputed_parameters.Size()) return false;
+    for (size_t i = 0; i < parameters.Size(); i++)
+      if (parameters[i] != precomputed_parameters[i]) return false;
+    return true;
+  }
+
+
+  const Table<BilinearForm::SkeletonFacet> & BilinearForm :: GetSkeletonFacets () const
+  {
+    if (skeleton_facets.Size() && skeleton_facets_timestamp == ma->GetTimeStamp()
+        && skeleton_facets_fes_timestamp == fespace->GetUpdateTimeStamp())
+      return skeleton_facets;
+
+    static Timer t("BilinearForm::GetSkeletonFacets"); RegionTimer reg(t);
+    auto & coloring = fespace->FacetColoring();
+    bool distributed = ma->GetCommunicator().Size() > 1;
+    
+    TableCreator<SkeletonFacet> creator(coloring.Size());
+    Array<int> elnums, elnums_per;
+    for ( ; !creator.Done(); creator++)
+      for (auto col : Range(coloring))
+        for (int facet : coloring[col])
+          {
+            ma->GetFacetElements (facet, elnums);
+            if (elnums.Size() == 0) continue; // coarse facets
+
+            SkeletonFacet sf { facet, elnums[0], -1, -1, -1, -1 };
+            sf.facnr1 = ma->GetElFacets(ElementId(VOL, sf.el1)).Pos(facet);
+            int facet2 = facet;
+            
+            if (elnums.Size() < 2)
+              {
+                // handled by the mpi facet exchange
+                if (distributed && ma->GetDistantProcs (NodeId(NT_FACET, facet)).Size() > 0)
+                  continue;
+
+                facet2 = ma->GetPeriodicFacet(facet);
+                if (facet2 > facet)
+                  {
+                    ma->GetFacetElements (facet2, elnums_per);
+                    if (elnums_per.Size() != 1)
+                      throw Exception("DG-Apply failed due to invalid periodicity.");
+                    elnums.Append(elnums_per[0]);
+                  }
+                else if (facet2 < facet)
+                  continue;
+              }
+
+            if (elnums.Size() < 2)
+              {
+                ma->GetFacetSurfaceElements (facet, elnums);
+                if (elnums.Size()) sf.sel = elnums[0];
+              }
+            else
+              {
+                sf.el2 = elnums[1];
+                sf.facnr2 = ma->GetElFacets(ElementId(VOL, sf.el2)).Pos(facet2);
+              }
+            creator.Add (col, sf);
+          }
+
+    skeleton_facets = creator.MoveTable();
+    skeleton_facets_timestamp = ma->GetTimeStamp();
+    skeleton_facets_fes_timestamp = fespace->GetUpdateTimeStamp();
+    num_skeleton_facet_builds++;
+    return skeleton_facets;
+  }
+
+  
   void BilinearForm :: Assemble (LocalHeap & lh)
   {
     if (mats.Size() == ma->GetNLevels())
-      return;
+      {
+        if (nonassemble && precompute && !PrecomputedDataValid())
+          PrecomputeElementData (lh);
+        return;
+      }
 
 
     if (nonassemble)
@@ -726,46 +921,7 @@ namespace ngcomp
         mats.Last() = app;
       
         if (precompute)
-          {
-            Array<DofId> dnums;
-            precomputed_data.SetSize( max2(max2(ma->GetNE(VOL), ma->GetNE(BND)),ma->GetNE(BBND))*NumIntegrators() );
-            precomputed_data = nullptr;
-
-            LocalHeap lh (20000000, "biform - assemble");
-            
-            // int hasbound = 0;
-            // int hasinner = 0;
-            for (VorB vb : {VOL, BND, BBND})
-	      {
-		int ne = ma->GetNE(vb);
-		if(VB_parts[vb].Size())
-		  {
-		    for (int i=0; i < ne; i++)
-		      {
-                        ElementId ei(vb, i);
-			// auto & fel = fespace->GetFE(ei,lh);
-			// auto & eltrans = ma->GetTrafo(ei,lh);
-			fespace->GetDofNrs(ei,dnums);
-                        /*
-			for(int j=0; j<NumIntegrators(); j++)
-			  {
-			    const BilinearFormIntegrator & bfi = *parts[j];
-                        */
-                        /*
-                        for (auto & bfi : VB_parts[vb])
-                          {
-			    // if(bfi.VB()!=vb) continue;
-			    if(!bfi->DefinedOn (ma->GetElIndex(i))) continue;
-                            
-			    precomputed_data[i*NumIntegrators()+j] =
-			      bfi->PrecomputeData(fel,eltrans,lh);
-			  }
-                        */
-                        throw Exception ("precomputed currently not supported");
-		      }
-		  }
-	      }
-	  }
+          PrecomputeElementData (lh);
             
         
         if (timing)
@@ -1019,6 +1175,38 @@ namespace ngcomp
       GalerkinProjection();
   }
 
+
+  void BilinearForm :: ReAssemble (LocalHeap & lh, VorB vb, const BitArray & elements)
+  {
+    // the incremental update needs the old element matrices, and must not
+    // touch contributions which are not stored per element
+    bool incremental = store_elmats && !nonassemble && !diagonal && !geom_free
+      && !MixedSpaces()
+      && mats.Size() == ma->GetNLevels()
+      && specialelements_timestamp <= graph_timestamp
+      && !specialelements.Size()
+      && !facetwise_skeleton_parts[VOL].Size() && !facetwise_skeleton_parts[BND].Size()
+      && !elementwise_skeleton_parts.Size() && !mpi_facet_parts.Size()
+      && !preconditioners.Size()
+      && !(linearform && eliminate_internal && !keep_internal)
+      && elements.Size() == ma->GetNE(vb);
+
+    if (!incremental)
+      {
+        cout << IM(3) << "cannot re-assemble elements incrementally, assemble all" << endl;
+        ReAssemble (lh);
+        return;
+      }
+
+    if (low_order_bilinear_form)
+      low_order_bilinear_form->ReAssemble(lh, vb, elements);
+
+    DoReAssemble (vb, elements, lh);
+
+    if (galerkin)
+      GalerkinProjection();
+  }
+
   shared_ptr<BaseMatrix> BilinearForm :: GetMatrixPtr () const
   {
     if (!mats.Size())
@@ -1387,7 +1575,615 @@ namespace ngcomp
     gcnt += nf;
   }
 
-  
+  
+
+  static mutex printelmat_mutex;
+
+  template <class SCAL>
+  bool S_BilinearForm<SCAL> :: CalcElementMatrixSum (FESpace::Element & el, VorB vb,
+                                                     FlatMatrix<SCAL> sum_elmat, LocalHeap & lh)
+  {
+    const FiniteElement & fel = fespace->GetFE (el, lh);
+    const ElementTransformation & eltrans = ma->GetTrafo (el, lh);
+    FlatArray<int> dnums = el.GetDofs();
+
+    if (fel.GetNDof() != dnums.Size())
+      {
+        *testout << "Info from finite element: " << endl;
+        fel.Print (*testout);
+        (*testout) << "fel::GetNDof() = " << fel.GetNDof() << endl;
+        (*testout) << "dnums.Size() = " << dnums.Size() << endl;
+        (*testout) << "dnums = " << dnums << endl;
+        throw Exception ( string("Inconsistent number of degrees of freedom, vb="+ToString(vb)+" fel::GetNDof() = ") + ToString(fel.GetNDof()) + string(" != dnums.Size() = ") + ToString(dnums.Size()) + string("!") );
+      }
+
+    int elmat_size = dnums.Size()*fespace->GetDimension();
+    bool elem_has_integrator = false;
+
+    {
+    static Timer elmattimer("calc elmats", NoTracing);
+    RegionTimer reg (elmattimer);
+
+    if (printelmat || elmat_ev)
+      {
+        // need every part of the element matrix
+        sum_elmat = 0;
+        for (auto & bfip : VB_parts[vb])
+          {
+            const BilinearFormIntegrator & bfi = *bfip;
+            if (!bfi.DefinedOn (el.GetIndex())) continue;
+            if (!bfi.DefinedOnElement (el.Nr())) continue;
+
+            elem_has_integrator = true;
+
+            HeapReset hr(lh);
+            FlatMatrix<SCAL> elmat(elmat_size, lh);
+
+            try
+              {
+                bfi.CalcElementMatrix (fel, eltrans, elmat, lh);
+
+                if (printelmat)
+                  {
+                    lock_guard<mutex> guard(printelmat_mutex);
+                    testout->precision(8);
+                    *testout << "elnum = " << el << endl;
+                    *testout << "eltype = " << fel.ElementType() << endl;
+                    *testout << "integrator = " << bfi.Name() << endl;
+                    *testout << "dnums = " << endl << dnums << endl;
+                    *testout << "ct = ";
+                    for (auto d : dnums)
+                      if (!IsRegularDof(d)) *testout << "0 ";
+                      else *testout << fespace->GetDofCouplingType (d) << " ";
+                    *testout << endl;
+                    *testout << "element-index = " << eltrans.GetElementIndex() << endl;
+                    *testout << "elmat = " << endl << elmat << endl;
+                  }
+
+                if (elmat_ev)
+                  LapackEigenSystem(elmat, lh);
+              }
+            catch (exception & e)
+              {
+                throw (Exception (string(e.what()) +
+                                  string("in Assemble Element Matrix, bfi = ") +
+                                  bfi.Name() + string("\n")));
+              }
+
+            sum_elmat += elmat;
+          }
+      }
+    else
+      {
+        /*
+        for (auto & bfip : VB_parts[vb])
+          {
+            const BilinearFormIntegrator & bfi = *bfip;
+            if (!bfi.DefinedOn (el.GetIndex())) continue;
+            if (!bfi.DefinedOnElement (el.Nr())) continue;
+
+            elem_has_integrator = true;
+
+            try
+              {
+                bfi.CalcElementMatrixAdd (fel, eltrans, sum_elmat, lh);
+              }
+            catch (exception & e)
+              {
+                throw (Exception (string(e.what()) +
+                                  string("in Assemble Element Matrix, bfi = ") +
+                                  bfi.Name() + string("\n")));
+              }
+          }
+        */
+        bool done = false;
+        while (!done)
+          {
+            done = true;
+            sum_elmat = 0;
+            bool symmetric_so_far = true;
+            for (auto & bfip : VB_parts[vb])
+              {
+                const BilinearFormIntegrator & bfi = *bfip;
+                if (!bfi.DefinedOn (el.GetIndex())) continue;
+                if (!bfi.DefinedOnElement (el.Nr())) continue;
+
+                elem_has_integrator = true;
+
+                try
+                  {
+                    // should we give an optional derformation to the integrators ?
+                    auto & mapped_trafo = eltrans.AddDeformation(bfi.GetDeformation().get(), lh);
+                    bfi.CalcElementMatrixAdd (fel, mapped_trafo, sum_elmat, symmetric_so_far, lh);
+                  }
+                catch (ExceptionNOSIMD & e)
+                  {
+                    done = false;
+                  }
+              }
+          }
+      }
+    }
+
+    if (!elem_has_integrator) return false;
+
+    fespace->TransformMat (el, sum_elmat, TRANSFORM_MAT_LEFT_RIGHT);
+
+    if (elmat_ev)
+      {
+        (*testout) << "sum matrix:" << endl;
+        LapackEigenSystem(sum_elmat, lh);
+      }
+    return true;
+  }
+
+  template <class SCAL>
+  void S_BilinearForm<SCAL> :: SplitElementDofs (FlatArray<int> dnums, COUPLING_TYPE ctype,
+                                                 Array<int> & idofs1, Array<int> & odofs1) const
+  {
+    idofs1.SetSize0(); odofs1.SetSize0();
+    for (auto i : Range(dnums))
+      {
+        auto ct = fespace->GetDofCouplingType(dnums[i]);
+        if (ct & ctype)
+          idofs1.AppendHaveMem(i);
+        else
+          if (ct != UNUSED_DOF)
+            odofs1.AppendHaveMem(i);
+      }
+  }
+
+  template <class SCAL>
+  void S_BilinearForm<SCAL> :: AssembleElement (FESpace::Element & el, VorB vb, FlatArray<bool> useddof,
+                                                bool subtract_stored, LocalHeap & lh,
+                                                FlatMatrix<SCAL> elmat, FlatMatrix<SCAL> inner_inverse)
+  {
+    if (elmat_ev && vb == VOL)
+      *testout << " Assemble Element " << el.Nr() << endl;
+
+    if (store_elmats && subtract_stored)
+      {
+        // remove the previous contribution of this element
+        auto & stored = stored_elmats[vb][el.Nr()];
+        if (stored.elmat.Height())
+          {
+            HeapReset hr(lh);
+            FlatMatrix<SCAL> negmat(stored.elmat.Height(), stored.elmat.Width(), lh);
+            negmat = -stored.elmat;
+            AddElementMatrix (stored.dnums, stored.dnums, negmat, el, false, lh);
+            stored.elmat.SetSize(0,0);
+            stored.dnums.SetSize0();
+          }
+      }
+
+    FlatArray<int> dnums = el.GetDofs();
+    FlatMatrix<SCAL> sum_elmat = elmat;
+    if (!sum_elmat.Height())
+      {
+        int elmat_size = dnums.Size()*fespace->GetDimension();
+        sum_elmat.AssignMemory (elmat_size, elmat_size, lh);
+        if (!CalcElementMatrixSum (el, vb, sum_elmat, lh)) return;
+      }
+
+    /*
+    Array<int> lhdofs(dnums.Size(), lh);
+    fespace->GetElementDofsOfType(el, lhdofs, HIDDEN_DOF);
+    bool has_hidden = lhdofs.Size() > 0;
+    */
+
+    bool has_hidden = false;
+    if (eliminate_hidden || eliminate_internal)
+      {
+        for (auto d : dnums)
+          if (fespace->GetDofCouplingType(d) & HIDDEN_DOF)
+            has_hidden = true;
+      }
+
+    bool elim_only_hidden =
+      (!eliminate_internal) && eliminate_hidden && /* (lhdofs.Size() > 0)*/ has_hidden;
+    if ((vb == VOL || (!VB_parts[VOL].Size() && vb==BND) ) && (elim_only_hidden || eliminate_internal))
+      {
+        // static Timer t("static condensation", NoTracing);
+        // RegionTracer reg(TaskManager::GetThreadId(), t);
+
+        // if (!fespace->CouplingTypeArrayAvailable())
+        // throw Exception ("need coupling types for static condensation");
+        static Timer statcondtimer("static condensation", NoTracing);
+        RegionTimer regstat (statcondtimer);
+        static Timer statcondtimer2("static condensation 2", NoTracing);
+
+        static Timer statcondtimer_mult("static condensation mult", NoTracing);
+        static Timer statcondtimer_inv("static condensation inv", NoTracing);
+
+        // Array<int> idofs1(dnums.Size(), lh);
+        // fespace->GetElementDofsOfType (el, idofs1, elim_only_hidden ? HIDDEN_DOF : CONDENSABLE_DOF);
+
+        Array<int> idofs1(dnums.Size(), lh), odofs1(dnums.Size(), lh);
+        SplitElementDofs (dnums, elim_only_hidden ? HIDDEN_DOF : CONDENSABLE_DOF, idofs1, odofs1);
+
+        if (printelmat)
+          {
+            lock_guard<mutex> guard(printelmat_mutex);
+            *testout << "eliminate internal";
+            if (elim_only_hidden)
+             *testout << " (only hidden)" << endl;
+            *testout << "idofs1 = " << idofs1 << endl;
+          }
+
+        if (idofs1.Size())
+          {
+            HeapReset hr (lh);
+
+            int size = sum_elmat.Height();
+            // int dim = size / dnums.Size();
+            int dim = fespace->GetDimension();
+
+            int sizei = dim * idofs1.Size();
+            int sizeo = dim * odofs1.Size();
+
+            FlatArray<int> idofs (sizei, lh);
+            FlatArray<int> odofs (sizeo, lh);
+
+            for (int j = 0, k = 0; j < idofs1.Size(); j++)
+              for (int jj = 0; jj < dim; jj++)
+                idofs[k++] = dim*idofs1[j]+jj;
+
+            for (int j = 0, k = 0; j < odofs1.Size(); j++)
+              for (int jj = 0; jj < dim; jj++)
+                odofs[k++] = dim*odofs1[j]+jj;
+
+            if (printelmat)
+              {
+                lock_guard<mutex> guard(printelmat_mutex);
+                (*testout) << "idofs = " << endl << idofs << endl;
+                (*testout) << "odofs = " << endl << odofs << endl;
+              }
+
+            FlatMatrix<SCAL>
+              a = sum_elmat.Rows(odofs).Cols(odofs) | lh,
+              b = sum_elmat.Rows(odofs).Cols(idofs) | lh,
+              c = Trans(sum_elmat.Rows(idofs).Cols(odofs)) | lh,
+              d = sum_elmat.Rows(idofs).Cols(idofs) | lh;
+
+
+            /*
+              statcondtimer.AddFlops (double(sizei)*sizei*sizei/3);  // LU fact
+              statcondtimer.AddFlops (double(sizei)*sizei*sizeo);
+              statcondtimer.AddFlops (double(sizei)*sizeo*sizeo);
+            */
+
+            // A := A - B D^{-1} C^T
+            // new Versions, July 07
+            if (elim_only_hidden || !keep_internal)
+              {
+                AInvBt (d, b);    // b <--- b d^-1
+                LapackMultAddABt (b, c, -1, a);
+              }
+            else
+              {
+                /*
+                Array<int> idnums1(dnums.Size(), lh),
+                  ednums1(dnums.Size(), lh),
+                  hdnums1(dnums.Size(), lh);
+                fespace->GetElementDofsOfType(el,idnums1,CONDENSABLE_DOF);
+                fespace->GetElementDofsOfType(el,ednums1,EXTERNAL_DOF);
+                fespace->GetElementDofsOfType(el,hdnums1,HIDDEN_DOF);
+
+                if (! (ednums1 == odofs1) )
+                  cout << "they are different:" << endl
+                       << "ednums1 = " << endl << ednums1 << endl
+                       << "odofs1 = " << endl << odofs1 << endl;
+                if (! (idnums1 == idofs1) )
+                  cout << "they are different:" << endl
+                       << "idnums1 = " << endl << ednums1 << endl
+                       << "idofs1 = " << endl << idofs1 << endl;
+
+                for (auto d : Range(idnums1.Size()))
+                  idnums1[d] = dnums[idnums1[d]];
+                for (auto d : Range(ednums1.Size()))
+                  ednums1[d] = dnums[ednums1[d]];
+                for (auto ldof : hdnums1)
+                  idnums1[ldof] = NO_DOF_NR;
+                */
+
+                Array<DofId> idnums1(idofs1.Size(), lh), ednums1(odofs1.Size(), lh);
+                for (int i : Range(idofs1))
+                  {
+                    DofId d = dnums[idofs1[i]];
+                    if (fespace->GetDofCouplingType(d) == HIDDEN_DOF)
+                      d = NO_DOF_NR_CONDENSE;
+                    idnums1[i] = d;
+                  }
+                for (int i : Range(odofs1))
+                  ednums1[i] = dnums[odofs1[i]];
+
+
+                RegionTimer regstat2 (statcondtimer2);
+
+                Array<int> idnums(dim*idnums1.Size(), lh);
+                Array<int> ednums(dim*ednums1.Size(), lh);
+                idnums.SetSize0();
+                ednums.SetSize0();
+
+                for (DofId idnum1 : idnums1)
+                  if (IsRegularDof(idnum1))
+                    idnums += dim*IntRange(idnum1, idnum1+1);
+                  else
+                    for (size_t k = 0; k < dim; k++)
+                      idnums.AppendHaveMem(idnum1);
+
+                for (DofId ednum1 : ednums1)
+                  ednums += dim * IntRange(ednum1, ednum1+1);
+
+                if (store_inner)
+                {
+                  if (has_hidden)
+                  {
+                    HeapReset hr(lh);
+                    Array<int> ldofs(idnums.Size(), lh); //LOCAL DOFs
+                    Array<int> hdofs(idnums.Size(), lh); //HIDDEN DOFs
+                    ldofs.SetSize0();
+                    hdofs.SetSize0();
+
+                    for (int i : Range(idnums))
+                      if (idnums[i] == NO_DOF_NR_CONDENSE)
+                        hdofs.AppendHaveMem(i);
+                      else
+                        ldofs.AppendHaveMem(i);
+
+                    FlatMatrix<SCAL>
+                      da = d.Rows(ldofs).Cols(ldofs) | lh,
+                      db = d.Rows(ldofs).Cols(hdofs) | lh,
+                      dc = Trans(d.Rows(hdofs).Cols(ldofs)) | lh,
+                      dd = d.Rows(hdofs).Cols(hdofs) | lh;
+
+                    Array<int> cidnums(idnums.Size(), lh); //compressed idofs (no hidden)
+                    cidnums.SetSize0();
+                    for (DofId dof : idnums)
+                      if (IsRegularDof(dof))
+                        cidnums.AppendHaveMem(dof);
+
+                    AInvBt (dd, db);    // b <--- b d^-1
+                    LapackMultAddABt (db, dc, -1, da);
+
+                    innermatrix_ptr->AddElementMatrix(el.Nr(),cidnums,cidnums,da);
+                  }
+                  else
+                    innermatrix_ptr->AddElementMatrix(el.Nr(),idnums,idnums,d);
+                }
+
+                /*
+                  Matrix<SCAL> hd = d;
+                  Vector<SCAL> diag(d.Height());
+                  for (int i = 0; i < d.Height(); i++)
+                  diag(i) = sqrt(fabs(hd(i,i)));
+                  for (int i = 0; i < d.Height(); i++)
+                  {
+                  hd.Row(i) *= 1.0/diag(i);
+                  hd.Col(i) *= 1.0/diag(i);
+                  }
+                  Vector<SCAL> lam(d.Height());
+                  Matrix<SCAL> evecs(d.Height());
+                  CalcEigenSystem (hd, lam, evecs);
+                  cout << "lam = " << lam << endl;
+                */
+
+                {
+                  // RegionTimer reg (statcondtimer_inv);
+                  // RegionTracer rtr(TaskManager::GetThreadId(), statcondtimer_inv);
+
+                  // LapackInverse (d);
+                  if (inner_inverse.Height())
+                    d = inner_inverse;
+                  else
+                    CalcInverse (d);
+                }
+                FlatMatrix<SCAL> he (sizei, sizeo, lh);
+
+                {
+                  RegionTimer reg (statcondtimer_mult);
+                  NgProfiler::AddThreadFlops (statcondtimer_mult, TaskManager::GetThreadId(),
+                                              d.Height()*d.Width()*c.Width());
+
+                  // V1:
+                  // he = 0.0;
+                  // he -= d * Trans(c) | Lapack;
+                  // V2:
+                  // he = -d * Trans(c) | Lapack;
+                  // V3:
+                  // MinusMultABt (d, c, he);
+                  he = -d * Trans(c);
+                }
+
+                harmonicext_ptr->AddElementMatrix(el.Nr(),idnums,ednums,he);
+                if (!symmetric)
+                  {
+                    FlatMatrix<SCAL> het (sizeo, sizei, lh);
+                    // het = -b*d | Lapack;
+                    // MinusMultAB (b, d, het);
+                    het = -b * d;
+                    harmonicexttrans_ptr->AddElementMatrix(el.Nr(),ednums,idnums,het);
+                  }
+
+                innersolve_ptr->AddElementMatrix(el.Nr(),idnums,idnums,d);
+                {
+                  RegionTimer reg (statcondtimer_mult);
+                  NgProfiler::AddThreadFlops (statcondtimer_mult, TaskManager::GetThreadId(),
+                                              b.Height()*b.Width()*he.Width());
+                  // a += b * he | Lapack;
+                  // AddAB (b, he, a);
+                  a += b * he;
+                }
+
+                if (spd)
+                  { // more stable ?
+                    FlatMatrix<SCAL> schur(odofs.Size(), lh);
+                    CalcSchur (sum_elmat, schur, odofs, idofs);
+                    a = schur;
+                  }
+              }
+
+            if (printelmat)
+              {
+                testout->precision(8);
+                (*testout) << "Schur elmat = " << endl << a << endl;
+              }
+
+            if (elmat_ev)
+              {
+                testout->precision(8);
+
+                (*testout) << "EV of Schur complement:" << endl;
+                LapackEigenSystem(a, lh);
+              }
+
+            sum_elmat.Rows(odofs).Cols(odofs) = a;
+            if (linearform && (!keep_internal))
+              {
+                FlatVector<SCAL> elvec (size, lh);
+                linearform -> GetVector().GetIndirect (dnums, elvec);
+                FlatVector<SCAL> hfi(sizei, lh);
+                FlatVector<SCAL> hfo(sizeo, lh);
+
+                hfi = elvec(idofs);
+                hfo = b * hfi;
+                elvec(odofs) -= hfo;
+
+                linearform->GetVector().SetIndirect (dnums, elvec);
+              }
+
+            for (int k = 0; k < idofs1.Size(); k++)
+              dnums[idofs1[k]] = NO_DOF_NR;
+          }
+      }
+    if (printelmat)
+      {
+        lock_guard<mutex> guard(printelmat_mutex);
+        *testout<< "elem " << el << ", elmat = " << endl << sum_elmat << endl;
+      }
+
+    if (store_elmats)
+      {
+        auto & stored = stored_elmats[vb][el.Nr()];
+        stored.dnums.SetSize(dnums.Size());
+        for (auto i : Range(dnums))
+          stored.dnums[i] = dnums[i];
+        stored.elmat.SetSize(sum_elmat.Height(), sum_elmat.Width());
+        stored.elmat = sum_elmat;
+      }
+
+    AddElementMatrix (dnums, dnums, sum_elmat, el, false, lh);
+
+    for (auto pre : preconditioners)
+      pre -> AddElementMatrix (dnums, sum_elmat, el, lh);
+
+    if (check_unused && useddof.Size())
+      {
+        if (printelmat)
+          *testout << "set these as useddof: " << dnums << endl;
+        for (auto d : dnums)
+          if (IsRegularDof(d)) useddof[d] = true;
+      }
+    // timer3_VB[vb].Stop();
+  }
+
+
+  template <class SCAL>
+  void S_BilinearForm<SCAL> :: AssembleElementsBatched (VorB vb, FlatArray<bool> useddof,
+                                                        ProgressOutput & progress, LocalHeap & clh)
+  {
+    static Timer t("Matrix assembling - batched condensation"); RegionTimer reg(t);
+    static Timer tinv("Matrix assembling - batched inverse");
+
+    // the element matrices of a chunk of one color are kept until their
+    // condensable blocks are inverted together, then condensed and added
+    constexpr size_t chunksize = 1024;
+    int dim = fespace->GetDimension();
+
+    for (FlatArray<int> els_of_col : fespace->ElementColoring(vb))
+      for (size_t first = 0; first < els_of_col.Size(); first += chunksize)
+        {
+          auto chunk = els_of_col.Range (first, min2 (first+chunksize, els_of_col.Size()));
+          Array<Matrix<SCAL>> elmats(chunk.Size());
+          Array<Matrix<SCAL>> inner(chunk.Size());
+
+          ParallelForRange (chunk.Size(), [&] (IntRange r)
+            {
+              LocalHeap lh = clh.Split();
+              Array<DofId> temp_dnums;
+              for (auto i : r)
+                {
+                  HeapReset hr(lh);
+                  FESpace::Element el(*fespace, ElementId (vb, chunk[i]), temp_dnums, lh);
+                  FlatArray<int> dnums = el.GetDofs();
+                  elmats[i].SetSize (dim*dnums.Size(), dim*dnums.Size());
+                  if (!CalcElementMatrixSum (el, vb, elmats[i], lh))
+                    {
+                      elmats[i].SetSize (0, 0);
+                      continue;
+                    }
+
+                  Array<int> idofs1(dnums.Size(), lh), odofs1(dnums.Size(), lh);
+                  SplitElementDofs (dnums, CONDENSABLE_DOF, idofs1, odofs1);
+                  FlatArray<int> idofs (dim*idofs1.Size(), lh);
+                  for (int j = 0, k = 0; j < idofs1.Size(); j++)
+                    for (int jj = 0; jj < dim; jj++)
+                      idofs[k++] = dim*idofs1[j]+jj;
+                  inner[i].SetSize (idofs.Size(), idofs.Size());
+                  inner[i] = elmats[i].Rows(idofs).Cols(idofs);
+                }
+            });
+
+          {
+            RegionTimer reg(tinv);
+            if constexpr (is_same<SCAL,double>::value)
+              {
+                Array<FlatMatrix<double>> blocks(inner.Size());
+                for (size_t i = 0; i < inner.Size(); i++)
+                  new (&blocks[i]) FlatMatrix<double> (inner[i].Height(), inner[i].Width(), inner[i].Data());
+                CalcInverseBatched (blocks);
+              }
+            else
+              ParallelFor (inner.Size(), [&] (size_t i) { CalcInverse (inner[i]); });
+          }
+
+          ParallelForRange (chunk.Size(), [&] (IntRange r)
+            {
+              LocalHeap lh = clh.Split();
+              Array<DofId> temp_dnums;
+              for (auto i : r)
+                {
+                  progress.Update ();
+                  if (!elmats[i].Height()) continue;
+                  HeapReset hr(lh);
+                  FESpace::Element el(*fespace, ElementId (vb, chunk[i]), temp_dnums, lh);
+                  AssembleElement (el, vb, useddof, false, lh, elmats[i], inner[i]);
+                }
+              ProgressOutput::SumUpLocal();
+            });
+        }
+  }
+
+
+  template <class SCAL>
+  void S_BilinearForm<SCAL> :: DoReAssemble (VorB vb, const BitArray & elements, LocalHeap & clh)
+  {
+    static Timer t("Matrix re-assembling elements");
+    RegionTimer reg (t);
+
+    if (!VB_parts[vb].Size()) return;
+    if (stored_elmats[vb].Size() != ma->GetNE(vb))
+      throw Exception ("ReAssemble elements: element matrices are not stored, use flag 'store_elmats'");
+
+    timestamp = ++global_timestamp;
+    IterateElements
+      (*fespace, vb, clh,  [&] (FESpace::Element el, LocalHeap & lh)
+       {
+         if (!elements.Test(el.Nr())) return;
+         AssembleElement (el, vb, FlatArray<bool>(), true, lh);
+       });
+  }
+
 
   template <class SCAL>
   void S_BilinearForm<SCAL> :: DoAssemble (LocalHeap & clh)
@@ -1578,466 +2374,22 @@ namespace ngcomp
                           innermatrix = make_shared<ElementByElementMatrix<SCAL>>(ndof, ne);
                       }
                     */
-                    IterateElements
-                      (*fespace, vb, clh,  [&] (FESpace::Element el, LocalHeap & lh)
-                       {
-                         if (elmat_ev && vb == VOL) 
-                           *testout << " Assemble Element " << el.Nr() << endl;  
-                         
-                         progress.Update ();
-			 
-                         const FiniteElement & fel = fespace->GetFE (el, lh);
-                         const ElementTransformation & eltrans = ma->GetTrafo (el, lh);
-                         FlatArray<int> dnums = el.GetDofs();
-                         
-                         if (fel.GetNDof() != dnums.Size())
-                           {
-                             *testout << "Info from finite element: " << endl;
-                             fel.Print (*testout);
-                             (*testout) << "fel::GetNDof() = " << fel.GetNDof() << endl;
-                             (*testout) << "dnums.Size() = " << dnums.Size() << endl;
-                             (*testout) << "dnums = " << dnums << endl;
-                             throw Exception ( string("Inconsistent number of degrees of freedom, vb="+ToString(vb)+" fel::GetNDof() = ") + ToString(fel.GetNDof()) + string(" != dnums.Size() = ") + ToString(dnums.Size()) + string("!") );
-                           }
-                         
-                         int elmat_size = dnums.Size()*fespace->GetDimension();
-                         FlatMatrix<SCAL> sum_elmat(elmat_size, lh);
-			 bool elem_has_integrator = false;
-
+                    if (store_elmats)
+                      {
+                        stored_elmats[vb].SetSize(0);
+                        stored_elmats[vb].SetSize(ne);
+                      }
+                    // condensation with kept inner parts inverts the inner blocks in SIMD batches
+                    if (is_same<SCAL,double>::value && eliminate_internal && keep_internal
+                        && (vb == VOL || (!VB_parts[VOL].Size() && vb == BND)))
+                      AssembleElementsBatched (vb, useddof, progress, clh);
+                    else
+                      IterateElements
+                        (*fespace, vb, clh,  [&] (FESpace::Element el, LocalHeap & lh)
                          {
-                         static Timer elmattimer("calc elmats", NoTracing);
-                         RegionTimer reg (elmattimer);
-                         
-                         if (printelmat || elmat_ev)
-                           {
-                             // need every part of the element matrix
-                             sum_elmat = 0;
-                             for (auto & bfip : VB_parts[vb])
-                               {
-                                 const BilinearFormIntegrator & bfi = *bfip;
-                                 if (!bfi.DefinedOn (el.GetIndex())) continue;                        
-                                 if (!bfi.DefinedOnElement (el.Nr())) continue;                        
-                                 
-                                 elem_has_integrator = true;
-                                 
-                                 HeapReset hr(lh);
-                                 FlatMatrix<SCAL> elmat(elmat_size, lh);
-                                 
-                                 try
-                                   {
-                                     bfi.CalcElementMatrix (fel, eltrans, elmat, lh);
-                                     
-                                     if (printelmat)
-                                       {
-                                         lock_guard<mutex> guard(printelmat_mutex);
-                                         testout->precision(8);
-                                         *testout << "elnum = " << el << endl;
-                                         *testout << "eltype = " << fel.ElementType() << endl;
-                                         *testout << "integrator = " << bfi.Name() << endl;
-                                         *testout << "dnums = " << endl << dnums << endl;
-                                         *testout << "ct = ";
-                                         for (auto d : dnums)
-                                           if (!IsRegularDof(d)) *testout << "0 ";
-                                           else *testout << fespace->GetDofCouplingType (d) << " ";
-                                         *testout << endl;
-                                         *testout << "element-index = " << eltrans.GetElementIndex() << endl;
-                                         *testout << "elmat = " << endl << elmat << endl;
-                                       }
-                                     
-                                     if (elmat_ev)
-                                       LapackEigenSystem(elmat, lh);
-                                   }
-                                 catch (exception & e)
-                                   {
-                                     throw (Exception (string(e.what()) +
-                                                       string("in Assemble Element Matrix, bfi = ") + 
-                                                       bfi.Name() + string("\n")));
-                                   }
-                                 
-                                 sum_elmat += elmat;
-                               }
-                           }
-                         else
-                           {
-                             /*
-                             for (auto & bfip : VB_parts[vb])
-                               {
-                                 const BilinearFormIntegrator & bfi = *bfip;
-                                 if (!bfi.DefinedOn (el.GetIndex())) continue;                        
-                                 if (!bfi.DefinedOnElement (el.Nr())) continue;                        
-                                 
-                                 elem_has_integrator = true;
-                                 
-                                 try
-                                   {
-                                     bfi.CalcElementMatrixAdd (fel, eltrans, sum_elmat, lh);
-                                   }
-                                 catch (exception & e)
-                                   {
-                                     throw (Exception (string(e.what()) +
-                                                       string("in Assemble Element Matrix, bfi = ") + 
-                                                       bfi.Name() + string("\n")));
-                                   }
-                               }
-                             */
-                             bool done = false;
-                             while (!done)
-                               {
-                                 done = true;
-                                 sum_elmat = 0;
-                                 bool symmetric_so_far = true;
-                                 for (auto & bfip : VB_parts[vb])
-                                   {
-                                     const BilinearFormIntegrator & bfi = *bfip;
-                                     if (!bfi.DefinedOn (el.GetIndex())) continue;                        
-                                     if (!bfi.DefinedOnElement (el.Nr())) continue;                        
-
-                                     elem_has_integrator = true;
-                                     
-                                     try
-                                       {
-                                         // should we give an optional derformation to the integrators ? 
-                                         auto & mapped_trafo = eltrans.AddDeformation(bfi.GetDeformation().get(), lh);
-                                         bfi.CalcElementMatrixAdd (fel, mapped_trafo, sum_elmat, symmetric_so_far, lh);
-                                       }
-                                     catch (ExceptionNOSIMD & e)
-                                       {
-                                         done = false;
-                                       }
-                                   }
-                               }
-                           }
-                         } 
-                         
-                         if (!elem_has_integrator) return;
-                         
-                         fespace->TransformMat (el, sum_elmat, TRANSFORM_MAT_LEFT_RIGHT);
-			 
-                         if (elmat_ev)
-                           {
-                             (*testout) << "sum matrix:" << endl;
-                             LapackEigenSystem(sum_elmat, lh);
-                           }
-
-                         /*
-                         Array<int> lhdofs(dnums.Size(), lh);
-                         fespace->GetElementDofsOfType(el, lhdofs, HIDDEN_DOF);
-                         bool has_hidden = lhdofs.Size() > 0;
-                         */
-
-                         bool has_hidden = false;
-                         if (eliminate_hidden || eliminate_internal)
-                           {
-                             for (auto d : dnums)
-                               if (fespace->GetDofCouplingType(d) & HIDDEN_DOF)
-                                 has_hidden = true;
-                           }
-
-                         bool elim_only_hidden =
-                           (!eliminate_internal) && eliminate_hidden && /* (lhdofs.Size() > 0)*/ has_hidden;
-                         if ((vb == VOL || (!VB_parts[VOL].Size() && vb==BND) ) && (elim_only_hidden || eliminate_internal))
-                           {
-                             // static Timer t("static condensation", NoTracing);
-                             // RegionTracer reg(TaskManager::GetThreadId(), t);    
-
-                             // if (!fespace->CouplingTypeArrayAvailable())
-                             // throw Exception ("need coupling types for static condensation");
-                             static Timer statcondtimer("static condensation", NoTracing);
-                             RegionTimer regstat (statcondtimer);
-                             static Timer statcondtimer2("static condensation 2", NoTracing);
-
-                             static Timer statcondtimer_mult("static condensation mult", NoTracing);
-                             static Timer statcondtimer_inv("static condensation inv", NoTracing);
-                             
-                             // Array<int> idofs1(dnums.Size(), lh);
-                             // fespace->GetElementDofsOfType (el, idofs1, elim_only_hidden ? HIDDEN_DOF : CONDENSABLE_DOF);
-                             
-                             Array<int> idofs1(dnums.Size(), lh), odofs1(dnums.Size(), lh);
-                             idofs1.SetSize0(); odofs1.SetSize0();
-                             
-                             auto ctype = elim_only_hidden ? HIDDEN_DOF : CONDENSABLE_DOF;
-                             for (auto i : Range(dnums))
-                               {
-                                 auto ct = fespace->GetDofCouplingType(dnums[i]);
-                                 if (ct & ctype)
-                                   idofs1.AppendHaveMem(i);
-                                 else
-                                   if (ct != UNUSED_DOF)
-                                     odofs1.AppendHaveMem(i);
-                               }
-                             
-                             if (printelmat) 
-                               {
-                                 lock_guard<mutex> guard(printelmat_mutex);
-                                 *testout << "eliminate internal";
-                                 if (elim_only_hidden)
-                                  *testout << " (only hidden)" << endl;
-                                 *testout << "idofs1 = " << idofs1 << endl;
-                               }
-                             
-                             if (idofs1.Size())
-                               {
-                                 HeapReset hr (lh);
-				 
-                                 int size = sum_elmat.Height();
-                                 // int dim = size / dnums.Size();
-                                 int dim = fespace->GetDimension();
-				 
-                                 int sizei = dim * idofs1.Size();
-                                 int sizeo = dim * odofs1.Size();
-				 
-                                 FlatArray<int> idofs (sizei, lh);
-                                 FlatArray<int> odofs (sizeo, lh);
-
-                                 for (int j = 0, k = 0; j < idofs1.Size(); j++)
-                                   for (int jj = 0; jj < dim; jj++)
-                                     idofs[k++] = dim*idofs1[j]+jj;
-                                 
-                                 for (int j = 0, k = 0; j < odofs1.Size(); j++)
-                                   for (int jj = 0; jj < dim; jj++)
-                                     odofs[k++] = dim*odofs1[j]+jj;
-
-                                 if (printelmat)
-                                   {
-                                     lock_guard<mutex> guard(printelmat_mutex);
-                                     (*testout) << "idofs = " << endl << idofs << endl;
-                                     (*testout) << "odofs = " << endl << odofs << endl;
-                                   }
-                                 
-                                 FlatMatrix<SCAL> 
-                                   a = sum_elmat.Rows(odofs).Cols(odofs) | lh,
-                                   b = sum_elmat.Rows(odofs).Cols(idofs) | lh,
-                                   c = Trans(sum_elmat.Rows(idofs).Cols(odofs)) | lh,
-                                   d = sum_elmat.Rows(idofs).Cols(idofs) | lh;
-                                 
-				 
-                                 /*
-                                   statcondtimer.AddFlops (double(sizei)*sizei*sizei/3);  // LU fact
-                                   statcondtimer.AddFlops (double(sizei)*sizei*sizeo);  
-                                   statcondtimer.AddFlops (double(sizei)*sizeo*sizeo);  
-                                 */
-				 
-                                 // A := A - B D^{-1} C^T
-                                 // new Versions, July 07
-                                 if (elim_only_hidden || !keep_internal) 
-                                   {
-                                     AInvBt (d, b);    // b <--- b d^-1
-                                     LapackMultAddABt (b, c, -1, a);                                 
-                                   }
-                                 else
-                                   {
-                                     /*
-                                     Array<int> idnums1(dnums.Size(), lh), 
-                                       ednums1(dnums.Size(), lh),
-                                       hdnums1(dnums.Size(), lh);
-                                     fespace->GetElementDofsOfType(el,idnums1,CONDENSABLE_DOF);
-                                     fespace->GetElementDofsOfType(el,ednums1,EXTERNAL_DOF);
-                                     fespace->GetElementDofsOfType(el,hdnums1,HIDDEN_DOF);
-
-                                     if (! (ednums1 == odofs1) )
-                                       cout << "they are different:" << endl
-                                            << "ednums1 = " << endl << ednums1 << endl
-                                            << "odofs1 = " << endl << odofs1 << endl;
-                                     if (! (idnums1 == idofs1) )
-                                       cout << "they are different:" << endl
-                                            << "idnums1 = " << endl << ednums1 << endl
-                                            << "idofs1 = " << endl << idofs1 << endl;
-                                     
-                                     for (auto d : Range(idnums1.Size()))
-                                       idnums1[d] = dnums[idnums1[d]];
-                                     for (auto d : Range(ednums1.Size()))
-                                       ednums1[d] = dnums[ednums1[d]];
-                                     for (auto ldof : hdnums1)
-                                       idnums1[ldof] = NO_DOF_NR;
-                                     */
-
-                                     Array<DofId> idnums1(idofs1.Size(), lh), ednums1(odofs1.Size(), lh);
-                                     for (int i : Range(idofs1))
-                                       {
-                                         DofId d = dnums[idofs1[i]];
-                                         if (fespace->GetDofCouplingType(d) == HIDDEN_DOF)
-                                           d = NO_DOF_NR_CONDENSE;
-                                         idnums1[i] = d;
-                                       }
-                                     for (int i : Range(odofs1))
-                                       ednums1[i] = dnums[odofs1[i]];
-                                     
-                                     
-                                     RegionTimer regstat2 (statcondtimer2);
-
-                                     Array<int> idnums(dim*idnums1.Size(), lh);
-                                     Array<int> ednums(dim*ednums1.Size(), lh);
-                                     idnums.SetSize0(); 
-                                     ednums.SetSize0();
-
-                                     for (DofId idnum1 : idnums1)
-                                       if (IsRegularDof(idnum1))
-                                         idnums += dim*IntRange(idnum1, idnum1+1);
-                                       else
-                                         for (size_t k = 0; k < dim; k++)
-                                           idnums.AppendHaveMem(idnum1);
-
-                                     for (DofId ednum1 : ednums1)
-                                       ednums += dim * IntRange(ednum1, ednum1+1);
-                                     
-                                     if (store_inner)
-                                     {
-                                       if (has_hidden)
-                                       {
-                                         HeapReset hr(lh);
-                                         Array<int> ldofs(idnums.Size(), lh); //LOCAL DOFs
-                                         Array<int> hdofs(idnums.Size(), lh); //HIDDEN DOFs
-                                         ldofs.SetSize0(); 
-                                         hdofs.SetSize0();
-
-                                         for (int i : Range(idnums))
-                                           if (idnums[i] == NO_DOF_NR_CONDENSE)
-                                             hdofs.AppendHaveMem(i);
-                                           else
-                                             ldofs.AppendHaveMem(i);
-
-                                         FlatMatrix<SCAL> 
-                                           da = d.Rows(ldofs).Cols(ldofs) | lh,
-                                           db = d.Rows(ldofs).Cols(hdofs) | lh,
-                                           dc = Trans(d.Rows(hdofs).Cols(ldofs)) | lh,
-                                           dd = d.Rows(hdofs).Cols(hdofs) | lh;
-
-                                         Array<int> cidnums(idnums.Size(), lh); //compressed idofs (no hidden)
-                                         cidnums.SetSize0();
-                                         for (DofId dof : idnums)
-                                           if (IsRegularDof(dof))
-                                             cidnums.AppendHaveMem(dof);
-
-                                         AInvBt (dd, db);    // b <--- b d^-1
-                                         LapackMultAddABt (db, dc, -1, da);   
-                             
-                                         innermatrix_ptr->AddElementMatrix(el.Nr(),cidnums,cidnums,da);
-                                       }
-                                       else
-                                         innermatrix_ptr->AddElementMatrix(el.Nr(),idnums,idnums,d);
-                                     }
-                                     
-                                     /*
-                                       Matrix<SCAL> hd = d;
-                                       Vector<SCAL> diag(d.Height());
-                                       for (int i = 0; i < d.Height(); i++)
-                                       diag(i) = sqrt(fabs(hd(i,i)));
-                                       for (int i = 0; i < d.Height(); i++)
-                                       {
-                                       hd.Row(i) *= 1.0/diag(i);
-                                       hd.Col(i) *= 1.0/diag(i);
-                                       }
-                                       Vector<SCAL> lam(d.Height());
-                                       Matrix<SCAL> evecs(d.Height());
-                                       CalcEigenSystem (hd, lam, evecs);
-                                       cout << "lam = " << lam << endl;
-                                     */
-
-                                     {
-                                       // RegionTimer reg (statcondtimer_inv);
-                                       // RegionTracer rtr(TaskManager::GetThreadId(), statcondtimer_inv);    
-                              
-                                       // LapackInverse (d);
-                                       CalcInverse (d);
-                                     }
-                                     FlatMatrix<SCAL> he (sizei, sizeo, lh);
-
-                                     {
-                                       RegionTimer reg (statcondtimer_mult);
-                                       NgProfiler::AddThreadFlops (statcondtimer_mult, TaskManager::GetThreadId(),
-                                                                   d.Height()*d.Width()*c.Width());
-                                       
-                                       // V1:
-                                       // he = 0.0;
-                                       // he -= d * Trans(c) | Lapack;
-                                       // V2:
-                                       // he = -d * Trans(c) | Lapack;
-                                       // V3:
-                                       // MinusMultABt (d, c, he);
-                                       he = -d * Trans(c);
-                                     }
-                                     
-                                     harmonicext_ptr->AddElementMatrix(el.Nr(),idnums,ednums,he);
-                                     if (!symmetric)
-                                       {
-                                         FlatMatrix<SCAL> het (sizeo, sizei, lh);
-                                         // het = -b*d | Lapack;
-                                         // MinusMultAB (b, d, het);
-                                         het = -b * d;
-                                         harmonicexttrans_ptr->AddElementMatrix(el.Nr(),ednums,idnums,het);
-                                       }
-                                     
-                                     innersolve_ptr->AddElementMatrix(el.Nr(),idnums,idnums,d);
-                                     {
-                                       RegionTimer reg (statcondtimer_mult);
-                                       NgProfiler::AddThreadFlops (statcondtimer_mult, TaskManager::GetThreadId(),
-                                                                   b.Height()*b.Width()*he.Width());
-                                       // a += b * he | Lapack;
-                                       // AddAB (b, he, a);
-                                       a += b * he;
-                                     }
-                                     
-                                     if (spd)
-                                       { // more stable ? 
-                                         FlatMatrix<SCAL> schur(odofs.Size(), lh);
-                                         CalcSchur (sum_elmat, schur, odofs, idofs);
-                                         a = schur;
-                                       }
-                                   }                             
-                                 
-                                 if (printelmat) 
-                                   {
-                                     testout->precision(8);
-                                     (*testout) << "Schur elmat = " << endl << a << endl;
-                                   }
-                                 
-                                 if (elmat_ev)
-                                   {
-                                     testout->precision(8);
-                                     
-                                     (*testout) << "EV of Schur complement:" << endl;
-                                     LapackEigenSystem(a, lh);
-                                   }
-                                 
-                                 sum_elmat.Rows(odofs).Cols(odofs) = a;
-                                 if (linearform && (!keep_internal))
-                                   {
-                                     FlatVector<SCAL> elvec (size, lh);
-                                     linearform -> GetVector().GetIndirect (dnums, elvec);
-                                     FlatVector<SCAL> hfi(sizei, lh);
-                                     FlatVector<SCAL> hfo(sizeo, lh);
-                                     
-                                     hfi = elvec(idofs);
-                                     hfo = b * hfi;
-                                     elvec(odofs) -= hfo;
-                                     
-                                     linearform->GetVector().SetIndirect (dnums, elvec);
-                                   }
-                                 
-                                 for (int k = 0; k < idofs1.Size(); k++)
-                                   dnums[idofs1[k]] = NO_DOF_NR;
-                               }
-                           }
-                         if (printelmat)
-                           {
-                             lock_guard<mutex> guard(printelmat_mutex);
-                             *testout<< "elem " << el << ", elmat = " << endl << sum_elmat << endl;
-                           }
-                         
-                         AddElementMatrix (dnums, dnums, sum_elmat, el, false, lh);
-			 
-                         for (auto pre : preconditioners)
-                           pre -> AddElementMatrix (dnums, sum_elmat, el, lh);
-
-                         if (check_unused)
-                           {
-                             if (printelmat)
-                               *testout << "set these as useddof: " << dnums << endl;
-                             for (auto d : dnums)
-                               if (IsRegularDof(d)) useddof[d] = true;
-                           }
-                         // timer3_VB[vb].Stop();
-                       });
+                           progress.Update ();
+                           AssembleElement (el, vb, useddof, false, lh);
+                         });
                     progress.Done();
                     
                     /*
@@ -4451,6 +4803,9 @@ namespace ngcomp
     static Timer timerspecial("Apply Matrix - Special Elements");
     RegionTimer reg (timer);
 
+    if (precompute && nonassemble && !PrecomputedDataValid())
+      const_cast<S_BilinearForm<SCAL>*>(this)->PrecomputeElementData(clh);
+
     //     static int lh_size = 5000000;
     shared_ptr<TPHighOrderFESpace> tpfes = dynamic_pointer_cast<TPHighOrderFESpace>(fespace);
     if(tpfes)
@@ -4487,10 +4842,11 @@ namespace ngcomp
                        if (!bfi->DefinedOnElement (el.Nr())) continue;
 
                        auto & mapped_trafo = trafo.AddDeformation(bfi->GetDeformation().get(), lh);
+                       void * precomputed = precompute ? GetPrecomputedData (el, parts.Pos(bfi)) : nullptr;
 
                        {
                          // RegionTimer reg (timer_applyelmat);
-                         bfi->ApplyElementMatrix (fel, mapped_trafo, elvecx, elvecy, 0, lh);
+                         bfi->ApplyElementMatrix (fel, mapped_trafo, elvecx, elvecy, precomputed, lh);
                        }
                        
                        this->fespace->TransformVec (el, elvecy, TRANSFORM_RHS);
@@ -4507,140 +4863,111 @@ namespace ngcomp
           
           if ( (facetwise_skeleton_parts[VOL].Size() > 0) ||
                (facetwise_skeleton_parts[BND].Size() > 0) )
-            
-            for (auto colfacets : fespace->FacetColoring())
-              {
-                SharedLoop2 sl(colfacets.Size());
-
-                ParallelJob
-                  ( [&] (const TaskInfo & ti) 
-                    {
-                      LocalHeap lh = clh.Split(ti.thread_nr, ti.nthreads);
-                      RegionTimer reg(timerDGpar);
-
-                      Array<int> elnums(2, lh), elnums_per(2, lh), fnums1(6, lh), fnums2(6, lh),
-                        vnums1(8, lh), vnums2(8, lh);
-
-                  for (int i : sl)                
-                     {
-                       // timerDG1.Start();
-                       HeapReset hr(lh);
-                       int facet = colfacets[i];
-                       int facet2 = colfacets[i];
-                       ma->GetFacetElements (facet, elnums);
-                       if (elnums.Size() == 0) continue; // coarse facets
-                       int el1 = elnums[0];
-                       ElementId ei1(VOL, el1);
-                       fnums1 = ma->GetElFacets(ei1);
-                       int facnr1 = fnums1.Pos(facet);
-                       
-                       // timerDG1.Stop();
-                       if(elnums.Size() < 2)
-                         {
-                           if (ma->GetCommunicator().Size() > 1)
-                             if (ma->GetDistantProcs (NodeId(NT_FACET, facet)).Size() > 0)
-                               continue;
-
-                           facet2 = ma->GetPeriodicFacet(facet);
-                           if(facet2 > facet)
-                             {
-                               ma->GetFacetElements (facet2, elnums_per);
-                               if (elnums_per.Size() > 1)
-                                 throw Exception("DG-Apply failed due to invalid periodicity.");
-                               elnums.Append(elnums_per[0]);
-                             }
-                           else if(facet2 < facet)
-                             continue;
-                         }
-                       
-                       if (elnums.Size()<2)
-                         {
-                           // RegionTimer reg(timerDGfacet);
-                           
-                           ma->GetFacetSurfaceElements (facet, elnums);
-                           int sel = elnums[0];
-                           ElementId sei(BND, sel);
-                           
-                           const FiniteElement & fel = fespace->GetFE (ei1, lh);
-                           Array<int> dnums(fel.GetNDof(), lh);
-                           vnums1 = ma->GetElVertices (ei1);
-                           vnums2 = ma->GetElVertices (sei);
-                           
-                           ElementTransformation & eltrans = ma->GetTrafo (ei1, lh);
-                           ElementTransformation & seltrans = ma->GetTrafo (sei, lh);
-                           
-                           fespace->GetDofNrs (ei1, dnums);
-                           
-                           for (auto & bfi : facetwise_skeleton_parts[BND])
-                             {
-                               if (!bfi->DefinedOn (seltrans.GetElementIndex())) continue;
-                               if (!bfi->DefinedOnElement (facet)) continue;
-                                         
-                               FlatVector<SCAL> elx(dnums.Size()*this->fespace->GetDimension(), lh),
-                                 ely(dnums.Size()*this->fespace->GetDimension(), lh);
-                               x.GetIndirect(dnums, elx);
-                               
-                               auto & mapped_trafo = eltrans.AddDeformation(bfi->GetDeformation().get(), lh);
-                               auto & mapped_strafo = seltrans.AddDeformation(bfi->GetDeformation().get(), lh);
-                               bfi->ApplyFacetMatrix (fel,facnr1,mapped_trafo,vnums1, mapped_strafo, vnums2, elx, ely, lh);
-                               y.AddIndirect(dnums, ely, fespace->HasAtomicDofs());
-                             } //end for (numintegrators)
-                           
-                           continue;
-                         } // end if boundary facet
-                       
-                       if (facetwise_skeleton_parts[VOL].Size() == 0)
-                         continue;
-                       
-                       // timerDG2.Start();
-                       // timerDG2a.Start();
-                       // int el2 = elnums[1];
-                       // ElementId ei2(VOL, el2);
-                       ElementId ei2(VOL, elnums[1]);
-                       
-                       // fnums2 = ma->GetElFacets(ei2);
-                       // int facnr2 = fnums2.Pos(facet2);
-                       int facnr2 = ma->GetElFacets(ei2).Pos(facet2);
-
-                       ElementTransformation & eltrans1 = ma->GetTrafo (ei1, lh);
-                       ElementTransformation & eltrans2 = ma->GetTrafo (ei2, lh);
-                       
-                       const FiniteElement & fel1 = fespace->GetFE (ei1, lh);
-                       const FiniteElement & fel2 = fespace->GetFE (ei2, lh);
-                       // timerDG2a.Stop();
-                       // timerDG2b.Start();                                 
-                       Array<int> dnums1(fel1.GetNDof(), lh);
-                       Array<int> dnums2(fel2.GetNDof(), lh);
-                       fespace->GetDofNrs (ei1, dnums1);
-                       fespace->GetDofNrs (ei2, dnums2);
-                       vnums1 = ma->GetElVertices (ei1);
-                       vnums2 = ma->GetElVertices (ei2);
-                       
-                       Array<int> dnums(fel1.GetNDof()+fel2.GetNDof(), lh);
-                       dnums.Range(0, dnums1.Size()) = dnums1;
-                       dnums.Range(dnums1.Size(), dnums.Size()) = dnums2;
-                       FlatVector<SCAL> elx(dnums.Size()*fespace->GetDimension(), lh),
-                         ely(dnums.Size()*fespace->GetDimension(), lh);
-                       
-                       x.GetIndirect(dnums, elx);
-
-                       RegionTimer reg2(timerDGapply);                     
-                       for (auto & bfi : facetwise_skeleton_parts[VOL])                                   
-                         {
-                           if (!bfi->DefinedOn (ma->GetElIndex (ei1))) continue; 
-                           if (!bfi->DefinedOn (ma->GetElIndex (ei2))) continue; 
-                           if (!bfi->DefinedOnElement (facet) ) continue;
-                           
-                           auto & mapped_trafo1 = eltrans1.AddDeformation(bfi->GetDeformation().get(), lh);
-                           auto & mapped_trafo2 = eltrans2.AddDeformation(bfi->GetDeformation().get(), lh);
-                           bfi->ApplyFacetMatrix (fel1, facnr1, mapped_trafo1, vnums1,
-                                                  fel2, facnr2, mapped_trafo2, vnums2, elx, ely, lh);
+            {
+              // facets are resolved once per mesh, facets of one color share no dofs
+              Array<int> inner_part_nrs;
+              for (auto & bfi : facetwise_skeleton_parts[VOL])
+                inner_part_nrs.Append (parts.Pos(bfi));
+              
+              for (auto colfacets : GetSkeletonFacets())
+                {
+                  SharedLoop2 sl(colfacets.Size());
 
-                           y.AddIndirect(dnums, ely);
-                         }
-                     }
-                 });
-              }
+                  ParallelJob
+                    ( [&] (const TaskInfo & ti) 
+                      {
+                        LocalHeap lh = clh.Split(ti.thread_nr, ti.nthreads);
+                        RegionTimer reg(timerDGpar);
+                        
+                        Array<int> vnums1(8, lh), vnums2(8, lh);
+                        int dim = fespace->GetDimension();
+                        
+                        for (int i : sl)
+                          {
+                            HeapReset hr(lh);
+                            auto & sf = colfacets[i];
+                            ElementId ei1(VOL, sf.el1);
+                            
+                            if (sf.el2 < 0)
+                              {
+                                if (sf.sel < 0 || facetwise_skeleton_parts[BND].Size() == 0) continue;
+                                ElementId sei(BND, sf.sel);
+                                
+                                const FiniteElement & fel = fespace->GetFE (ei1, lh);
+                                Array<int> dnums(fel.GetNDof(), lh);
+                                fespace->GetDofNrs (ei1, dnums);
+                                vnums1 = ma->GetElVertices (ei1);
+                                vnums2 = ma->GetElVertices (sei);
+                                
+                                ElementTransformation & eltrans = ma->GetTrafo (ei1, lh);
+                                ElementTransformation & seltrans = ma->GetTrafo (sei, lh);
+                                
+                                FlatVector<SCAL> elx(dnums.Size()*dim, lh), ely(dnums.Size()*dim, lh),
+                                  elysum(dnums.Size()*dim, lh);
+                                x.GetIndirect(dnums, elx);
+                                elysum = 0.0;
+                                
+                                for (auto & bfi : facetwise_skeleton_parts[BND])
+                                  {
+                                    if (!bfi->DefinedOn (seltrans.GetElementIndex())) continue;
+                                    if (!bfi->DefinedOnElement (sf.facet)) continue;
+                                    
+                                    auto & mapped_trafo = eltrans.AddDeformation(bfi->GetDeformation().get(), lh);
+                                    auto & mapped_strafo = seltrans.AddDeformation(bfi->GetDeformation().get(), lh);
+                                    bfi->ApplyFacetMatrix (fel, sf.facnr1, mapped_trafo, vnums1, mapped_strafo, vnums2, elx, ely, lh);
+                                    elysum += ely;
+                                  }
+                                y.AddIndirect(dnums, elysum, fespace->HasAtomicDofs());
+                                continue;
+                              } // end if boundary facet
+                            
+                            if (facetwise_skeleton_parts[VOL].Size() == 0)
+                              continue;
+                            
+                            ElementId ei2(VOL, sf.el2);
+                            
+                            ElementTransformation & eltrans1 = ma->GetTrafo (ei1, lh);
+                            ElementTransformation & eltrans2 = ma->GetTrafo (ei2, lh);
+                            
+                            const FiniteElement & fel1 = fespace->GetFE (ei1, lh);
+                            const FiniteElement & fel2 = fespace->GetFE (ei2, lh);
+                            
+                            Array<int> dnums1(fel1.GetNDof(), lh);
+                            Array<int> dnums2(fel2.GetNDof(), lh);
+                            fespace->GetDofNrs (ei1, dnums1);
+                            fespace->GetDofNrs (ei2, dnums2);
+                            Array<int> dnums(dnums1.Size()+dnums2.Size(), lh);
+                            dnums.Range(0, dnums1.Size()) = dnums1;
+                            dnums.Range(dnums1.Size(), dnums.Size()) = dnums2;
+                            vnums1 = ma->GetElVertices (ei1);
+                            vnums2 = ma->GetElVertices (ei2);
+                            
+                            FlatVector<SCAL> elx(dnums.Size()*dim, lh), ely(dnums.Size()*dim, lh),
+                              elysum(dnums.Size()*dim, lh);
+                            x.GetIndirect(dnums, elx);
+                            elysum = 0.0;
+                            
+                            RegionTimer reg2(timerDGapply);
+                            for (auto j : Range(facetwise_skeleton_parts[VOL]))
+                              {
+                                auto & bfi = facetwise_skeleton_parts[VOL][j];
+                                if (!bfi->DefinedOn (ma->GetElIndex (ei1))) continue; 
+                                if (!bfi->DefinedOn (ma->GetElIndex (ei2))) continue; 
+                                if (!bfi->DefinedOnElement (sf.facet) ) continue;
+                                
+                                auto & mapped_trafo1 = eltrans1.AddDeformation(bfi->GetDeformation().get(), lh);
+                                auto & mapped_trafo2 = eltrans2.AddDeformation(bfi->GetDeformation().get(), lh);
+                                void * precomputed = GetPrecomputedFacetData (sf.facet, inner_part_nrs[j]);
+                                bfi->ApplyFacetMatrix (fel1, sf.facnr1, mapped_trafo1, vnums1,
+                                                       fel2, sf.facnr2, mapped_trafo2, vnums2, elx, ely,
+                                                       precomputed, lh);
+                                elysum += ely;
+                              }
+                            y.AddIndirect(dnums, elysum);
+                          }
+                      });
+                }
+            }
           
                     
 
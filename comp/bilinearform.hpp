@@ -50,6 +50,8 @@ namespace ngcomp
     double unuseddiag;
     /// check if all dofs declared used are used in assemble
     bool check_unused = true;
+    /// keep element matrices for re-assembling single elements
+    bool store_elmats = false;
     /// low order bilinear-form, 0 if not used
     shared_ptr<BilinearForm> low_order_bilinear_form;
 
@@ -70,6 +72,20 @@ namespace ngcomp
     // loop over facets, VB=0 .. inner facets, VB=1 .. boundary facets
     Array<shared_ptr<FacetBilinearFormIntegrator>> facetwise_skeleton_parts[2];
 
+    /// a facet of the matrix-free skeleton sweep, neighbours already resolved
+    struct SkeletonFacet
+    {
+      int facet;
+      int el1, facnr1;
+      int el2, facnr2;   // el2 = -1 for boundary facets
+      int sel;           // surface element of a boundary facet
+    };
+    /// skeleton facets in the colors of the facet coloring, rebuilt for a new mesh or space update
+    mutable Table<SkeletonFacet> skeleton_facets;
+    mutable size_t skeleton_facets_timestamp = 0;
+    mutable size_t skeleton_facets_fes_timestamp = 0;
+    mutable size_t num_skeleton_facet_builds = 0;
+
     // geometry-free parts (only for apply)
     Array<shared_ptr<BilinearFormIntegrator>> geom_free_parts;
     
@@ -112,8 +128,16 @@ namespace ngcomp
     
     /// precomputes some data for each element
     bool precompute;
-    /// precomputed element-wise data
+    /// precomputed element-wise data, [elnr*NumIntegrators()+integratornr]
     Array<void*> precomputed_data;
+    /// precomputed data of inner facets, [facetnr*NumIntegrators()+integratornr]
+    Array<void*> precomputed_facet_data;
+    /// mesh, deformation and parameters the precomputed data belongs to
+    size_t precomputed_timestamp = 0;
+    /// versions of the mesh and integrator deformations
+    Array<size_t> precomputed_deformation_versions;
+    Array<double> precomputed_parameters;
+    size_t num_precomputations = 0;
     /// output of norm of matrix entries
     bool checksum;
 
@@ -207,10 +231,37 @@ namespace ngcomp
     /// assembles the matrix
     void Assemble (LocalHeap & lh);
 
+    /// element data for nonassemble forms with the precompute flag
+    void PrecomputeElementData (LocalHeap & lh);
+    void DeletePrecomputedData ();
+    /// is the precomputed data still valid for mesh, deformation and parameters ?
+    bool PrecomputedDataValid () const;
+    /// how often the element data was precomputed, and the skeleton facets were built
+    size_t GetNumPrecomputations () const { return num_precomputations; }
+    size_t GetNumSkeletonFacetBuilds () const { return num_skeleton_facet_builds; }
+    void GetDeformationVersions (Array<size_t> & versions) const;
+    void * GetPrecomputedData (ElementId ei, int integratornr) const
+    {
+      if (precomputed_data.Size() == 0) return nullptr;
+      return precomputed_data[ei.Nr()*NumIntegrators()+integratornr];
+    }
+    void * GetPrecomputedFacetData (int facet, int integratornr) const
+    {
+      if (precomputed_facet_data.Size() == 0) return nullptr;
+      return precomputed_facet_data[facet*NumIntegrators()+integratornr];
+    }
+
+    /// facets for the matrix-free skeleton sweep, grouped by facet colors
+    const Table<SkeletonFacet> & GetSkeletonFacets () const;
+
     /// re-assembles the matrix.
     /// if reallocate is false, the existing matrix is reused
     void ReAssemble (LocalHeap & lh, bool reallocate = 0);
 
+    /// re-assembles the contributions of the marked elements only.
+    /// needs flag store_elmats, falls back to full re-assembly otherwise
+    void ReAssemble (LocalHeap & lh, VorB vb, const BitArray & elements);
+
     /// assembles matrix at linearization point given by lin
     /// needed for Newton's method
     virtual void AssembleLinearization (const BaseVector & lin,
@@ -420,6 +471,9 @@ namespace ngcomp
   protected:
     /// assemble matrix
     virtual void DoAssemble (LocalHeap & lh) = 0;
+    /// replace stored element matrices of marked elements
+    virtual void DoReAssemble (VorB vb, const BitArray & elements, LocalHeap & lh)
+    { throw Exception ("DoReAssemble not implemented for "+GetClassName()); }
     void AssembleGF (LocalHeap & lh);
 
     /// allocates (sparse) matrix data-structure
@@ -455,7 +509,14 @@ namespace ngcomp
     mutable Array<int> os_per;
     mutable Table<SCAL> send_table;
     mutable Table<SCAL> recv_table;
-    
+
+    /// element matrices for incremental re-assembly (flag store_elmats)
+    struct StoredElementMatrix
+    {
+      Array<DofId> dnums;
+      Matrix<SCAL> elmat;
+    };
+    Array<StoredElementMatrix> stored_elmats[3];
         
   public:
     ///
@@ -546,6 +607,21 @@ namespace ngcomp
 
     ///
     virtual void DoAssemble (LocalHeap & lh) override;
+    virtual void DoReAssemble (VorB vb, const BitArray & elements, LocalHeap & lh) override;
+    /// computes and adds the element matrix of one volume/boundary element,
+    /// a given element matrix or inverse of the condensable block is used instead of computing it
+    void AssembleElement (FESpace::Element & el, VorB vb, FlatArray<bool> useddof,
+                          bool subtract_stored, LocalHeap & lh,
+                          FlatMatrix<SCAL> elmat = FlatMatrix<SCAL>(),
+                          FlatMatrix<SCAL> inner_inverse = FlatMatrix<SCAL>());
+    /// sum of the element matrices of all integrators, false if none is defined on the element
+    bool CalcElementMatrixSum (FESpace::Element & el, VorB vb, FlatMatrix<SCAL> sum_elmat, LocalHeap & lh);
+    /// local numbers of the dofs of type ctype, and of the other used dofs
+    void SplitElementDofs (FlatArray<int> dnums, COUPLING_TYPE ctype,
+                           Array<int> & idofs1, Array<int> & odofs1) const;
+    /// AssembleElement for all elements with static condensation and kept inner parts,
+    /// the condensable blocks are inverted in SIMD batches
+    void AssembleElementsBatched (VorB vb, FlatArray<bool> useddof, ProgressOutput & progress, LocalHeap & lh);
     virtual void Assemble_facetwise_skeleton_parts_VOL (Array<bool>& useddof, size_t & gcnt, LocalHeap & lh, const BaseVector * lin = nullptr);
     ///
     // virtual void DoAssembleIndependent (BitArray & useddof, LocalHeap & lh);
@@ -834,6 +834,7 @@ lot of new non-zero entries in the matrix!\n" << endl;
     facet_coloring = Table<int>();
        
     level_updated = ma->GetNLevels();
+    update_timestamp = NGS_Object::GetNextTimeStamp();
     if (timing) Timing();
     updateSignal.Emit();
     // CheckCouplingTypes();
@@ -136,6 +136,8 @@ ANY                  1 1 1 1 | 15
     shared_ptr<Prolongation> prol;// = NULL;
     /// highest multigrid-level for which Update was called (memory allocation)
     int level_updated;
+    /// new for every FinalizeUpdate
+    size_t update_timestamp = 0;
 
     /// on which subdomains is the space defined ?
     Array<bool> definedon[4];
@@ -268,6 +270,8 @@ ANY                  1 1 1 1 | 15
 
     /// highest level where update/finalize was called
     int GetLevelUpdated() const { return level_updated; }
+    /// changes with every update, data derived from the dofs or colorings can compare it
+    size_t GetUpdateTimeStamp() const { return update_timestamp; }
 
     const Table<int> & ElementColoring(VorB vb = VOL) const 
     { return element_coloring[vb]; }
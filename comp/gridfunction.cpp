@@ -7,6 +7,13 @@
 #include <parallelngs.hpp>
 #include <stdlib.h>
 
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace ngcomp; 
 
 
@@ -229,6 +236,263 @@ namespace ngcomp
   }
 
 
+  // checkpoint file: header, component table, payload at a page aligned offset
+  struct CheckpointHeader
+  {
+    char magic[8];
+    uint64_t version;
+    uint64_t payload_offset;
+    uint64_t ndof;
+    uint64_t entrysize;       // doubles per dof
+    uint64_t multidim;
+    uint64_t is_complex;
+    uint64_t order;
+    uint64_t mesh_hash;
+    uint64_t ncomponents;
+    uint64_t rank, ntasks;
+    char spacetype[64];
+  };
+
+  struct CheckpointComponent
+  {
+    uint64_t first, next;
+    uint64_t order;
+    char spacetype[64];
+  };
+
+  static constexpr char checkpoint_magic[8] = { 'N','G','S','G','F','C','P','T' };
+  static constexpr uint64_t checkpoint_alignment = 4096;
+
+  static inline uint64_t HashMix (uint64_t h)
+  {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+  }
+
+  // order-sensitive hash of vertex coordinates and volume element vertices
+  static uint64_t MeshHash (const MeshAccess & ma)
+  {
+    static Timer t("GridFunction::Checkpoint - mesh hash"); RegionTimer reg(t);
+    uint64_t hv =
+      ParallelReduce (ma.GetNV(),
+                      [&] (size_t i)
+                      {
+                        Vec<3> p = ma.GetPoint<3>(i);
+                        uint64_t h = HashMix (i+1);
+                        for (int k = 0; k < 3; k++)
+                          {
+                            uint64_t bits;
+                            memcpy (&bits, &p(k), sizeof(bits));
+                            h = HashMix (h ^ bits);
+                          }
+                        return h;
+                      },
+                      [] (uint64_t a, uint64_t b) { return a+b; },
+                      uint64_t(0));
+    uint64_t he =
+      ParallelReduce (ma.GetNE(VOL),
+                      [&] (size_t i)
+                      {
+                        uint64_t h = HashMix (~uint64_t(i));
+                        for (auto v : ma.GetElVertices (ElementId(VOL, i)))
+                          h = HashMix (h + v);
+                        return h;
+                      },
+                      [] (uint64_t a, uint64_t b) { return a+b; },
+                      uint64_t(0));
+    return HashMix (HashMix (hv ^ ma.GetNV()) + he) ^ ma.GetNE(VOL);
+  }
+
+  static void CopyName (char (&dest)[64], const string & name)
+  {
+    memset (dest, 0, sizeof(dest));
+    strncpy (dest, name.c_str(), sizeof(dest)-1);
+  }
+
+
+  // with more than one MPI task every rank has its own file
+  static string CheckpointFileName (const string & filename, const NgMPI_Comm & comm)
+  {
+    if (comm.Size() > 1)
+      return filename + "." + ToString(comm.Rank());
+    return filename;
+  }
+
+
+  void GridFunction :: SaveCheckpoint (const string & afilename) const
+  {
+    static Timer t("GridFunction::SaveCheckpoint"); RegionTimer reg(t);
+
+    auto compfes = dynamic_pointer_cast<CompoundFESpace>(fespace);
+    auto comm = ma->GetCommunicator();
+    string filename = CheckpointFileName (afilename, comm);
+
+    CheckpointHeader header;
+    memset (&header, 0, sizeof(header));
+    memcpy (header.magic, checkpoint_magic, sizeof(header.magic));
+    header.version = 1;
+    header.ndof = vec[0]->Size();
+    header.entrysize = vec[0]->EntrySize();
+    header.multidim = multidim;
+    header.is_complex = fespace->IsComplex();
+    header.order = fespace->GetOrder();
+    header.mesh_hash = MeshHash (*ma);
+    header.ncomponents = compfes ? compfes->GetNSpaces() : 0;
+    header.rank = comm.Rank();
+    header.ntasks = comm.Size();
+    CopyName (header.spacetype, fespace->GetClassName());
+
+    Array<CheckpointComponent> comps(header.ncomponents);
+    for (size_t i = 0; i < comps.Size(); i++)
+      {
+        memset (&comps[i], 0, sizeof(comps[i]));
+        auto range = compfes->GetRange(i);
+        comps[i].first = range.First();
+        comps[i].next = range.Next();
+        comps[i].order = (*compfes)[i]->GetOrder();
+        CopyName (comps[i].spacetype, (*compfes)[i]->GetClassName());
+      }
+
+    size_t headerbytes = sizeof(header) + comps.Size()*sizeof(CheckpointComponent);
+    header.payload_offset = (headerbytes + checkpoint_alignment-1) / checkpoint_alignment * checkpoint_alignment;
+    size_t vecbytes = header.ndof * header.entrysize * sizeof(double);
+
+    // all vectors of a GridFunction allocated by Update are one block each,
+    // the header block and every vector go with a single write
+    Array<char> head(header.payload_offset);
+    head = 0;
+    memcpy (head.Data(), &header, sizeof(header));
+    if (comps.Size())
+      memcpy (head.Data()+sizeof(header), comps.Data(), comps.Size()*sizeof(CheckpointComponent));
+
+    ofstream out(filename, ios::binary);
+    if (!out)
+      throw Exception ("SaveCheckpoint: cannot open file " + filename);
+    out.write (head.Data(), head.Size());
+    for (int i = 0; i < multidim; i++)
+      out.write ((const char*)vec[i]->Memory(), vecbytes);
+    if (!out)
+      throw Exception ("SaveCheckpoint: writing " + filename + " failed");
+  }
+
+
+  // vector living in a file mapping, keeps the mapping alive
+  template <typename TSCAL>
+  class MappedBaseVector : public S_BaseVectorPtr<TSCAL>
+  {
+    shared_ptr<void> mapping;
+  public:
+    MappedBaseVector (size_t as, int aes, void * adata, shared_ptr<void> amapping)
+      : S_BaseVectorPtr<TSCAL> (as, aes, adata), mapping(amapping) { ; }
+  };
+
+
+  void GridFunction :: LoadCheckpoint (const string & afilename, bool map)
+  {
+    static Timer t("GridFunction::LoadCheckpoint"); RegionTimer reg(t);
+
+    auto comm = ma->GetCommunicator();
+    string filename = CheckpointFileName (afilename, comm);
+    ifstream in(filename, ios::binary);
+    if (!in)
+      throw Exception ("File " + filename + " does not exist!");
+
+    CheckpointHeader header;
+    in.read ((char*)&header, sizeof(header));
+    if (!in || memcmp (header.magic, checkpoint_magic, sizeof(header.magic)) != 0)
+      throw Exception ("LoadCheckpoint: " + filename + " is not a GridFunction checkpoint");
+    if (header.version != 1)
+      throw Exception ("LoadCheckpoint: unknown checkpoint version " + ToString(header.version));
+
+    auto compfes = dynamic_pointer_cast<CompoundFESpace>(fespace);
+    auto mismatch = [&] (const string & what, auto file, auto mine)
+      {
+        if (file != mine)
+          throw Exception ("LoadCheckpoint: " + what + " does not match, file has "
+                           + ToString(file) + ", GridFunction has " + ToString(mine));
+      };
+
+    if (!IsUpdated())
+      Update();
+    mismatch ("space type", string(header.spacetype), fespace->GetClassName());
+    mismatch ("order", header.order, uint64_t(fespace->GetOrder()));
+    mismatch ("ndof", header.ndof, uint64_t(vec[0]->Size()));
+    mismatch ("entrysize", header.entrysize, uint64_t(vec[0]->EntrySize()));
+    mismatch ("complex", header.is_complex, uint64_t(fespace->IsComplex()));
+    mismatch ("multidim", header.multidim, uint64_t(multidim));
+    mismatch ("number of components", header.ncomponents,
+              uint64_t(compfes ? compfes->GetNSpaces() : 0));
+    mismatch ("number of tasks", header.ntasks, uint64_t(comm.Size()));
+    mismatch ("rank", header.rank, uint64_t(comm.Rank()));
+
+    Array<CheckpointComponent> comps(header.ncomponents);
+    in.read ((char*)comps.Data(), comps.Size()*sizeof(CheckpointComponent));
+    for (size_t i = 0; i < comps.Size(); i++)
+      {
+        auto range = compfes->GetRange(i);
+        string comp = "component " + ToString(i) + " ";
+        mismatch (comp+"space type", string(comps[i].spacetype), (*compfes)[i]->GetClassName());
+        mismatch (comp+"order", comps[i].order, uint64_t((*compfes)[i]->GetOrder()));
+        mismatch (comp+"first dof", comps[i].first, uint64_t(range.First()));
+        mismatch (comp+"next dof", comps[i].next, uint64_t(range.Next()));
+      }
+    if (header.mesh_hash != MeshHash (*ma))
+      throw Exception ("LoadCheckpoint: " + filename + " was written for a different mesh");
+
+    size_t vecbytes = header.ndof * header.entrysize * sizeof(double);
+
+#ifndef WIN32
+    // parallel vectors and component views must keep their vector objects
+    if (map && !fespace->IsParallel() && !dynamic_cast<ComponentGridFunction*>(this))
+      {
+        in.close();
+        int fd = open (filename.c_str(), O_RDONLY);
+        if (fd < 0)
+          throw Exception ("LoadCheckpoint: cannot open " + filename);
+        size_t filesize = header.payload_offset + multidim * vecbytes;
+        struct stat st;
+        if (fstat (fd, &st) != 0 || size_t(st.st_size) < filesize)
+          {
+            close (fd);
+            throw Exception ("LoadCheckpoint: " + filename + " is truncated");
+          }
+        // private mapping: modifications do not go back to the file
+        void * base = mmap (nullptr, filesize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close (fd);
+        if (base == MAP_FAILED)
+          throw Exception ("LoadCheckpoint: mmap of " + filename + " failed");
+        shared_ptr<void> mapping(base, [filesize] (void * p) { munmap (p, filesize); });
+
+        char * payload = (char*)base + header.payload_offset;
+        int es = vec[0]->EntrySizeScal();
+        for (int i = 0; i < multidim; i++)
+          {
+            void * data = payload + i*vecbytes;
+            if (header.is_complex)
+              vec[i] = make_shared<MappedBaseVector<Complex>> (header.ndof, es, data, mapping);
+            else
+              vec[i] = make_shared<MappedBaseVector<double>> (header.ndof, es, data, mapping);
+          }
+
+        for (auto comp : compgfs)
+          if (!comp.expired())
+            comp.lock()->Update();
+        return;
+      }
+#endif
+
+    in.seekg (header.payload_offset);
+    for (int i = 0; i < multidim; i++)
+      in.read ((char*)vec[i]->Memory(), vecbytes);
+    if (!in)
+      throw Exception ("LoadCheckpoint: " + filename + " is truncated");
+  }
+
+
   void GridFunction :: Interpolate (const CoefficientFunction & cf,
                                     const Region * reg, int mdcomp, LocalHeap & clh)
   {
@@ -284,6 +284,13 @@ namespace ngcomp
     // multidim component, if -1 then all components are loaded/saved
     virtual void Load (istream & ist, int mdcomp = -1) = 0;
     virtual void Save (ostream & ost, int mdcomp = -1) const = 0;
+
+    /// header plus one contiguous payload holding all multidim vectors,
+    /// in parallel one file per rank named filename.rank
+    void SaveCheckpoint (const string & filename) const;
+    /// with map = true the file is mapped copy-on-write instead of read,
+    /// the vectors are then replaced by new vector objects
+    void LoadCheckpoint (const string & filename, bool map = false);
     using NGS_Object::shared_from_this;
   };
 
@@ -59,8 +59,6 @@ namespace ngcomp
     static Timer timer1("Vector assembling 1", NoTracing);
     static Timer timer2("Vector assembling 2", NoTracing);
     static Timer timer3("Vector assembling 3", NoTracing);
-    static mutex linformsurfneighprint_mutex;
-    static mutex addelvec3_mutex;
     RegionTimer reg (timer);
 
     assembled = true;
@@ -298,78 +296,84 @@ namespace ngcomp
 	}
 	if(hasskeletonparts[BND])
 	{
+          static Timer tfacet("Vector assembling - facet surface elements");
+          RegionTimer regf(tfacet);
           int nse = ma->GetNE(BND);
-	  ParallelForRange( IntRange(nse), [&] ( IntRange r )
-	  {
-	    LocalHeap lh = clh.Split();
-	    Array<int> dnums;
-	    Array<int> fnums, elnums, vnums;
-	    // loop for facet integrators: 
-            for (int i : r)
-		{
-		  {
-                    lock_guard<mutex> guard(linformsurfneighprint_mutex);
-		    gcnt++;
-		    if (i % 10 == 0)
-		      cout << IM(3) << "\rassemble facet surface element " << i << "/" << nse << flush;
-		    ma->SetThreadPercentage ( 100.0*(gcnt) / (loopsteps) );
-		  }
 
-		  HeapReset hr(lh);
+          // surface elements write into the dofs of their volume neighbour,
+          // facets of one color of the facet coloring have disjoint dofs
+          TableCreator<int> creator(ma->GetNFacets());
+          for ( ; !creator.Done(); creator++)
+            ParallelFor (nse, [&] (size_t i)
+                         {
+                           creator.Add (ma->GetElFacets(ElementId(BND,i))[0], i);
+                         });
+          Table<int> facet2sel = creator.MoveTable();
+
+          for (FlatArray<int> facets_of_col : fespace->FacetColoring())
+            {
+	      ParallelForRange( IntRange(facets_of_col.Size()), [&] ( IntRange r )
+	      {
+	        LocalHeap lh = clh.Split();
+	        Array<int> dnums;
+	        Array<int> fnums, elnums, vnums;
+	        // loop for facet integrators: 
+                for (int fi : r)
+                  for (int i : facet2sel[facets_of_col[fi]])
+		    {
+		      HeapReset hr(lh);
 		  
-                  ElementId sei(BND, i);
+                      ElementId sei(BND, i);
 		  
-		  fnums = ma->GetElFacets(sei);
-		  int fac = fnums[0];
-		  ma->GetFacetElements(fac,elnums);
-		  int el = elnums[0];
-                  ElementId ei(VOL, el);
-		  fnums = ma->GetElFacets(ei);
-		  int facnr = 0;
-		  for (int k=0; k<fnums.Size(); k++)
-		    if(fac==fnums[k]) facnr = k;
-
-		  const FiniteElement & fel = fespace->GetFE (ei, lh);
+		      fnums = ma->GetElFacets(sei);
+		      int fac = fnums[0];
+		      ma->GetFacetElements(fac,elnums);
+		      int el = elnums[0];
+                      ElementId ei(VOL, el);
+		      fnums = ma->GetElFacets(ei);
+		      int facnr = 0;
+		      for (int k=0; k<fnums.Size(); k++)
+		        if(fac==fnums[k]) facnr = k;
+
+		      const FiniteElement & fel = fespace->GetFE (ei, lh);
 		
-		  ElementTransformation & eltrans = ma->GetTrafo (ei, lh);
-		  ElementTransformation & seltrans = ma->GetTrafo (sei, lh);
+		      ElementTransformation & eltrans = ma->GetTrafo (ei, lh);
+		      ElementTransformation & seltrans = ma->GetTrafo (sei, lh);
 
-		  fespace->GetDofNrs (ei, dnums);
-		  vnums = ma->GetElVertices (ei);		
+		      fespace->GetDofNrs (ei, dnums);
+		      vnums = ma->GetElVertices (ei);		
 	      
-		  for (int j = 0; j < parts.Size(); j++)
-		    {
-		      if (!parts[j] -> SkeletonForm()) continue;
-		      if (parts[j] -> VB()!=BND) continue;
-		      if (!parts[j] -> DefinedOn (ma->GetElIndex (sei))) continue;
-		      if (!parts[j] -> DefinedOnElement (i)) continue;
-		      if (parts[j] -> IntegrationAlongCurve()) continue;		    
+		      for (int j = 0; j < parts.Size(); j++)
+		        {
+		          if (!parts[j] -> SkeletonForm()) continue;
+		          if (parts[j] -> VB()!=BND) continue;
+		          if (!parts[j] -> DefinedOn (ma->GetElIndex (sei))) continue;
+		          if (!parts[j] -> DefinedOnElement (i)) continue;
+		          if (parts[j] -> IntegrationAlongCurve()) continue;		    
 		  
-		      int elvec_size = dnums.Size()*fespace->GetDimension();
-		      FlatVector<TSCAL> elvec(elvec_size, lh);
-		      dynamic_cast<const FacetLinearFormIntegrator*>(parts[j].get()) 
-			  -> CalcFacetVector (fel,facnr,eltrans,vnums,seltrans, elvec, lh);
-		      if (printelvec)
-			{
-			  testout->precision(8);
-
-			  (*testout) << "surface-elnum= " << i << endl;
-			  (*testout) << "integrator " << parts[j]->Name() << endl;
-			  (*testout) << "dnums = " << endl << dnums << endl;
-			  (*testout) << "(vol)element-index = " << eltrans.GetElementIndex() << endl;
-			  (*testout) << "elvec = " << endl << elvec << endl;
-			}
-
-		      fespace->TransformVec (ei, elvec, TRANSFORM_RHS);
-		    
-		      {
-                        lock_guard<mutex> guard(addelvec3_mutex);
-			AddElementVector (dnums, elvec, parts[j]->CacheComp()-1);
-		      }
+		          int elvec_size = dnums.Size()*fespace->GetDimension();
+		          FlatVector<TSCAL> elvec(elvec_size, lh);
+		          dynamic_cast<const FacetLinearFormIntegrator*>(parts[j].get()) 
+			      -> CalcFacetVector (fel,facnr,eltrans,vnums,seltrans, elvec, lh);
+		          if (printelvec)
+			    {
+			      testout->precision(8);
+
+			      (*testout) << "surface-elnum= " << i << endl;
+			      (*testout) << "integrator " << parts[j]->Name() << endl;
+			      (*testout) << "dnums = " << endl << dnums << endl;
+			      (*testout) << "(vol)element-index = " << eltrans.GetElementIndex() << endl;
+			      (*testout) << "elvec = " << endl << elvec << endl;
+			    }
+
+		          fespace->TransformVec (ei, elvec, TRANSFORM_RHS);
+			  AddElementVector (dnums, elvec, parts[j]->CacheComp()-1);
+		        }
 		    }
-		}
-		
-	  });//end of parallel
+	      });//end of parallel
+            }
+          gcnt += nse;
+          ma->SetThreadPercentage ( 100.0*(gcnt) / (loopsteps) );
 	  cout << IM(3) << "\rassemble facet surface element  " << nse << "/" << nse << endl;	  
 	}//endof hasskeletonbound
 
@@ -1570,6 +1570,7 @@ namespace ngcomp
             throw Exception ("Mesh::SetDeformation needs a GridFunction with dim="+ToString(dim));
         }
       deformation = def;
+      deformation_version++;
     }
   
     void MeshAccess :: SetPML (const shared_ptr<PML_Transformation> & pml_trafo, int _domnr)
@@ -238,6 +238,8 @@ namespace ngcomp
     
     /// for ALE
     shared_ptr<GridFunction> deformation;  
+    /// counts SetDeformation calls
+    size_t deformation_version = 0;
 
     /// pml trafos per sub-domain
     Array<shared_ptr <PML_Transformation>> pml_trafos;
@@ -691,6 +693,8 @@ namespace ngcomp
     {
       return deformation;
     }
+    /// changes with every SetDeformation, also when the same GridFunction is set again
+    size_t GetDeformationVersion () const { return deformation_version; }
 
     void SetPML (const shared_ptr<PML_Transformation> & pml_trafo, int _domnr);
     void UnSetPML (int _domnr);
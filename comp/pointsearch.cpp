@@ -0,0 +1,409 @@
+/*********************************************************************/
+/* File:   pointsearch.cpp                                           */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+#include <comp.hpp>
+
+namespace ngcomp
+{
+
+  // elements per leaf
+  static constexpr int leafsize = 8;
+
+  // spread the lower 21 bits such that two zero bits are between them
+  static inline uint64_t SpreadBits (uint64_t x)
+  {
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffffull;
+    x = (x | x << 16) & 0x1f0000ff0000ffull;
+    x = (x | x << 8) & 0x100f00f00f00f00full;
+    x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+    x = (x | x << 2) & 0x1249249249249249ull;
+    return x;
+  }
+
+  static inline bool InBox (const Vec<3> & pmin, const Vec<3> & pmax,
+                            FlatVector<> p, int dim)
+  {
+    for (int d = 0; d < dim; d++)
+      if (p(d) < pmin(d) || p(d) > pmax(d))
+        return false;
+    return true;
+  }
+
+  static bool InReferenceElement (ELEMENT_TYPE et, double x, double y, double z)
+  {
+    constexpr double eps = 1e-8;
+    switch (et)
+      {
+      case ET_SEGM:
+        return x > -eps && x < 1+eps;
+      case ET_TRIG:
+        return x > -eps && y > -eps && x+y < 1+eps;
+      case ET_QUAD:
+        return x > -eps && x < 1+eps && y > -eps && y < 1+eps;
+      case ET_TET:
+        return x > -eps && y > -eps && z > -eps && x+y+z < 1+eps;
+      case ET_PRISM:
+        return x > -eps && y > -eps && x+y < 1+eps && z > -eps && z < 1+eps;
+      case ET_PYRAMID:
+        return z > -eps && z < 1+eps && x > -eps && y > -eps
+          && x < 1-z+eps && y < 1-z+eps;
+      case ET_HEX:
+        return x > -eps && x < 1+eps && y > -eps && y < 1+eps && z > -eps && z < 1+eps;
+      default:
+        return false;
+      }
+  }
+
+  // Newton iteration for the inverse of the element mapping
+  template <int D>
+  static bool MapToReference (const ElementTransformation & trafo,
+                              FlatVector<> p, IntegrationPoint & ip)
+  {
+    ELEMENT_TYPE et = trafo.GetElementType();
+    const POINT3D * verts = ElementTopology::GetVertices(et);
+    int nv = ElementTopology::GetNVertices(et);
+
+    IntegrationPoint xi(0, 0, 0, 0);
+    for (int v = 0; v < nv; v++)
+      for (int d = 0; d < D; d++)
+        xi(d) += verts[v][d] / nv;
+
+    Vec<D> x;
+    Mat<D,D> jac;
+    bool converged = false;
+    for (int it = 0; it < 20; it++)
+      {
+        trafo.CalcPointJacobian (xi, x, jac);
+        Vec<D> res;
+        for (int d = 0; d < D; d++)
+          res(d) = p(d) - x(d);
+        Vec<D> dxi = Inv(jac) * res;
+        double norm = 0;
+        for (int d = 0; d < D; d++)
+          {
+            xi(d) += dxi(d);
+            norm += sqr(xi(d));
+          }
+        if (L2Norm(dxi) < 1e-12)
+          {
+            converged = true;
+            break;
+          }
+        if (norm > 100) return false;    // far outside
+      }
+    if (!converged || !InReferenceElement (et, xi(0), xi(1), xi(2)))
+      return false;
+    ip = xi;
+    return true;
+  }
+
+
+  ElementSearchTree :: ElementSearchTree (shared_ptr<MeshAccess> ama)
+    : ma(ama), dim(ama->GetDimension())
+  {
+    Build();
+  }
+
+  void ElementSearchTree :: Update ()
+  {
+    if (ma->GetTimeStamp() != timestamp || ma->GetNE(VOL) != elmin.Size())
+      Build();
+    else
+      Refit();
+  }
+
+  void ElementSearchTree :: Build ()
+  {
+    static Timer t("ElementSearchTree::Build");
+    RegionTimer reg(t);
+
+    timestamp = ma->GetTimeStamp();
+    size_t ne = ma->GetNE(VOL);
+    elmin.SetSize(ne);
+    elmax.SetSize(ne);
+    elnrs.SetSize(ne);
+    nodes.SetSize(0);
+    if (ne == 0) return;
+
+    ComputeElementBoxes();
+
+    Vec<3> gmin = elmin[0], gmax = elmax[0];
+    for (size_t i = 1; i < ne; i++)
+      for (int d = 0; d < 3; d++)
+        {
+          gmin(d) = min2(gmin(d), elmin[i](d));
+          gmax(d) = max2(gmax(d), elmax[i](d));
+        }
+
+    Array<uint64_t> codes(ne);
+    ParallelFor (ne, [&] (size_t i)
+                 {
+                   uint64_t code = 0;
+                   for (int d = 0; d < 3; d++)
+                     {
+                       double len = gmax(d)-gmin(d);
+                       double c = 0.5 * (elmin[i](d)+elmax[i](d));
+                       uint64_t ic = (len > 0) ? uint64_t((c-gmin(d)) / len * 2097151.0) : 0;
+                       code |= SpreadBits(ic) << d;
+                     }
+                   codes[i] = code;
+                   elnrs[i] = i;
+                 });
+    SampleSortI (codes, elnrs);
+
+    // breadth first, children are always behind their parent
+    nodes.Append (Node { Vec<3>(0.0), Vec<3>(0.0), 0, int(ne), -1 });
+    for (size_t i = 0; i < nodes.Size(); i++)
+      {
+        int first = nodes[i].first, next = nodes[i].next;
+        if (next-first <= leafsize) continue;
+        int mid = (first+next)/2;
+        nodes[i].child = nodes.Size();
+        nodes.Append (Node { Vec<3>(0.0), Vec<3>(0.0), first, mid, -1 });
+        nodes.Append (Node { Vec<3>(0.0), Vec<3>(0.0), mid, next, -1 });
+      }
+
+    FitNodes();
+  }
+
+  void ElementSearchTree :: Refit ()
+  {
+    static Timer t("ElementSearchTree::Refit");
+    RegionTimer reg(t);
+
+    ComputeElementBoxes();
+    FitNodes();
+  }
+
+  void ElementSearchTree :: ComputeElementBoxes ()
+  {
+    ParallelForRange (elmin.Size(), [&] (IntRange r)
+      {
+        LocalHeapMem<100000> lh("ElementSearchTree::ComputeElementBoxes");
+        Vec<3> p(0.0);
+        FlatVector<> fp(dim, &p(0));
+        for (auto i : r)
+          {
+            HeapReset hr(lh);
+            auto & trafo = ma->GetTrafo (ElementId(VOL, i), lh);
+            ELEMENT_TYPE et = trafo.GetElementType();
+            Vec<3> pmin(1e99), pmax(-1e99);
+            auto add = [&] (const IntegrationPoint & ip)
+              {
+                trafo.CalcPoint (ip, fp);
+                for (int d = 0; d < dim; d++)
+                  {
+                    pmin(d) = min2(pmin(d), p(d));
+                    pmax(d) = max2(pmax(d), p(d));
+                  }
+              };
+
+            const POINT3D * verts = ElementTopology::GetVertices(et);
+            for (int v = 0; v < ElementTopology::GetNVertices(et); v++)
+              add (IntegrationPoint (verts[v][0], verts[v][1], verts[v][2], 0));
+
+            // curved elements may bulge out of the sampled box
+            bool curved = trafo.IsCurvedElement();
+            if (curved)
+              for (auto & ip : SelectIntegrationRule (et, 4))
+                add (ip);
+
+            double diam = 0;
+            for (int d = 0; d < dim; d++)
+              diam = max2(diam, pmax(d)-pmin(d));
+            double safety = curved ? 0.1*diam : 1e-8*diam;
+            for (int d = 0; d < 3; d++)
+              {
+                if (d < dim)
+                  {
+                    pmin(d) -= safety;
+                    pmax(d) += safety;
+                  }
+                else
+                  pmin(d) = pmax(d) = 0;
+              }
+            elmin[i] = pmin;
+            elmax[i] = pmax;
+          }
+      });
+  }
+
+  // leaves from their elements, inner nodes bottom up
+  void ElementSearchTree :: FitNodes ()
+  {
+    ParallelFor (nodes.Size(), [&] (size_t i)
+                 {
+                   Node & node = nodes[i];
+                   if (node.child >= 0) return;
+                   node.pmin = elmin[elnrs[node.first]];
+                   node.pmax = elmax[elnrs[node.first]];
+                   for (int j = node.first+1; j < node.next; j++)
+                     for (int d = 0; d < 3; d++)
+                       {
+                         node.pmin(d) = min2(node.pmin(d), elmin[elnrs[j]](d));
+                         node.pmax(d) = max2(node.pmax(d), elmax[elnrs[j]](d));
+                       }
+                 });
+
+    for (size_t i = nodes.Size(); i-- > 0; )
+      {
+        Node & node = nodes[i];
+        if (node.child < 0) continue;
+        const Node & c0 = nodes[node.child];
+        const Node & c1 = nodes[node.child+1];
+        for (int d = 0; d < 3; d++)
+          {
+            node.pmin(d) = min2(c0.pmin(d), c1.pmin(d));
+            node.pmax(d) = max2(c0.pmax(d), c1.pmax(d));
+          }
+      }
+  }
+
+  int ElementSearchTree :: Find (FlatVector<> p, IntegrationPoint & ip, LocalHeap & lh) const
+  {
+    if (nodes.Size() == 0) return -1;
+
+    ArrayMem<int, 64> stack;
+    stack.Append(0);
+    while (stack.Size())
+      {
+        const Node & node = nodes[stack.Last()];
+        stack.DeleteLast();
+        if (!InBox (node.pmin, node.pmax, p, dim)) continue;
+        if (node.child >= 0)
+          {
+            stack.Append (node.child);
+            stack.Append (node.child+1);
+            continue;
+          }
+
+        for (int j = node.first; j < node.next; j++)
+          {
+            int el = elnrs[j];
+            if (!InBox (elmin[el], elmax[el], p, dim)) continue;
+            HeapReset hr(lh);
+            auto & trafo = ma->GetTrafo (ElementId(VOL, el), lh);
+            bool found = false;
+            switch (dim)
+              {
+              case 1: found = MapToReference<1> (trafo, p, ip); break;
+              case 2: found = MapToReference<2> (trafo, p, ip); break;
+              case 3: found = MapToReference<3> (trafo, p, ip); break;
+              }
+            if (found) return el;
+          }
+      }
+    return -1;
+  }
+
+  void ElementSearchTree :: Find (SliceMatrix<> points, FlatArray<int> elnums,
+                                  FlatArray<IntegrationPoint> ips) const
+  {
+    static Timer t("ElementSearchTree::Find");
+    RegionTimer reg(t);
+
+    ParallelForRange (points.Height(), [&] (IntRange r)
+      {
+        LocalHeapMem<100000> lh("ElementSearchTree::Find");
+        for (auto i : r)
+          {
+            elnums[i] = Find (points.Row(i), ips[i], lh);
+            if (elnums[i] == -1)
+              ips[i] = IntegrationPoint(0, 0, 0, 0);
+          }
+      });
+  }
+
+  template <typename SCAL>
+  void ElementSearchTree :: Evaluate (const CoefficientFunction & cf, SliceMatrix<> points,
+                                      FlatMatrix<SCAL> values) const
+  {
+    static Timer t("ElementSearchTree::Evaluate");
+    RegionTimer reg(t);
+
+    size_t np = points.Height();
+    int cfdim = cf.Dimension();
+    Array<int> elnums(np);
+    Array<IntegrationPoint> ips(np);
+    Find (points, elnums, ips);
+
+    // group points of the same element
+    Array<int> order(np);
+    ParallelFor (np, [&] (size_t i) { order[i] = i; });
+    if (np > 0)
+      SampleSortI (elnums, order);
+
+    constexpr size_t maxp = 16;
+    ParallelForRange (np, [&] (IntRange r)
+      {
+        LocalHeapMem<100000> lh("ElementSearchTree::Evaluate");
+        IntegrationRule ir;
+
+        auto blocks = [&] (auto func)
+          {
+            for (size_t i = r.begin(); i < r.end(); )
+              {
+                int el = elnums[order[i]];
+                size_t first = i++;
+                while (i < r.end() && elnums[order[i]] == el && i < first+maxp)
+                  i++;
+                if (el == -1)
+                  {
+                    for (size_t k = first; k < i; k++)
+                      values.Row(order[k]) = SCAL(numeric_limits<double>::quiet_NaN());
+                    continue;
+                  }
+                HeapReset hr(lh);
+                ir.SetSize(0);
+                for (size_t k = first; k < i; k++)
+                  ir.Append (ips[order[k]]);
+                func (ma->GetTrafo (ElementId(VOL, el), lh), first);
+              }
+          };
+
+        auto eval = [&] ()
+          {
+            blocks ([&] (const ElementTransformation & trafo, size_t first)
+                    {
+                      auto & mir = trafo(ir, lh);
+                      FlatMatrix<SCAL> vals(ir.Size(), cfdim, lh);
+                      cf.Evaluate (mir, vals);
+                      for (size_t k = 0; k < ir.Size(); k++)
+                        values.Row(order[first+k]) = vals.Row(k);
+                    });
+          };
+
+        if constexpr (is_same<SCAL,double>())
+          {
+            try
+              {
+                Matrix<SIMD<double>> simdvals(cfdim, maxp / SIMD<double>::Size());
+                blocks ([&] (const ElementTransformation & trafo, size_t first)
+                        {
+                          SIMD_IntegrationRule simd_ir(ir, lh);
+                          auto & mir = trafo(simd_ir, lh);
+                          cf.Evaluate (mir, simdvals.Cols(0, simd_ir.Size()));
+                          SliceMatrix<> vals(cfdim, ir.Size(), simdvals.Width()*SIMD<double>::Size(),
+                                             (double*)&simdvals(0,0));
+                          for (size_t k = 0; k < ir.Size(); k++)
+                            values.Row(order[first+k]) = vals.Col(k);
+                        });
+              }
+            catch (const ExceptionNOSIMD & e)
+              {
+                eval();
+              }
+          }
+        else
+          eval();
+      });
+  }
+
+  template NGS_DLL_HEADER void ElementSearchTree ::
+  Evaluate<double> (const CoefficientFunction &, SliceMatrix<>, FlatMatrix<double>) const;
+  template NGS_DLL_HEADER void ElementSearchTree ::
+  Evaluate<Complex> (const CoefficientFunction &, SliceMatrix<>, FlatMatrix<Complex>) const;
+}
@@ -0,0 +1,66 @@
+#ifndef FILE_POINTSEARCH
+#define FILE_POINTSEARCH
+
+/*********************************************************************/
+/* File:   pointsearch.hpp                                           */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+namespace ngcomp
+{
+
+  /**
+     Bounding volume hierarchy over the volume elements of a mesh.
+
+     Elements are sorted along a Morton curve of their box centers, every
+     leaf holds a few consecutive elements. Boxes are computed from the
+     element transformation, so curved elements and mesh deformations are
+     taken into account. After a deformation Update() refits the boxes and
+     keeps the tree.
+   */
+  class NGS_DLL_HEADER ElementSearchTree
+  {
+    struct Node
+    {
+      Vec<3> pmin, pmax;
+      int first, next;     // range in elnrs
+      int child;           // children are child and child+1, -1 for leaves
+    };
+
+    shared_ptr<MeshAccess> ma;
+    int dim;
+    size_t timestamp = 0;
+    Array<int> elnrs;            // elements in Morton order
+    Array<Vec<3>> elmin, elmax;  // element boxes
+    Array<Node> nodes;
+
+  public:
+    ElementSearchTree (shared_ptr<MeshAccess> ama);
+
+    /// refit boxes after deformation, rebuild if the mesh has changed
+    void Update ();
+
+    /// element containing p and its reference coordinates, -1 if outside
+    int Find (FlatVector<> p, IntegrationPoint & ip, LocalHeap & lh) const;
+
+    /// locate all rows of points in parallel
+    void Find (SliceMatrix<> points, FlatArray<int> elnums,
+               FlatArray<IntegrationPoint> ips) const;
+
+    /// evaluate cf in all rows of points, rows outside the mesh get NaN
+    template <typename SCAL>
+    void Evaluate (const CoefficientFunction & cf, SliceMatrix<> points,
+                   FlatMatrix<SCAL> values) const;
+
+    shared_ptr<MeshAccess> GetMeshAccess () const { return ma; }
+
+  private:
+    void Build ();
+    void Refit ();
+    void ComputeElementBoxes ();
+    void FitNodes ();
+  };
+
+}
+
+#endif
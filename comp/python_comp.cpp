@@ -2043,6 +2043,43 @@ filename : string
 parallel : bool
   input parallel
 
+)raw_string"))
+    .def("SaveCheckpoint", [](GF& self, string filename)
+         {
+           self.SaveCheckpoint(filename);
+         },
+         py::arg("filename"), docu_string(R"raw_string(
+Saves all multidim vectors into one checkpoint file. The header stores
+space type, order, ndof, component layout and a hash of the mesh, the
+payload is written contiguously. With more than one MPI task, every
+rank writes its own file filename.rank.
+
+Parameters:
+
+filename : string
+  output file name
+
+)raw_string"))
+    .def("LoadCheckpoint", [](GF& self, string filename, bool mmap)
+         {
+           self.LoadCheckpoint(filename, mmap);
+         },
+         py::arg("filename"), py::arg("mmap")=false, docu_string(R"raw_string(
+Loads a checkpoint written by SaveCheckpoint. Space, mesh, layout and
+the number of MPI tasks have to match.
+
+Parameters:
+
+filename : string
+  input file name
+
+mmap : bool
+  map the file copy-on-write instead of reading it, the vectors of
+  the GridFunction are replaced by views into the mapping. Python
+  references to the old vectors (e.g. v = gf.vec taken before) keep
+  the old data and are no longer connected to the GridFunction.
+  Ignored for parallel spaces.
+
 )raw_string"))
     .def("Set", 
          [](shared_ptr<GF> self, spCF cf,
@@ -2544,6 +2581,11 @@ space : ngsolve.FESpace
                      "  BilinearForm will not allocate memory for assembling.\n"
                      "  optimization feature for (nonlinear) problems where the\n"
                      "  form is only applied but never assembled.",
+                     py::arg("precompute") = "bool = False\n"
+                     "  With nonassemble, keep the mapped integration points and the\n"
+                     "  values of CacheCF coefficients per element. Refreshed when the mesh\n"
+                     "  or a Parameter changes, and when a deformation is set; a deformation\n"
+                     "  changed in place has to be set again.",
                      py::arg("project") = "bool = False\n"
                      "  When calling bf.Assemble, all saved coarse matrices from\n"
                      "  mesh refinements are updated as well using a Galerkin projection\n"
@@ -2557,7 +2599,10 @@ space : ngsolve.FESpace
                      "  when element matrices are independent of geometry, we store them \n"
                      "  only for the referecne elements",
                      py::arg("check_unused") = "bool = True\n"
-		     "  If set prints warnings if not UNUSED_DOFS are not used."
+		     "  If set prints warnings if not UNUSED_DOFS are not used.",
+                     py::arg("store_elmats") = "bool = False\n"
+                     "  Keep the element matrices, needed by AssembleElements to\n"
+                     "  re-assemble only the changed elements."
                      );
                 })
 
@@ -2690,6 +2735,40 @@ reallocate : bool
 
 )raw_string"))
 
+    .def("AssembleElements", [](shared_ptr<BilinearForm> self, const BitArray & elements, VorB vb)
+         {
+           self->ReAssemble(lhp.GetLH(), vb, elements);
+           return self;
+         }, py::call_guard<py::gil_scoped_release>(),
+         py::arg("elements"), py::arg("vb")=VOL, docu_string(R"raw_string(
+Re-assemble the contributions of the marked elements only. The old
+element matrices are subtracted and the new ones are added, the
+bilinear form must be created with store_elmats=True. Falls back to
+a full assembly if the form has parts which are not stored per
+element (skeleton terms, registered preconditioners, ...).
+
+Parameters:
+
+elements : ngsolve.ngstd.BitArray
+  the elements to update
+
+vb : ngsolve.comp.VorB
+  volume or boundary elements
+
+)raw_string"))
+
+    .def("AssembleElements", [](shared_ptr<BilinearForm> self, Region reg)
+         {
+           BitArray elements(self->GetMeshAccess()->GetNE(reg.VB()));
+           elements.Clear();
+           for (auto el : self->GetMeshAccess()->Elements(reg.VB()))
+             if (reg.Mask().Test(el.GetIndex()))
+               elements.SetBit(el.Nr());
+           self->ReAssemble(lhp.GetLH(), reg.VB(), elements);
+           return self;
+         }, py::call_guard<py::gil_scoped_release>(),
+         py::arg("region"), "Re-assemble the contributions of all elements in the region")
+
     .def_property_readonly("mat", [](shared_ptr<BF> self) -> shared_ptr<BaseMatrix>
                                          {
                                            if (self->NonAssemble())
@@ -2829,6 +2908,10 @@ gf : ngsolve.comp.GridFunction
                      return self.GetInnerMatrix();
                    }, "inner_matrix of the bilinear form"
                   )
+    .def_property_readonly("num_precomputations", &BF::GetNumPrecomputations,
+                           "how often the element data of a precompute form was computed")
+    .def_property_readonly("num_skeleton_facet_builds", &BF::GetNumSkeletonFacetBuilds,
+                           "how often the skeleton facet table for nonassemble was built")
     .def("SetPreconditioner", &BF::SetPreconditioner)
     .def("UnsetPreconditioner", &BF::UnsetPreconditioner)
     ;
@@ -4347,7 +4430,8 @@ deformation : ngsolve.comp.GridFunction
    py::class_<BaseVTKOutput, shared_ptr<BaseVTKOutput>>(m, "VTKOutput")
     .def(py::init([] (shared_ptr<MeshAccess> ma, py::list coefs_list,
                       py::list names_list, string filename, int subdivision, 
-                      int only_element, string floatsize, bool legacy)
+                      int only_element, string floatsize, bool legacy,
+                      string encoding, bool compress)
          -> shared_ptr<BaseVTKOutput>
          {
            Array<shared_ptr<CoefficientFunction> > coefs
@@ -4356,9 +4440,9 @@ deformation : ngsolve.comp.GridFunction
              = makeCArray<string> (names_list);
            shared_ptr<BaseVTKOutput> ret;
            if (ma->GetDimension() == 2)
-             ret = make_shared<VTKOutput<2>> (ma, coefs, names, filename, subdivision, only_element, floatsize, legacy);
+             ret = make_shared<VTKOutput<2>> (ma, coefs, names, filename, subdivision, only_element, floatsize, legacy, encoding, compress);
            else
-             ret = make_shared<VTKOutput<3>> (ma, coefs, names, filename, subdivision, only_element, floatsize, legacy);
+             ret = make_shared<VTKOutput<3>> (ma, coefs, names, filename, subdivision, only_element, floatsize, legacy, encoding, compress);
            return ret;
          }),
          py::arg("ma"),
@@ -4369,6 +4453,8 @@ deformation : ngsolve.comp.GridFunction
          py::arg("only_element") = -1,
          py::arg("floatsize") = "double",
          py::arg("legacy") = false,
+         py::arg("encoding") = "raw",
+         py::arg("compress") = false,
          docu_string(R"raw_string(
 VTK output class. Allows to put mesh and field information of several CoefficientFunctions into a VTK file.
 (Can be used by independent visualization software, e.g. ParaView).
@@ -4405,6 +4491,12 @@ floatsize : string in {\"single\", \"double\" }   object
 
 legacy : bool (default: False)
   defines if legacy-VTK output shall be used 
+
+encoding : string in {\"raw\", \"base64\"}
+  binary data is written appended as raw bytes (default) or inline base64 encoded
+
+compress : bool (default: False)
+  zlib compression of the binary data (requires ngsolve built with zlib)
             .)raw_string")
          )
      .def("Do", [](shared_ptr<BaseVTKOutput> self, double time, VorB vb)
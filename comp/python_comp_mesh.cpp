@@ -929,6 +929,95 @@ will create a CF being 1e6 on the top boundary and 0. elsewhere.
          py::arg("VOL_or_BND") = VOL,
 	 docu_string("Get a MappedIntegrationPoint in the point (x,y,z) on the matching volume (VorB=VOL, default) or surface (VorB=BND) element. BBND elements aren't supported"));
 
+  typedef py::array_t<double, py::array::c_style | py::array::forcecast> PointArray;
+  auto AsPointMatrix = [] (const ElementSearchTree & tree, PointArray & points)
+    {
+      int dim = tree.GetMeshAccess()->GetDimension();
+      if (points.ndim() != 2 || points.shape(1) != dim)
+        throw Exception("points must be an N x " + ToString(dim) + " array");
+      return SliceMatrix<> (points.shape(0), dim, dim, const_cast<double*>(points.data()));
+    };
+
+  py::class_<ElementSearchTree, shared_ptr<ElementSearchTree>>
+    (m, "ElementSearchTree", docu_string(R"raw_string(
+Bounding volume hierarchy over the volume elements of a mesh for locating
+many points at once. Element boxes include curving and mesh deformation,
+call Update() after the deformation has changed.
+
+Parameters:
+
+mesh : ngsolve.Mesh
+  input mesh
+
+)raw_string"))
+    .def(py::init<shared_ptr<MeshAccess>>(), py::arg("mesh"))
+    .def("Update", &ElementSearchTree::Update,
+         "Refit the element boxes after mesh deformation, rebuild after refinement")
+    .def("Locate", [AsPointMatrix] (ElementSearchTree & self, PointArray points)
+         {
+           auto pts = AsPointMatrix(self, points);
+           size_t np = pts.Height();
+           Array<int> elnums(np);
+           Array<IntegrationPoint> ips(np);
+           {
+             py::gil_scoped_release release;
+             self.Find (pts, elnums, ips);
+           }
+           Array<double> refpts(3*np);
+           for (size_t i = 0; i < np; i++)
+             for (int j = 0; j < 3; j++)
+               refpts[3*i+j] = ips[i](j);
+           return py::make_tuple (MoveToNumpyArray(elnums),
+                                  MoveToNumpyArray(refpts).attr("reshape")(np, 3));
+         }, py::arg("points"),
+         docu_string(R"raw_string(
+Find the volume elements containing the points.
+
+Parameters:
+
+points : numpy.ndarray
+  N x dim array of coordinates
+
+Returns element numbers (-1 outside the mesh) and N x 3 reference coordinates.
+)raw_string"))
+    .def("Evaluate", [AsPointMatrix] (ElementSearchTree & self, shared_ptr<CoefficientFunction> cf,
+                                      PointArray points) -> py::array
+         {
+           auto pts = AsPointMatrix(self, points);
+           size_t np = pts.Height();
+           int cfdim = cf->Dimension();
+           if (!cf->IsComplex())
+             {
+               Array<double> vals(np*cfdim);
+               {
+                 py::gil_scoped_release release;
+                 self.Evaluate (*cf, pts, FlatMatrix<double>(np, cfdim, vals.Data()));
+               }
+               return MoveToNumpyArray(vals).attr("reshape")(np, cfdim);
+             }
+           Array<Complex> vals(np*cfdim);
+           {
+             py::gil_scoped_release release;
+             self.Evaluate (*cf, pts, FlatMatrix<Complex>(np, cfdim, vals.Data()));
+           }
+           return MoveToNumpyArray(vals).attr("reshape")(np, cfdim);
+         }, py::arg("cf"), py::arg("points"),
+         docu_string(R"raw_string(
+Evaluate a CoefficientFunction in many points. Points are located in parallel,
+grouped by element and evaluated with the vectorized evaluation.
+
+Parameters:
+
+cf : ngsolve.CoefficientFunction
+  function to evaluate
+
+points : numpy.ndarray
+  N x dim array of coordinates
+
+Returns an N x cf.dim array, rows of points outside the mesh are NaN.
+)raw_string"))
+    ;
+
   
     m.def("BoundaryFromVolumeCF", 
           [] (shared_ptr<CoefficientFunction> vol_cf)
@@ -0,0 +1,443 @@
+#include <saamg.hpp>
+
+#include <comp.hpp>
+using namespace ngcomp;
+
+
+namespace ngcomp
+{
+
+  // signed scalar surrogate of an entry, used for the prolongation smoother
+  template <typename TM>
+  static inline double EntryScalar (const TM & v)
+  {
+    if constexpr (is_same<TM,double>::value)
+      return v;
+    else if constexpr (is_same<TM,Complex>::value)
+      return v.real();
+    else
+      {
+        constexpr int N = mat_traits<TM>::HEIGHT;
+        double sum = 0;
+        for (int k = 0; k < N; k++)
+          sum += EntryScalar (v(k,k));
+        return sum / N;
+      }
+  }
+
+  // y += P x, blockwise for vector valued entries
+  template <typename TV>
+  static void TransferAdd (const SparseMatrixTM<double> & p, const BaseVector & x, BaseVector & y)
+  {
+    auto fx = x.FV<TV>();
+    auto fy = y.FV<TV>();
+    ParallelForRange (p.Height(), [&] (IntRange r)
+                      {
+                        for (auto i : r)
+                          {
+                            auto cols = p.GetRowIndices(i);
+                            auto vals = p.GetRowValues(i);
+                            TV sum = fy(i);
+                            for (size_t k = 0; k < cols.Size(); k++)
+                              sum += vals[k] * fx(cols[k]);
+                            fy(i) = sum;
+                          }
+                      });
+  }
+
+
+  template <typename TM>
+  SAAMG_Matrix<TM>::SAAMG_Matrix (shared_ptr<SparseMatrix<TM>> amat,
+                                  shared_ptr<BitArray> freedofs,
+                                  const SAAMG_Parameters & aparams,
+                                  int level)
+    : mat(amat), params(aparams)
+  {
+    static Timer t("SAAMG"); RegionTimer reg(t);
+    static Timer tstrong("SAAMG - strong connections");
+    static Timer tagg("SAAMG - aggregation");
+    static Timer tprol("SAAMG - prolongation");
+    static Timer tcoarse("SAAMG - coarse matrix");
+
+    const SparseMatrixTM<TM> & a = *mat;
+    size = a.Height();
+    size_t n = size;
+
+    smoother = mat->CreateJacobiPrecond(freedofs);
+
+    auto is_free = [&] (size_t i) { return !freedofs || freedofs->Test(i); };
+
+    // strong connections: |a_ij|^2 >= theta^2 |a_ii| |a_jj|, among free dofs
+    tstrong.Start();
+    Array<double> diagnorm(n);
+    ParallelFor (n, [&] (size_t i)
+                 {
+                   diagnorm[i] = sqrt (L2Norm2 (a(i,i)));
+                 });
+
+    double theta2 = sqr (params.strength);
+    auto strong = [&] (size_t i, size_t j, const TM & aij)
+      {
+        return i != j && is_free(j) && L2Norm2(aij) >= theta2 * diagnorm[i] * diagnorm[j];
+      };
+
+    TableCreator<int> strong_creator(n);
+    for ( ; !strong_creator.Done(); strong_creator++)
+      ParallelFor (n, [&] (size_t i)
+                   {
+                     if (!is_free(i)) return;
+                     auto cols = a.GetRowIndices(i);
+                     auto vals = a.GetRowValues(i);
+                     for (size_t k = 0; k < cols.Size(); k++)
+                       if (strong (i, cols[k], vals[k]))
+                         strong_creator.Add (i, cols[k]);
+                   });
+    Table<int> strongcon = strong_creator.MoveTable();
+    tstrong.Stop();
+
+
+    // aggregation: roots are a distance-2 maximal independent set,
+    // found in Luby-type rounds with pseudo-random priorities
+    tagg.Start();
+    enum { UNDECIDED, ROOT, DECIDED, EXCLUDED };
+    Array<char> state(n);
+    ParallelFor (n, [&] (size_t i)
+                 {
+                   // dofs without strong connection are left to the smoother
+                   state[i] = strongcon[i].Size() ? UNDECIDED : EXCLUDED;
+                 });
+
+    auto key = [&] (size_t i) -> size_t
+      {
+        if (state[i] != UNDECIDED) return 0;
+        size_t hash = (i * 2654435761ul) & 0xffffffff;
+        return (hash << 32) | (i & 0xffffffff);
+      };
+
+    Array<size_t> maxkey(n);
+    Array<bool> nearroot(n);
+    int rounds = 0;
+    while (true)
+      {
+        size_t num_undecided =
+          ParallelReduce (n, [&] (size_t i) { return size_t(state[i] == UNDECIDED); },
+                          [] (size_t s1, size_t s2) { return s1+s2; },
+                          size_t(0));
+        if (num_undecided == 0) break;
+        rounds++;
+
+        ParallelFor (n, [&] (size_t i)
+                     {
+                       size_t m = key(i);
+                       for (auto j : strongcon[i])
+                         m = max2 (m, key(j));
+                       maxkey[i] = m;
+                     });
+        ParallelFor (n, [&] (size_t i)
+                     {
+                       if (state[i] != UNDECIDED) return;
+                       size_t m = maxkey[i];
+                       for (auto j : strongcon[i])
+                         m = max2 (m, maxkey[j]);
+                       if (m == key(i))
+                         state[i] = ROOT;
+                     });
+        ParallelFor (n, [&] (size_t i)
+                     {
+                       bool near = state[i] == ROOT;
+                       for (auto j : strongcon[i])
+                         near |= state[j] == ROOT;
+                       nearroot[i] = near;
+                     });
+        ParallelFor (n, [&] (size_t i)
+                     {
+                       if (state[i] != UNDECIDED) return;
+                       bool near = nearroot[i];
+                       for (auto j : strongcon[i])
+                         near |= nearroot[j];
+                       if (near) state[i] = DECIDED;
+                     });
+      }
+
+    Array<int> agg(n), agg1(n);
+    size_t nc = 0;
+    for (size_t i = 0; i < n; i++)
+      agg[i] = (state[i] == ROOT) ? nc++ : -1;
+
+    // join the strongest neighbouring root, then the strongest aggregated neighbour
+    auto join = [&] (size_t i, FlatArray<int> from, auto valid)
+      {
+        int best = -1;
+        double maxval = 0;
+        auto cols = a.GetRowIndices(i);
+        auto vals = a.GetRowValues(i);
+        for (size_t k = 0; k < cols.Size(); k++)
+          {
+            size_t j = cols[k];
+            if (!valid(j) || !strong (i, j, vals[k])) continue;
+            double val = L2Norm2 (vals[k]);
+            if (best == -1 || val > maxval)
+              {
+                best = from[j];
+                maxval = val;
+              }
+          }
+        return best;
+      };
+
+    ParallelFor (n, [&] (size_t i)
+                 {
+                   agg1[i] = agg[i];
+                   if (state[i] == DECIDED)
+                     agg1[i] = join (i, agg, [&] (size_t j) { return state[j] == ROOT; });
+                 });
+    ParallelFor (n, [&] (size_t i)
+                 {
+                   agg[i] = agg1[i];
+                   if (state[i] == DECIDED && agg1[i] == -1)
+                     agg[i] = join (i, agg1, [&] (size_t j) { return agg1[j] != -1; });
+                 });
+    // left over for non-symmetric strong connections
+    for (size_t i = 0; i < n; i++)
+      if (state[i] == DECIDED && agg[i] == -1)
+        agg[i] = nc++;
+    tagg.Stop();
+
+    cout << IM(3) << "SAAMG: level = " << level << ", n = " << n << ", nc = " << nc
+         << ", mis-rounds = " << rounds << endl;
+
+
+    // tentative prolongation, and the smoothed one
+    tprol.Start();
+    Array<int> nne(n);
+    ParallelFor (n, [&] (size_t i) { nne[i] = (agg[i] != -1) ? 1 : 0; });
+    auto tentative = make_shared<SparseMatrix<double>> (nne, nc);
+    ParallelFor (n, [&] (size_t i)
+                 {
+                   if (agg[i] != -1)
+                     (*tentative)(i, agg[i]) = 1;
+                 });
+
+    if (params.smooth_prolongation && nc > 0)
+      {
+        // filtered matrix: strong couplings, weak couplings lumped to the diagonal
+        Array<double> fdiag(n);
+        ParallelFor (n, [&] (size_t i)
+                     {
+                       auto cols = a.GetRowIndices(i);
+                       auto vals = a.GetRowValues(i);
+                       double d = 0;
+                       for (size_t k = 0; k < cols.Size(); k++)
+                         {
+                           size_t j = cols[k];
+                           if (j == i || (is_free(j) && !strong (i, j, vals[k])))
+                             d += EntryScalar (vals[k]);
+                         }
+                       fdiag[i] = d;
+                     });
+
+        // Gershgorin bound for the spectral radius of D^-1 A_F
+        double rho =
+          ParallelReduce (n, [&] (size_t i)
+                          {
+                            if (agg[i] == -1 || fdiag[i] <= 0) return 0.0;
+                            double sum = fdiag[i];
+                            auto cols = a.GetRowIndices(i);
+                            auto vals = a.GetRowValues(i);
+                            for (size_t k = 0; k < cols.Size(); k++)
+                              if (strong (i, cols[k], vals[k]))
+                                sum += fabs (EntryScalar (vals[k]));
+                            return sum / fdiag[i];
+                          },
+                          [] (double r1, double r2) { return max2(r1,r2); },
+                          0.0);
+        double omega = (rho > 0) ? 4.0 / (3.0 * rho) : 0.0;
+
+        ParallelFor (n, [&] (size_t i)
+                     {
+                       if (agg[i] == -1) nne[i] = 0;
+                       else if (fdiag[i] <= 0) nne[i] = 1;
+                       else nne[i] = 1 + strongcon[i].Size();
+                     });
+        auto jacobi = make_shared<SparseMatrix<double>> (nne, n);
+        ParallelFor (n, [&] (size_t i)
+                     {
+                       if (agg[i] == -1) return;
+                       if (fdiag[i] <= 0)
+                         {
+                           (*jacobi)(i,i) = 1;
+                           return;
+                         }
+                       (*jacobi)(i,i) = 1-omega;
+                       auto cols = a.GetRowIndices(i);
+                       auto vals = a.GetRowValues(i);
+                       for (size_t k = 0; k < cols.Size(); k++)
+                         if (strong (i, cols[k], vals[k]))
+                           (*jacobi)(i,cols[k]) = -omega * EntryScalar (vals[k]) / fdiag[i];
+                     });
+        prolongation = MatMult (*jacobi, *tentative);
+      }
+    else
+      prolongation = tentative;
+    restriction = dynamic_pointer_cast<SparseMatrixTM<double>>(prolongation->CreateTranspose());
+    tprol.Stop();
+
+    if (nc == 0) return;
+
+    tcoarse.Start();
+    auto coarsemat = dynamic_pointer_cast<SparseMatrix<TM>> (mat->Restrict (*prolongation));
+    tcoarse.Stop();
+    if (!coarsemat)
+      throw Exception ("SAAMG: Restrict did not provide a SparseMatrix");
+
+    auto coarse_freedofs = make_shared<BitArray> (nc);
+    coarse_freedofs->Set();
+
+    if (nc <= params.coarsesize || nc > 0.9 * n || level+1 >= params.maxlevel)
+      {
+        coarsemat->SetInverseType (SPARSECHOLESKY);
+        coarse_precond = coarsemat->InverseMatrix (coarse_freedofs);
+      }
+    else
+      coarse_precond = make_shared<SAAMG_Matrix<TM>> (coarsemat, coarse_freedofs, params, level+1);
+  }
+
+
+  template <typename TM>
+  void SAAMG_Matrix<TM>::Smooth (BaseVector & x, const BaseVector & b, bool backward) const
+  {
+    if (!params.jacobi)
+      {
+        for (int k = 0; k < params.smoothing_steps; k++)
+          if (backward)
+            smoother->GSSmoothBack (x, b);
+          else
+            smoother->GSSmooth (x, b);
+        return;
+      }
+
+    auto res = b.CreateVector();
+    for (int k = 0; k < params.smoothing_steps; k++)
+      {
+        res = b - (*mat) * x;
+        smoother->MultAdd (params.jacobi_damping, res, x);
+      }
+  }
+
+
+  template <typename TM>
+  void SAAMG_Matrix<TM>::Mult (const BaseVector & b, BaseVector & x) const
+  {
+    static Timer t("SAAMG::Mult"); RegionTimer reg(t);
+    x = 0;
+    Smooth (x, b, false);
+
+    if (coarse_precond)
+      {
+        auto residuum = b.CreateVector();
+        residuum = b - (*mat) * x;
+
+        auto coarse_residuum = coarse_precond->CreateColVector();
+        auto coarse_x = coarse_precond->CreateColVector();
+        coarse_residuum = 0.0;
+        TransferAdd<TV> (*restriction, residuum, coarse_residuum);
+        coarse_precond->Mult (coarse_residuum, coarse_x);
+        TransferAdd<TV> (*prolongation, coarse_x, x);
+      }
+
+    Smooth (x, b, true);
+  }
+
+  template <typename TM>
+  int SAAMG_Matrix<TM>::GetNLevels () const
+  {
+    if (auto camg = dynamic_pointer_cast<SAAMG_Matrix<TM>> (coarse_precond))
+      return 1 + camg->GetNLevels();
+    return coarse_precond ? 2 : 1;
+  }
+
+
+  class SAAMG_Preconditioner : public Preconditioner
+  {
+    shared_ptr<BilinearForm> bfa;
+    shared_ptr<BaseMatrix> mat;
+    SAAMG_Parameters params;
+
+  public:
+    SAAMG_Preconditioner (shared_ptr<BilinearForm> abfa, const Flags & aflags,
+                          const string aname = "saamg")
+      : Preconditioner (abfa, aflags, aname), bfa(abfa)
+    {
+      params.strength = flags.GetNumFlag ("strength", params.strength);
+      params.smooth_prolongation = !flags.GetDefineFlag ("unsmoothed");
+      params.smoothing_steps = int(flags.GetNumFlag ("smoothingsteps", params.smoothing_steps));
+      params.jacobi = flags.GetStringFlag ("smoother", "gs") == "jacobi";
+      params.jacobi_damping = flags.GetNumFlag ("damping", params.jacobi_damping);
+      params.coarsesize = size_t(flags.GetNumFlag ("coarsesize", params.coarsesize));
+      params.maxlevel = int(flags.GetNumFlag ("maxlevel", params.maxlevel));
+    }
+
+    SAAMG_Preconditioner (const PDE & pde, const Flags & aflags, const string & aname)
+      : SAAMG_Preconditioner (pde.GetBilinearForm (aflags.GetStringFlag ("bilinearform")),
+                              aflags, aname)
+    { ; }
+
+    virtual void FinalizeLevel (const BaseMatrix * matrix) override
+    {
+      Update();
+    }
+
+    virtual void Update () override
+    {
+      if (GetTimeStamp() == bfa->GetTimeStamp()) return;
+      timestamp = bfa->GetTimeStamp();
+
+      static Timer t("SAAMG - setup"); RegionTimer reg(t);
+      auto amat = bfa->GetMatrixPtr();
+      auto freedofs = bfa->GetFESpace()->GetFreeDofs (bfa->UsesEliminateInternal());
+
+      auto setup = [&] (auto tm)
+        {
+          typedef decltype(tm) TM;
+          auto smat = dynamic_pointer_cast<SparseMatrix<TM>> (amat);
+          if (!smat) return false;
+          if (dynamic_pointer_cast<SparseMatrixSymmetricTM<TM>> (amat))
+            throw Exception ("SAAMG: needs the full matrix, do not use symmetric_storage");
+          auto amg = make_shared<SAAMG_Matrix<TM>> (smat, freedofs, params);
+          cout << IM(3) << "SAAMG: levels = " << amg->GetNLevels() << endl;
+          mat = amg;
+          return true;
+        };
+
+      if (!setup (double()) && !setup (Complex()) &&
+          !setup (Mat<2,2,double>()) && !setup (Mat<3,3,double>()))
+        throw Exception (string("SAAMG: expected a SparseMatrix with entries double, Complex, Mat<2,2> or Mat<3,3>, ")
+                         + "but got a matrix of type " + typeid(*amat).name());
+    }
+
+    virtual const BaseMatrix & GetMatrix() const override
+    {
+      if (!mat)
+        ThrowPreconditionerNotReady();
+      return *mat;
+    }
+
+    virtual const BaseMatrix & GetAMatrix() const override
+    {
+      return bfa->GetMatrix();
+    }
+
+    virtual const char * ClassName() const override
+    {
+      return "SAAMG Preconditioner";
+    }
+  };
+
+
+  template class SAAMG_Matrix<double>;
+  template class SAAMG_Matrix<Complex>;
+  template class SAAMG_Matrix<Mat<2,2,double>>;
+  template class SAAMG_Matrix<Mat<3,3,double>>;
+
+  static RegisterPreconditioner<SAAMG_Preconditioner> initpre ("saamg");
+}
@@ -0,0 +1,63 @@
+#ifndef SAAMG_HPP_
+#define SAAMG_HPP_
+
+#include <comp.hpp>
+
+namespace ngcomp
+{
+  /*
+    Smoothed aggregation AMG working on the assembled matrix.
+
+    Aggregates are built from a parallel distance-2 maximal independent
+    set of the strong-connection graph, the piecewise constant tentative
+    prolongation is smoothed by one damped Jacobi step with the filtered
+    matrix. For block entries Mat<N,N> the prolongation acts on every
+    component separately.
+  */
+  struct SAAMG_Parameters
+  {
+    double strength = 0.08;      // strong connection threshold
+    bool smooth_prolongation = true;
+    int smoothing_steps = 1;
+    bool jacobi = false;         // damped block-Jacobi instead of Gauss-Seidel
+    double jacobi_damping = 0.6;
+    size_t coarsesize = 500;     // direct solver below
+    int maxlevel = 20;
+  };
+
+  template <class TM>
+  class NGS_DLL_HEADER SAAMG_Matrix : public ngla::BaseMatrix
+  {
+    typedef typename ngla::SparseMatrix<TM>::TVX TV;
+
+    size_t size;
+    std::shared_ptr<ngla::SparseMatrix<TM>> mat;
+    std::shared_ptr<ngla::BaseJacobiPrecond> smoother;
+    std::shared_ptr<ngla::SparseMatrixTM<double>> prolongation, restriction;
+    std::shared_ptr<ngla::BaseMatrix> coarse_precond;
+    SAAMG_Parameters params;
+
+  public:
+    SAAMG_Matrix (std::shared_ptr<ngla::SparseMatrix<TM>> amat,
+                  std::shared_ptr<ngcore::BitArray> freedofs,
+                  const SAAMG_Parameters & aparams,
+                  int level = 0);
+
+    virtual int VHeight() const override { return size; }
+    virtual int VWidth() const override { return size; }
+    virtual bool IsComplex() const override { return mat->IsComplex(); }
+
+    virtual AutoVector CreateRowVector () const override { return mat->CreateColVector(); }
+    virtual AutoVector CreateColVector () const override { return mat->CreateRowVector(); }
+
+    virtual void Mult (const ngla::BaseVector & b, ngla::BaseVector & x) const override;
+
+    /// number of levels including the direct coarse level
+    int GetNLevels() const;
+
+  private:
+    void Smooth (ngla::BaseVector & x, const ngla::BaseVector & b, bool backward) const;
+  };
+}
+
+#endif // SAAMG_HPP_
@@ -5,12 +5,30 @@
 /*********************************************************************/
 
 #include <comp.hpp>
+#ifdef NGS_ZLIB
+#include <zlib.h>
+#endif
 
 namespace ngcomp
 {
 
   ValueField::ValueField(int adim, string aname) : Array<double>(), dim(adim), name(aname) { ; }
 
+  /// VTK cell type of the subdivided reference cells
+  static uint8_t VTKCellType (ELEMENT_TYPE eltype)
+  {
+    switch (eltype)
+      {
+      case ET_TRIG: return 5;
+      case ET_QUAD: return 9;
+      case ET_TET: return 10;
+      case ET_HEX: return 12;
+      case ET_PRISM: return 13;
+      default:
+        throw Exception("VTK output for element-type" + ToString(eltype) + "not supported");
+      }
+  }
+
   template <int D>
   VTKOutput<D>::VTKOutput(const Array<shared_ptr<CoefficientFunction>> &a_coefs,
                           const Flags &flags,
@@ -21,7 +39,9 @@ namespace ngcomp
                   (int)flags.GetNumFlag("subdivision", 0),
                   (int)flags.GetNumFlag("only_element", -1),
                   flags.GetStringFlag("floatsize", "double"),
-                  flags.GetDefineFlag("legacy"))
+                  flags.GetDefineFlag("legacy"),
+                  flags.GetStringFlag("encoding", "raw"),
+                  flags.GetDefineFlag("compress"))
   {
     ;
   }
@@ -31,10 +51,21 @@ namespace ngcomp
                           const Array<shared_ptr<CoefficientFunction>> &a_coefs,
                           const Array<string> &a_field_names,
                           string a_filename, int a_subdivision, int a_only_element, 
-                          string a_floatsize, bool a_legacy)
+                          string a_floatsize, bool a_legacy,
+                          string a_encoding, bool a_compress)
       : ma(ama), coefs(a_coefs), fieldnames(a_field_names),
-        filename(a_filename), subdivision(a_subdivision), only_element(a_only_element), floatsize(a_floatsize), legacy(a_legacy)
+        filename(a_filename), subdivision(a_subdivision), only_element(a_only_element), floatsize(a_floatsize), legacy(a_legacy),
+        encoding(a_encoding), compress(a_compress)
   {
+    if ((encoding != "raw") && (encoding != "base64"))
+      throw Exception("VTKOutput: encoding must be \"raw\" or \"base64\"");
+#ifndef NGS_ZLIB
+    if (compress)
+    {
+      cout << IM(1) << "VTKOutput: compiled without zlib, writing uncompressed data" << endl;
+      compress = false;
+    }
+#endif
     if ((floatsize != "double") && (floatsize != "float") && (floatsize != "single"))
       cout << IM(1) << "VTKOutput: floatsize is not int {\"double\",\"single\",\"float\"}. Using \"float|single\".";
     value_field.SetSize(a_coefs.Size());
@@ -51,6 +82,7 @@ namespace ngcomp
   {
     points.SetSize(0);
     cells.SetSize(0);
+    celltypes.SetSize(0);
     for (auto field : value_field)
       field->SetSize(0);
   }
@@ -357,43 +389,11 @@ namespace ngcomp
 
   /// output of cell types (here only simplices)
   template <int D>
-  void VTKOutput<D>::PrintCellTypesLegacy(VorB vb, const BitArray *drawelems)
+  void VTKOutput<D>::PrintCellTypesLegacy()
   {
     *fileout << "CELL_TYPES " << cells.Size() << endl;
-    int factor = (1 << subdivision) * (1 << subdivision);
-    if (D == 3 && vb == VOL)
-      factor *= (1 << subdivision);
-    for (auto e : ma->Elements(vb))
-    {
-      if (drawelems && !(drawelems->Test(e.Nr())))
-        continue;
-
-      switch (ma->GetElType(e))
-      {
-      case ET_TET:
-        for (int i = 0; i < factor; i++)
-          *fileout << "10 " << endl; //(void)c;
-        break;
-      case ET_QUAD:
-        for (int i = 0; i < factor; i++)
-          *fileout << "9 " << endl;
-        break;
-      case ET_TRIG:
-        for (int i = 0; i < factor; i++)
-          *fileout << "5 " << endl;
-        break;
-      case ET_PRISM:
-        for (int i = 0; i < factor; i++)
-          *fileout << "13 " << endl;
-        break;
-      case ET_HEX:
-        for (int i = 0; i < factor; i++)
-          *fileout << "12 " << endl;
-        break;
-      default:
-        cout << "VTKOutput Element Type " << ma->GetElType(e) << " not supported!" << endl;
-      }
-    }
+    for (auto type : celltypes)
+      *fileout << int(type) << " " << endl;
     *fileout << "CELL_DATA " << cells.Size() << endl;
     *fileout << "POINT_DATA " << points.Size() << endl;
   }
@@ -413,242 +413,195 @@ namespace ngcomp
       *fileout << endl;
     }
   }
-  /// output of data points, XML file format
-  template <int D>
-  void VTKOutput<D>::PrintPoints(int *offset, stringstream *appenddata)
+  /* ###########################
+     # XML Files               #
+     ###########################*/
+
+  /// raw binary data, filled in parallel
+  template <typename T, typename FUNC>
+  static string MakeBinary (size_t n, FUNC func)
   {
-    *fileout << "<Points>" << endl;
-    if (floatsize == "double")
+    string raw(n * sizeof(T), '\0');
+    T *data = reinterpret_cast<T *>(&raw[0]);
+    ParallelForRange (n, [&](IntRange r)
+                      {
+                        for (auto i : r)
+                          data[i] = func(i);
+                      });
+    return raw;
+  }
+
+  template <typename FUNC>
+  static string MakeFloatBinary (bool usedouble, size_t n, FUNC func)
+  {
+    if (usedouble)
+      return MakeBinary<double>(n, func);
+    return MakeBinary<float>(n, func);
+  }
+
+  static string Base64Encode (const string &in)
+  {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t n = in.size();
+    string out(4 * ((n + 2) / 3), '=');
+    constexpr size_t chunk = 3 * 4096; // input bytes per task, multiple of 3
+    ParallelForRange ((n + chunk - 1) / chunk, [&](IntRange r)
+                      {
+                        for (size_t i = r.First() * chunk; i < min(n, r.Next() * chunk); i += 3)
+                        {
+                          uint32_t b = uint32_t(uint8_t(in[i])) << 16;
+                          if (i + 1 < n)
+                            b |= uint32_t(uint8_t(in[i + 1])) << 8;
+                          if (i + 2 < n)
+                            b |= uint32_t(uint8_t(in[i + 2]));
+                          char *o = &out[4 * (i / 3)];
+                          o[0] = table[(b >> 18) & 63];
+                          o[1] = table[(b >> 12) & 63];
+                          if (i + 1 < n)
+                            o[2] = table[(b >> 6) & 63];
+                          if (i + 2 < n)
+                            o[3] = table[b & 63];
+                        }
+                      });
+    return out;
+  }
+
+  /// binary DataArray with UInt64 header: byte count, or block table for zlib compressed data
+  static string EncodeDataArray (const string &raw, bool compress, bool base64)
+  {
+    if (!compress)
     {
-      *fileout << "<DataArray type=\"Float64\" Name=\"Points\" NumberOfComponents=\"" << 3 << "\" format=\"appended\" offset=\"0\">" << endl;
+      uint64_t nbytes = raw.size();
+      string data((char *)&nbytes, sizeof(nbytes));
+      data += raw;
+      return base64 ? Base64Encode(data) : data;
     }
-    else
+#ifdef NGS_ZLIB
+    // blocks are compressed independently, as in VTK's vtkZLibDataCompressor
+    constexpr size_t blocksize = 1 << 15;
+    size_t nblocks = (raw.size() + blocksize - 1) / blocksize;
+    Array<string> blocks(nblocks);
+    ParallelFor (nblocks, [&](size_t i)
+                 {
+                   size_t first = i * blocksize;
+                   size_t size = min(blocksize, raw.size() - first);
+                   uLongf csize = compressBound(size);
+                   blocks[i].resize(csize);
+                   if (compress2((Bytef *)&blocks[i][0], &csize, (const Bytef *)&raw[first], size, Z_BEST_SPEED) != Z_OK)
+                     throw Exception("VTKOutput: zlib compression failed");
+                   blocks[i].resize(csize);
+                 });
+
+    Array<uint64_t> header(3 + nblocks);
+    header[0] = nblocks;
+    header[1] = blocksize;
+    header[2] = raw.size() % blocksize;
+    size_t ndata = 0;
+    for (size_t i = 0; i < nblocks; i++)
     {
-      *fileout << "<DataArray type=\"Float32\" Name=\"Points\" NumberOfComponents=\"" << 3 << "\" format=\"appended\" offset=\"0\">" << endl;
-    }
-    const double valdouble = 0;
-    double wvaldouble = 0;
-    const float val = 0;
-    float wval = 0;
-    stringstream data;
-
-    uint32_t count = 0;
-    if (floatsize == "double")
-    {
-      for (auto p : points)
-      {
-        for (int k = 0; k < D; k++)
-        {
-          wvaldouble = p[k];
-          data.write((char *)&wvaldouble, sizeof(wvaldouble));
-          count += sizeof(wvaldouble);
-        }
-        if (D == 2)
-        {
-          data.write((char *)&valdouble, sizeof(valdouble));
-          count += sizeof(valdouble);
-        }
-      }
+      header[3 + i] = blocks[i].size();
+      ndata += blocks[i].size();
     }
+    string sheader((char *)header.Data(), header.Size() * sizeof(uint64_t));
+    string data;
+    data.reserve(ndata);
+    for (auto &block : blocks)
+      data += block;
+    // header and data are encoded separately
+    if (base64)
+      return Base64Encode(sheader) + Base64Encode(data);
+    return sheader + data;
+#else
+    throw Exception("VTKOutput: compression requires zlib");
+#endif
+  }
+
+  /// output of one data array, inline (base64) or appended (raw)
+  template <int D>
+  void VTKOutput<D>::PrintDataArray(string type, string name, int ncomp, const string &raw,
+                                    size_t *offset, std::vector<string> *appended)
+  {
+    string data = EncodeDataArray(raw, compress, encoding == "base64");
+    *fileout << "<DataArray type=\"" << type << "\" Name=\"" << name << "\"";
+    if (ncomp > 0)
+      *fileout << " NumberOfComponents=\"" << ncomp << "\"";
+    if (encoding == "base64")
+      *fileout << " format=\"binary\">" << endl
+               << data << endl;
     else
     {
-      for (auto p : points)
-      {
-        for (int k = 0; k < D; k++)
-        {
-          wval = p[k];
-          data.write((char *)&wval, sizeof(wval));
-          count += sizeof(wval);
-        }
-        if (D == 2)
-        {
-          data.write((char *)&val, sizeof(val));
-          count += sizeof(val);
-        }
-      }
+      *fileout << " format=\"appended\" offset=\"" << *offset << "\">" << endl;
+      *offset += data.size();
+      appended->push_back(move(data));
     }
-    appenddata->write((char *)&count, sizeof(uint32_t));
-    *appenddata << data.str();
-    *offset = count + 4;
-    *fileout << endl
-             << "</DataArray>" << endl;
+    *fileout << "</DataArray>" << endl;
+  }
+
+  /// output of data points, XML file format
+  template <int D>
+  void VTKOutput<D>::PrintPoints(size_t *offset, std::vector<string> *appended)
+  {
+    bool usedouble = floatsize == "double";
+    auto raw = MakeFloatBinary(usedouble, 3 * points.Size(),
+                               [&](size_t i) { return i % 3 < D ? points[i / 3][i % 3] : 0.0; });
+    *fileout << "<Points>" << endl;
+    PrintDataArray(usedouble ? "Float64" : "Float32", "Points", 3, raw, offset, appended);
     *fileout << "</Points>" << endl;
   }
+
   /// output of cells in form vertices
   template <int D>
-  void VTKOutput<D>::PrintCells(int *offset, stringstream *appenddata)
+  void VTKOutput<D>::PrintCells(size_t *offset, std::vector<string> *appended)
   {
-    stringstream connectivity;
-    stringstream offsets;
-    uint32_t sizecon = 0;
-    uint32_t sizeoff = 0;
-    // count number of data for cells, one + number of vertices
-    // int32_t ndata = 0;
-    int32_t offs = 0;
-    for (auto c : cells)
-    {
-
-      int nv = c[0];
-      offs += nv;
-      offsets.write((char *)&offs, sizeof(int32_t));
-      sizeoff += sizeof(int32_t);
-      for (int i = 0; i < nv; i++)
-      {
-        connectivity.write((char *)&c[i + 1], sizeof(int));
-        sizecon += sizeof(int);
-      }
-    }
-    *fileout << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"" << *offset << "\">" << endl;
-    *fileout
-        << "</DataArray>" << endl;
-    *fileout << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\"" << *offset + 4 + sizecon << "\">" << endl;
-
-    *fileout
-        << "</DataArray>" << endl;
-    *offset += 8 + sizecon + sizeoff;
-
-    appenddata->write((char *)&sizecon, sizeof(uint32_t));
-    *appenddata << connectivity.str();
-    appenddata->write((char *)&sizeoff, sizeof(uint32_t));
-    *appenddata << offsets.str();
+    Array<size_t> first(cells.Size() + 1);
+    first[0] = 0;
+    for (size_t i = 0; i < cells.Size(); i++)
+      first[i + 1] = first[i] + cells[i][0];
+
+    string connectivity(first.Last() * sizeof(int32_t), '\0');
+    int32_t *pcon = reinterpret_cast<int32_t *>(&connectivity[0]);
+    ParallelForRange (cells.Size(), [&](IntRange r)
+                      {
+                        for (auto i : r)
+                          for (int j = 0; j < cells[i][0]; j++)
+                            pcon[first[i] + j] = cells[i][j + 1];
+                      });
+    PrintDataArray("Int32", "connectivity", 0, connectivity, offset, appended);
+    auto offsets = MakeBinary<int32_t>(cells.Size(), [&](size_t i) { return first[i + 1]; });
+    PrintDataArray("Int32", "offsets", 0, offsets, offset, appended);
   }
 
-  /// output of cell types (here only simplices)
+  /// output of cell types
   template <int D>
-  void VTKOutput<D>::PrintCellTypes(VorB vb, int *offset, stringstream *appenddata, const BitArray *drawelems)
+  void VTKOutput<D>::PrintCellTypes(size_t *offset, std::vector<string> *appended)
   {
-    *fileout << "<DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\"" << *offset << "\">" << endl;
-    int factor = (1 << subdivision) * (1 << subdivision);
-    stringstream data;
-    uint32_t sizetypes = 0;
-    uint8_t eltype;
-
-    if (D == 3 && vb == VOL)
-      factor *= (1 << subdivision);
-    for (auto e : ma->Elements(vb))
-    {
-      if (drawelems && !(drawelems->Test(e.Nr())))
-        continue;
-
-      switch (ma->GetElType(e))
-      {
-      case ET_TET:
-        for (int i = 0; i < factor; i++)
-        {
-          sizetypes += sizeof(uint8_t);
-          eltype = 10;
-          data.write((char *)&eltype, sizeof(uint8_t)); //(void)c;
-        }
-        break;
-      case ET_QUAD:
-        for (int i = 0; i < factor; i++)
-        {
-          sizetypes += sizeof(uint8_t);
-          eltype = 9;
-          data.write((char *)&eltype, sizeof(uint8_t));
-        }
-        break;
-      case ET_TRIG:
-        for (int i = 0; i < factor; i++)
-        {
-          sizetypes += sizeof(uint8_t);
-          eltype = 5;
-          data.write((char *)&eltype, sizeof(uint8_t));
-        }
-        break;
-      case ET_PRISM:
-        for (int i = 0; i < factor; i++)
-        {
-          sizetypes += sizeof(uint8_t);
-          eltype = 13;
-          data.write((char *)&eltype, sizeof(uint8_t));
-        }
-        break;
-      case ET_HEX:
-        for (int i = 0; i < factor; i++)
-        {
-          sizetypes += sizeof(uint8_t);
-          eltype = 12;
-          data.write((char *)&eltype, sizeof(uint8_t));
-        }
-        break;
-      default:
-        cout << "VTKOutput Element Type " << ma->GetElType(e) << " not supported!" << endl;
-      }
-    }
-    appenddata->write((char *)&sizetypes, sizeof(uint32_t));
-    *appenddata << data.str();
-    *offset += sizetypes + 4;
-
-    *fileout << endl
-             << "</DataArray>" << endl;
+    auto types = MakeBinary<uint8_t>(celltypes.Size(), [&](size_t i) { return celltypes[i]; });
+    PrintDataArray("UInt8", "types", 0, types, offset, appended);
   }
 
   /// output of field data (coefficient values)
   template <int D>
-  void VTKOutput<D>::PrintFieldData(int *offset, stringstream *appenddata)
+  void VTKOutput<D>::PrintFieldData(size_t *offset, std::vector<string> *appended)
   {
-    string header = "";
-    string content = "";
-    stringstream data;
-    int32_t fieldsize = 0;
-    header += "<PointData>"; // \"" << field->Name() << "\">" << endl;
-    *fileout << header << endl;
+    bool usedouble = floatsize == "double";
+    *fileout << "<PointData>" << endl;
     for (auto field : value_field)
     {
-      if (floatsize == "double")
-      {
-        *fileout << "<DataArray type=\"Float64\" Name=\"" << field->Name() << "\" NumberOfComponents=\"" << field->Dimension() << "\" format=\"appended\" offset=\"" << *offset << "\">" << endl;
-        //      *fileout << "<DataArray type=\"Float64\" Name=\"" << field->Name() << "\" NumberOfComponents=\"" << field->Dimension() << "\" format=\"appended\" offset=\"0\">" << endl;
-      }
-      else
-      {
-        *fileout << "<DataArray type=\"Float32\" Name=\"" << field->Name() << "\" NumberOfComponents=\"" << field->Dimension() << "\" format=\"appended\" offset=\"" << *offset << "\">" << endl;
-      }
-      double temp = 0;
-      float temp2 = 0;
-      for (auto v : *field)
-      {
-        if (floatsize == "double")
-        {
-          temp = v;
-          //fileout->write((char *)&temp, sizeof(double));
-          data.write((char *)&temp, sizeof(temp));
-          fieldsize += sizeof(temp);
-        }
-        else
-        {
-          temp2 = v;
-          //fileout->write((char *)&temp, sizeof(double));
-          data.write((char *)&temp2, sizeof(temp2));
-          fieldsize += sizeof(temp2);
-        }
-      }
-      *offset += 4 + fieldsize;
-      appenddata->write((char *)&fieldsize, sizeof(int32_t));
-      *appenddata << data.str();
-
-      data.str("");
-      data.clear();
-      fieldsize = 0;
-      *fileout << endl;
-      *fileout << "</DataArray>" << endl;
+      auto raw = MakeFloatBinary(usedouble, field->Size(), [&](size_t i) { return (*field)[i]; });
+      PrintDataArray(usedouble ? "Float64" : "Float32", field->Name(), field->Dimension(), raw, offset, appended);
     }
     *fileout << "</PointData>" << endl;
   }
+
   template <int D>
-  void VTKOutput<D>::PrintAppended(stringstream *appended)
+  void VTKOutput<D>::PrintAppended(std::vector<string> *appended)
   {
+    if (encoding == "base64")
+      return;
     *fileout << "<AppendedData encoding=\"raw\">" << endl
              << "_";
-    *fileout << appended->str();
-    /*   for (auto field : value_field)
-    {
-      for (auto v : *field)
-      {
-        fileout->write((char *)&v, sizeof(double));
-      }
-    }*/
+    for (auto &data : *appended)
+      fileout->write(data.data(), data.size());
     *fileout << endl
              << "</AppendedData>" << endl;
   }
@@ -697,10 +650,14 @@ namespace ngcomp
   template <int D>
   void VTKOutput<D>::Do(LocalHeap &lh, double time, VorB vb, const BitArray *drawelems)
   {
+    static Timer t("VTKOutput::Do");
+    static Timer tfill("VTKOutput::Do - fill arrays");
+    static Timer twrite("VTKOutput::Do - write");
+    RegionTimer reg(t);
+
     ostringstream filenamefinal;
-    stringstream appended;
-    vector<int> datalength;
-    int offs = 0;
+    std::vector<string> appended;
+    size_t offs = 0;
 
     filenamefinal << filename;
 
@@ -748,15 +705,15 @@ namespace ngcomp
     else
       return;
 
-    fileout = make_shared<ofstream>(filenamefinal.str());
-
+    if (legacy)
+      fileout = make_shared<ofstream>(filenamefinal.str());
+    else
+      fileout = make_shared<ofstream>(filenamefinal.str(), ios::binary);
 
     ResetArrays();
 
     Array<IntegrationPoint> ref_vertices_tet(0), ref_vertices_prism(0), ref_vertices_trig(0), ref_vertices_quad(0), ref_vertices_hex(0);
     Array<INT<ELEMENT_MAXPOINTS + 1>> ref_tets(0), ref_prisms(0), ref_trigs(0), ref_quads(0), ref_hexes(0);
-    FlatArray<IntegrationPoint> ref_vertices;
-    FlatArray<INT<ELEMENT_MAXPOINTS + 1>> ref_elems;
     /*
     if (D==3)
       FillReferenceData3D(ref_vertices,ref_tets);
@@ -769,12 +726,35 @@ namespace ngcomp
     FillReferenceTrig(ref_vertices_trig, ref_trigs);
     FillReferenceHex(ref_vertices_hex, ref_hexes);
 
+    auto GetReference = [&](ELEMENT_TYPE eltype)
+      -> tuple<FlatArray<IntegrationPoint>, FlatArray<INT<ELEMENT_MAXPOINTS + 1>>>
+    {
+      switch (eltype)
+      {
+      case ET_TRIG:
+        return {ref_vertices_trig, ref_trigs};
+      case ET_QUAD:
+        return {ref_vertices_quad, ref_quads};
+      case ET_TET:
+        return {ref_vertices_tet, ref_tets};
+      case ET_HEX:
+        return {ref_vertices_hex, ref_hexes};
+      case ET_PRISM:
+        return {ref_vertices_prism, ref_prisms};
+      default:
+        throw Exception("VTK output for element-type" + ToString(eltype) + "not supported");
+      }
+    };
+
     // header:
     if (!legacy)
     {
       *fileout << "<?xml version=\"1.0\"?>" << endl;
 
-      *fileout << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"LittleEndian\">" << endl;
+      *fileout << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\"";
+      if (compress)
+        *fileout << " compressor=\"vtkZLibDataCompressor\"";
+      *fileout << ">" << endl;
       *fileout << "<UnstructuredGrid>" << endl;
     }
     else
@@ -784,102 +764,86 @@ namespace ngcomp
       *fileout << "ASCII" << endl;
       *fileout << "DATASET UNSTRUCTURED_GRID" << endl;
     }
+
+    tfill.Start();
     int ne = ma->GetNE(vb);
 
     IntRange range = only_element >= 0 ? IntRange(only_element, only_element + 1) : IntRange(ne);
 
+    // positions of the elements in the point and cell arrays
+    Array<int> elnrs;
     for (int elnr : range)
-    {
-      if (drawelems && !(drawelems->Test(elnr)))
-        continue;
+      if (!drawelems || drawelems->Test(elnr))
+        elnrs.Append(elnr);
 
-      HeapReset hr(lh);
+    Array<size_t> firstpoint(elnrs.Size() + 1), firstcell(elnrs.Size() + 1);
+    firstpoint[0] = 0;
+    firstcell[0] = 0;
+    for (size_t i = 0; i < elnrs.Size(); i++)
+    {
+      auto [ref_vertices, ref_elems] = GetReference(ma->GetElType(ElementId(vb, elnrs[i])));
+      firstpoint[i + 1] = firstpoint[i] + ref_vertices.Size();
+      firstcell[i + 1] = firstcell[i] + ref_elems.Size();
+    }
 
-      ElementId ei(vb, elnr);
-      ElementTransformation &eltrans = ma->GetTrafo(ei, lh);
-      ELEMENT_TYPE eltype = ma->GetElType(ei);
+    points.SetSize(firstpoint.Last());
+    cells.SetSize(firstcell.Last());
+    celltypes.SetSize(firstcell.Last());
+    for (auto field : value_field)
+      field->SetSize(field->Dimension() * points.Size());
 
-      switch (eltype)
+    LocalHeap &clh = lh;
+    ParallelForRange (elnrs.Size(), [&](IntRange r)
+    {
+      LocalHeap lh = clh.Split();
+      for (auto i : r)
       {
-      case ET_TRIG:
-        ref_vertices.Assign(ref_vertices_trig);
-        ref_elems.Assign(ref_trigs);
-        break;
-      case ET_QUAD:
-        ref_vertices.Assign(ref_vertices_quad);
-        ref_elems.Assign(ref_quads);
-        break;
-      case ET_TET:
-        ref_vertices.Assign(ref_vertices_tet);
-        ref_elems.Assign(ref_tets);
-        break;
-      case ET_HEX:
-        ref_vertices.Assign(ref_vertices_hex);
-        ref_elems.Assign(ref_hexes);
-        break;
-      case ET_PRISM:
-        ref_vertices.Assign(ref_vertices_prism);
-        ref_elems.Assign(ref_prisms);
-        break;
-      default:
-        throw Exception("VTK output for element-type" + ToString(eltype) + "not supported");
-      }
+        HeapReset hr(lh);
 
-      int offset = points.Size();
-      for (auto ip : ref_vertices)
-      {
-        if (vb == VOL)
-        {
-          MappedIntegrationPoint<D, D> mip(ip, eltrans);
-          points.Append(mip.GetPoint());
-        }
-        else
+        ElementId ei(vb, elnrs[i]);
+        ElementTransformation &eltrans = ma->GetTrafo(ei, lh);
+        ELEMENT_TYPE eltype = ma->GetElType(ei);
+        auto [ref_vertices, ref_elems] = GetReference(eltype);
+
+        size_t offset = firstpoint[i];
+        IntegrationRule ir(ref_vertices.Size(), ref_vertices.Data());
+        auto &mir = eltrans(ir, lh);
+        auto pts = mir.GetPoints();
+        for (size_t j = 0; j < ir.Size(); j++)
+          points[offset + j] = pts.Row(j);
+
+        for (int k = 0; k < coefs.Size(); k++)
         {
-          MappedIntegrationPoint<D - 1, D> mip(ip, eltrans);
-          points.Append(mip.GetPoint());
+          const int dim = coefs[k]->Dimension();
+          FlatMatrix<> values(ir.Size(), dim, lh);
+          coefs[k]->Evaluate(mir, values);
+          auto &field = *value_field[k];
+          for (size_t j = 0; j < ir.Size(); j++)
+            for (int d = 0; d < dim; ++d)
+              field[(offset + j) * dim + d] = values(j, d);
         }
-      }
 
-      for (int i = 0; i < coefs.Size(); i++)
-      {
-        for (auto ip : ref_vertices)
+        uint8_t type = VTKCellType(eltype);
+        for (size_t j = 0; j < ref_elems.Size(); j++)
         {
-          if (vb == VOL)
-          {
-            MappedIntegrationPoint<D, D> mip(ip, eltrans);
-            const int dim = coefs[i]->Dimension();
-            FlatVector<> tmp(dim, lh);
-            coefs[i]->Evaluate(mip, tmp);
-            for (int d = 0; d < dim; ++d)
-              value_field[i]->Append(tmp(d));
-          }
-          else
-          {
-            MappedIntegrationPoint<D - 1, D> mip(ip, eltrans);
-            const int dim = coefs[i]->Dimension();
-            FlatVector<> tmp(dim, lh);
-            coefs[i]->Evaluate(mip, tmp);
-            for (int d = 0; d < dim; ++d)
-              value_field[i]->Append(tmp(d));
-          }
+          INT<ELEMENT_MAXPOINTS + 1> new_elem = ref_elems[j];
+          for (int l = 1; l <= new_elem[0]; ++l)
+            new_elem[l] += offset;
+          cells[firstcell[i] + j] = new_elem;
+          celltypes[firstcell[i] + j] = type;
         }
       }
+    });
+    tfill.Stop();
 
-      for (auto elem : ref_elems)
-      {
-        INT<ELEMENT_MAXPOINTS + 1> new_elem = elem;
-        for (int i = 1; i <= new_elem[0]; ++i)
-          new_elem[i] += offset;
-        cells.Append(new_elem);
-      }
-    }
+    RegionTimer regw(twrite);
     if (!legacy)
     {
       *fileout << "<Piece NumberOfPoints=\"" << points.Size() << "\" NumberOfCells=\"" << cells.Size() << "\">" << endl;
       PrintPoints(&offs, &appended);
       *fileout << "<Cells>" << endl;
       PrintCells(&offs, &appended);
-      PrintCellTypes(vb, &offs, &appended, drawelems);
+      PrintCellTypes(&offs, &appended);
       *fileout << "</Cells>" << endl;
       PrintFieldData(&offs, &appended);
 
@@ -893,7 +857,7 @@ namespace ngcomp
     {
       PrintPointsLegacy();
       PrintCellsLegacy();
-      PrintCellTypesLegacy(vb, drawelems);
+      PrintCellTypesLegacy();
       PrintFieldDataLegacy();
     }
     cout << IM(4) << " Done." << endl;
@@ -48,10 +48,13 @@ namespace ngcomp
     int only_element = -1;
     string floatsize = "double";
     bool legacy = false;
+    string encoding = "raw";   // "raw" (appended) or "base64" (inline)
+    bool compress = false;     // zlib compression of binary data
     Array<shared_ptr<ValueField>>
         value_field;
     Array<Vec<D>> points;
     Array<INT<ELEMENT_MAXPOINTS + 1>> cells;
+    Array<uint8_t> celltypes;
 
     int output_cnt = 0;
     std::vector<double> times = {0};
@@ -62,7 +65,8 @@ namespace ngcomp
               const Flags &, shared_ptr<MeshAccess>);
 
     VTKOutput(shared_ptr<MeshAccess>, const Array<shared_ptr<CoefficientFunction>> &,
-              const Array<string> &, string, int, int, string, bool);
+              const Array<string> &, string, int, int, string, bool,
+              string = "raw", bool = false);
     virtual ~VTKOutput() { ; }
 
     void ResetArrays();
@@ -74,17 +78,19 @@ namespace ngcomp
     void FillReferencePrism(Array<IntegrationPoint> &ref_coords, Array<INT<ELEMENT_MAXPOINTS + 1>> &ref_elems);
     // void FillReferenceData3D(Array<IntegrationPoint> & ref_coords, Array<INT<D+1>> & ref_tets);
     // XML Methods
-    void PrintPoints(int *offset, stringstream *appenddata);
-    void PrintCells(int *offset, stringstream *appenddata);
-    void PrintCellTypes(VorB vb, int *offset, stringstream *appenddata, const BitArray *drawelems = nullptr);
-    void PrintFieldData(int *offset, stringstream *appenddata);
-
-    void PrintAppended(stringstream *appenddata);
+    void PrintDataArray(string type, string name, int ncomp, const string &raw,
+                        size_t *offset, std::vector<string> *appended);
+    void PrintPoints(size_t *offset, std::vector<string> *appended);
+    void PrintCells(size_t *offset, std::vector<string> *appended);
+    void PrintCellTypes(size_t *offset, std::vector<string> *appended);
+    void PrintFieldData(size_t *offset, std::vector<string> *appended);
+
+    void PrintAppended(std::vector<string> *appended);
     void PvdFile(string filename, int index);
     // Legacy Methods
     void PrintPointsLegacy();
     void PrintCellsLegacy();
-    void PrintCellTypesLegacy(VorB vb, const BitArray *drawelems = nullptr);
+    void PrintCellTypesLegacy();
     void PrintFieldDataLegacy();
     virtual void Do(LocalHeap &lh, double time = -1, VorB vb = VOL, const BitArray *drawelems = 0);
   };
@@ -4,10 +4,17 @@
 #include<l2hofefo.hpp>
 #include<regex>
 #include<cstdio>
+#include<random>
 
 namespace ngfem
 {
   bool code_uses_tensors = false;
+  // directory for compiled CoefficientFunctions, empty: no caching
+  string compile_cache_dir = [] ()
+    {
+      auto dir = getenv("NGSOLVE_COMPILE_CACHE");
+      return dir ? string(dir) : string();
+    } ();
 
   
     atomic<unsigned> Code::id_counter{0};
@@ -57,11 +64,172 @@ namespace ngfem
   }
   
   
+  // the cache stores file + file.key, the key is compared on lookup to exclude hash collisions
+  static bool LookupCompileCache (const filesystem::path & file, const string & key)
+  {
+    auto keyfile = file;
+    keyfile += ".key";
+    if (!filesystem::exists(file) || !filesystem::exists(keyfile))
+      return false;
+    ifstream fkey(keyfile, ios::binary);
+    stringstream skey;
+    skey << fkey.rdbuf();
+    return skey.str() == key;
+  }
+
+  static void StoreCompileCache (const filesystem::path & src, const filesystem::path & file, const string & key)
+  {
+    // other processes may read the cache concurrently: write to a temporary name and rename
+    try
+      {
+        filesystem::create_directories(file.parent_path());
+        string suffix = ".tmp" + ToString(std::random_device()());
+        auto keyfile = file;
+        keyfile += ".key";
+        auto tmpkey = keyfile;
+        tmpkey += suffix;
+        auto tmpfile = file;
+        tmpfile += suffix;
+        {
+          ofstream fkey(tmpkey, ios::binary);
+          fkey << key;
+        }
+        filesystem::copy_file(src, tmpfile, filesystem::copy_options::overwrite_existing);
+        filesystem::rename(tmpkey, keyfile);
+        filesystem::rename(tmpfile, file);
+      }
+    catch (const std::exception & e)
+      {
+        cout << IM(3) << "could not write to compile cache: " << e.what() << endl;
+      }
+  }
+
+  // the compiler wrappers carry the effective flags (e.g. -march), so their
+  // contents go into the cache keys
+  static string ToolFingerprint (const string & cmd)
+  {
+    string exe = cmd.substr(0, cmd.find(' '));
+    string result;
+#ifdef WIN32
+    char sep = ';';
+#else
+    char sep = ':';
+#endif
+    if (auto path = getenv("PATH"))
+      {
+        stringstream dirs(path);
+        string dir;
+        while (getline(dirs, dir, sep))
+          {
+            auto file = filesystem::path(dir) / exe;
+            if (dir != "" && filesystem::is_regular_file(file))
+              {
+                ifstream fexe(file, ios::binary);
+                stringstream contents;
+                contents << fexe.rdbuf();
+                result += file.string() + "\n" + contents.str() + "\n";
+                break;
+              }
+          }
+      }
+    return result;
+  }
+
+  // objects built with -march=native depend on the host cpu,
+  // a cache shared by different nodes must not mix them
+  static string HostISA ()
+  {
+    string isa;
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NGS_CPU_FEATURE(name) if (__builtin_cpu_supports(name)) isa += " " name;
+    NGS_CPU_FEATURE("sse4.2");
+    NGS_CPU_FEATURE("avx");
+    NGS_CPU_FEATURE("avx2");
+    NGS_CPU_FEATURE("fma");
+    NGS_CPU_FEATURE("avx512f");
+    NGS_CPU_FEATURE("avx512dq");
+    NGS_CPU_FEATURE("avx512vl");
+    NGS_CPU_FEATURE("avx512bw");
+#undef NGS_CPU_FEATURE
+#elif defined(__aarch64__) || defined(__arm64__)
+    isa = "arm64";
+#else
+    isa = "unknown";
+#endif
+    return "host isa:" + isa + "\n";
+  }
+
+  static string CompileCacheName (const string & key)
+  {
+    stringstream name;
+    name << "cf_" << std::hex << std::hash<string>()(key);
+    return name.str();
+  }
+  
+  
     unique_ptr<SharedLibrary> CompileCode(const std::vector<std::variant<filesystem::path, string>> &codes, const std::vector<string> &link_flags, bool keep_files )
     {
       static int counter = 0;
       static ngstd::Timer tcompile("CompiledCF::Compile");
       static ngstd::Timer tlink("CompiledCF::Link");
+      static ngstd::Timer tlibhit("CompiledCF::Cache library hit");
+      static ngstd::Timer tlibmiss("CompiledCF::Cache library miss");
+      static ngstd::Timer tobjhit("CompiledCF::Cache object hit");
+      static ngstd::Timer tobjmiss("CompiledCF::Cache object miss");
+
+#ifdef WIN32
+      string compile_cmd = "ngscxx.bat";
+      string link_cmd = "ngsld.bat";
+      string lib_ext = ".dll";
+      string obj_ext = ".obj";
+#else // WIN32
+      string compile_cmd = "ngscxx -c";
+      string link_cmd = "ngsld -shared -lngstd -lngbla -lngfem -lngla -lngcomp -lngcore";
+      string lib_ext = ".so";
+      string obj_ext = ".o";
+#endif // WIN32
+      for (auto flag : link_flags)
+        link_cmd += " "+flag;
+
+      // content addressed cache, files given by name are not cached (they may include other files)
+      bool use_cache = compile_cache_dir != "";
+      bool cache_library = use_cache;
+      for (auto & code : codes)
+        if (std::holds_alternative<filesystem::path>(code))
+          cache_library = false;
+
+      // the key of every cached file: version, toolchain with its flags, and host cpu
+      static string compile_key, link_key;
+      filesystem::path cache_dir;
+      if (use_cache)
+        {
+          static once_flag fingerprint_once;
+          call_once (fingerprint_once, [&] ()
+                     {
+                       compile_key = ngsolve_version + "\n" + HostISA() + compile_cmd + "\n" + ToolFingerprint(compile_cmd);
+                       link_key = ToolFingerprint(link_cmd);
+                     });
+          // we cd into the build directory before linking
+          cache_dir = filesystem::absolute(compile_cache_dir);
+        }
+
+      string lib_key;
+      filesystem::path cached_lib;
+      if (cache_library)
+        {
+          lib_key = compile_key + link_key + link_cmd + "\n";
+          for (auto & code : codes)
+            lib_key += std::get<string>(code) + "\n";
+          cached_lib = cache_dir / (CompileCacheName(lib_key) + lib_ext);
+          if (LookupCompileCache (cached_lib, lib_key))
+            {
+              RegionTimer reg(tlibhit);
+              cout << IM(3) << "loading cached library " << cached_lib.string() << endl;
+              return make_unique<SharedLibrary>(cached_lib);
+            }
+          RegionTimer reg(tlibmiss);
+        }
+      
       string object_files;
       int rank = 0;
 #ifdef PARALLEL
@@ -81,11 +249,25 @@ namespace ngfem
       filesystem::create_directories(lib_dir);
       for(auto i : Range(codes.size())) {
         filesystem::path src_file;
+        string obj_key;
+        filesystem::path cached_obj;
         if(std::holds_alternative<filesystem::path>(codes[i]))
             src_file = filesystem::absolute(std::get<filesystem::path>(codes[i]));
         else
         {
             string code = std::get<string>(codes[i]);
+            if (use_cache)
+              {
+                obj_key = compile_key + code;
+                cached_obj = cache_dir / (CompileCacheName(obj_key) + obj_ext);
+                if (LookupCompileCache (cached_obj, obj_key))
+                  {
+                    RegionTimer reg(tobjhit);
+                    object_files += " " + cached_obj.string();
+                    continue;
+                  }
+                RegionTimer reg(tobjmiss);
+              }
             src_file = filesystem::path(lib_dir).append("code_" + ToString(i) + ".cpp");
             ofstream codefile(src_file);
             codefile << code;
@@ -93,38 +275,36 @@ namespace ngfem
         }
         cout << IM(3) << "compiling..." << endl;
         tcompile.Start();
+        auto obj_file = filesystem::path(src_file).replace_extension(obj_ext);
 #ifdef WIN32
-        string scompile = "cmd /C \"ngscxx.bat " + src_file.string();
-        object_files += " " + filesystem::path(src_file).replace_extension(".obj ").string();
+        string scompile = "cmd /C \"" + compile_cmd + " " + src_file.string();
+        object_files += " " + obj_file.string() + " ";
 #else // WIN32
-        auto obj_file = " " + filesystem::path(src_file).replace_extension(".o").string();
-        string scompile = "ngscxx -c " + src_file.string() + " -o " + obj_file;
-        object_files += obj_file;
+        string scompile = compile_cmd + " " + src_file.string() + " -o " + obj_file.string();
+        object_files += " " + obj_file.string();
 #endif // WIN32
         int err = system((chdir_cmd + scompile).c_str());
         if (err) throw Exception ("problem calling compiler");
         tcompile.Stop();
+        if (obj_key != "")
+          StoreCompileCache (filesystem::path(lib_dir) / obj_file.filename(), cached_obj, obj_key);
       }
 
       cout << IM(3) << "linking..." << endl;
       tlink.Start();
       auto lib_file = filesystem::path(lib_dir).append("library");
+      lib_file.concat(lib_ext);
 #ifdef WIN32
-      lib_file.concat(".dll");
-      string slink = "cmd /C \"ngsld.bat /OUT:" + lib_file.string() + " " + object_files;
-      for (auto flag : link_flags)
-        slink += " "+flag;
-      slink += " \"";
+      string slink = "cmd /C \"" + link_cmd + " /OUT:" + lib_file.string() + " " + object_files + " \"";
 #else // WIN32
-      lib_file.concat(".so");
-      string slink = "ngsld -shared " + object_files + " -o " + lib_file.string() + " -lngstd -lngbla -lngfem -lngla -lngcomp -lngcore";
-      for (auto flag : link_flags)
-        slink += " "+flag;
+      string slink = link_cmd + " " + object_files + " -o " + lib_file.string();
 #endif // WIN32
       int err = system((chdir_cmd + slink).c_str());
       if (err) throw Exception ("problem calling linker");      
       tlink.Stop();
       cout << IM(3) << "done" << endl;
+      if (cache_library)
+        StoreCompileCache (lib_file, cached_lib, lib_key);
       if(keep_files)
       {
           cout << IM(2) << "keeping generated files at " << lib_dir.string() << endl;
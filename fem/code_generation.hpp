@@ -14,6 +14,7 @@
 namespace ngfem
 {
   extern bool code_uses_tensors;
+  NGS_DLL_HEADER extern string compile_cache_dir;
 
   template <typename T>
   inline string ToLiteral(const T & val)
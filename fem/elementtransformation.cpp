@@ -23,6 +23,26 @@ namespace ngfem
     throw ExceptionNOSIMD("ElementTransformation(SIMD_IR) not overloaded");
   }
 
+  SIMD_BaseMappedIntegrationRule & ElementTransformation ::
+  MapGeometry (const SIMD_IntegrationRule & ir, FlatArray<SIMD<double>> geometry, Allocator & lh) const
+  {
+    SIMD_BaseMappedIntegrationRule * mir = nullptr;
+    Switch<4> (ElementDim(), [&] (auto DIMS)
+    {
+      Switch<4> (SpaceDim(), [&] (auto DIMR)
+      {
+        if constexpr (DIMS.value <= DIMR.value)
+          mir = new (lh) SIMD_MappedIntegrationRule<DIMS.value,DIMR.value> (ir, *this, -1, lh);
+      });
+    });
+    if (!mir)
+      throw Exception ("MapGeometry: illegal element/space dimension");
+    if (geometry.Size() != ir.Size()*mir->GeometrySize())
+      throw Exception ("MapGeometry: geometry does not fit to integration rule");
+    mir->LoadGeometry (geometry);
+    return *mir;
+  }
+
   void ElementTransformation :: VCalcHesse (const SIMD<ngfem::IntegrationPoint> & ip, SIMD<double> * hesse) const
   {
     cout << "ElementTransformation::VCalcHesse not overloaded for " << typeid(*this).name() << endl;
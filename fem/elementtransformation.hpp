@@ -157,6 +157,10 @@ namespace ngfem
     /// return a mapped integration rule on localheap
     virtual SIMD_BaseMappedIntegrationRule & operator() (const SIMD_IntegrationRule & ir, Allocator & lh) const;
 
+    /// mapped integration rule from geometry stored by SIMD_BaseMappedIntegrationRule::StoreGeometry
+    SIMD_BaseMappedIntegrationRule & MapGeometry (const SIMD_IntegrationRule & ir,
+                                                  FlatArray<SIMD<double>> geometry, Allocator & lh) const;
+
     template <int DIMS, int DIMR> 
       void CalcHesse (const SIMD<ngfem::IntegrationPoint> & ip, Vec<DIMR, Mat<DIMS,DIMS,SIMD<double>>> & hesse) const
     {
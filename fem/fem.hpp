@@ -47,6 +47,8 @@ namespace ngfem
 #include "finiteelement.hpp"
 #include "scalarfe.hpp"
 #include "tscalarfe.hpp"
+#include "sumfactorization.hpp"
+#include "shapetable.hpp"
 
 #include "elementtransformation.hpp"
 
@@ -155,6 +155,47 @@ namespace ngfem
       return (ET == ET_SEGM) || (ET == ET_TRIG) || (ET == ET_QUAD)
         || (ET == ET_HEX) || (ET == ET_TET); 
     }
+
+    /// tensor product index and sign of the dofs (quads and hexes of uniform order)
+    bool GetTensorProductDofs (FlatArray<int> tpind, FlatArray<double> tpsign) const;
+
+    // sum factorization on tensor product integration rules,
+    // tabulated shapes on simplices of uniform order
+    using BASE::CalcShape;
+    using BASE::CalcMappedDShape;
+    using BASE::Evaluate;
+    using BASE::AddTrans;
+    using BASE::EvaluateGrad;
+    using BASE::AddGradTrans;
+
+    virtual void CalcShape (const SIMD_IntegrationRule & ir,
+                            BareSliceMatrix<SIMD<double>> shape) const override;
+    virtual void CalcMappedDShape (const SIMD_BaseMappedIntegrationRule & mir,
+                                   BareSliceMatrix<SIMD<double>> dshapes) const override;
+
+    virtual void Evaluate (const SIMD_IntegrationRule & ir,
+                           BareSliceVector<> coefs,
+                           BareVector<SIMD<double>> values) const override;
+    virtual void AddTrans (const SIMD_IntegrationRule & ir,
+                           BareVector<SIMD<double>> values,
+                           BareSliceVector<> coefs) const override;
+    virtual void EvaluateGrad (const SIMD_BaseMappedIntegrationRule & ir,
+                               BareSliceVector<> coefs,
+                               BareSliceMatrix<SIMD<double>> values) const override;
+    virtual void AddGradTrans (const SIMD_BaseMappedIntegrationRule & ir,
+                               BareSliceMatrix<SIMD<double>> values,
+                               BareSliceVector<> coefs) const override;
+
+  protected:
+    /// all edges, faces and the cell have the element order
+    bool UniformOrder () const;
+    /// calls func with the evaluator for this element on ir, tables and dof maps are shared
+    template <typename FUNC>
+    bool SumFactorize (const SIMD_IntegrationRule & ir, FUNC func) const;
+    /// the vertex class fixes the orientation of all edges and faces only on simplices
+    static constexpr bool TABULATED = (ET == ET_SEGM || ET == ET_TRIG || ET == ET_TET);
+    /// shared table for this vertex class, order and rule, or nullptr
+    const ShapeTable<DIM> * GetShapeTable (const SIMD_IntegrationRule & ir) const;
   };
 
 }  
@@ -1047,6 +1047,295 @@ namespace ngfem
       }
   }
 
+  /* ******************** sum factorization ****************************** */
+  
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  bool H1HighOrderFE<ET,SHAPES,BASE> ::
+  GetTensorProductDofs (FlatArray<int> tpind, FlatArray<double> tpsign) const
+  {
+    if constexpr (ET == ET_QUAD || ET == ET_HEX)
+      {
+        if (!UniformOrder()) return false;
+
+        int p = order;
+        int n = p+1;
+        auto coord = [] (int v, int dir) { return int(ElementTopology::GetVertices(ET)[v][dir]); };
+        auto parity = [] (int k) { return (k % 2) ? -1.0 : 1.0; };
+        int ii = 0;
+        auto set = [&] (int (&ind)[DIM], double sign)
+          {
+            int index = 0;
+            for (int d = 0; d < DIM; d++)
+              index = index*n + ind[d];
+            tpind[ii] = index;
+            tpsign[ii] = sign;
+            ii++;
+          };
+        
+        for (int v = 0; v < N_VERTEX; v++)
+          {
+            int ind[DIM];
+            for (int d = 0; d < DIM; d++) ind[d] = coord(v,d);
+            set (ind, 1);
+          }
+
+        // edge coordinate xi = +-(2t-1), edge polynomials have parity (-1)^k
+        for (int i = 0; i < N_EDGE; i++)
+          {
+            INT<2> e = this->GetVertexOrientedEdge(i);
+            int dir = 0;
+            for (int d = 0; d < DIM; d++)
+              if (coord(e[0],d) != coord(e[1],d)) dir = d;
+            for (int k = 0; k < p-1; k++)
+              {
+                int ind[DIM];
+                for (int d = 0; d < DIM; d++) ind[d] = coord(e[0],d);
+                ind[dir] = k+2;
+                set (ind, coord(e[1],dir) ? 1 : parity(k));
+              }
+          }
+
+        for (int i = 0; i < N_FACE; i++)
+          {
+            INT<4> f = this->GetVertexOrientedFace(i);
+            int dirx = 0, diry = 0;
+            for (int d = 0; d < DIM; d++)
+              {
+                if (coord(f[0],d) != coord(f[1],d)) dirx = d;
+                if (coord(f[0],d) != coord(f[3],d)) diry = d;
+              }
+            for (int k = 0; k < p-1; k++)
+              for (int j = 0; j < p-1; j++)
+                {
+                  int ind[DIM];
+                  for (int d = 0; d < DIM; d++) ind[d] = coord(f[0],d);
+                  ind[dirx] = k+2;
+                  ind[diry] = j+2;
+                  set (ind, (coord(f[0],dirx) ? 1 : parity(k)) * (coord(f[0],diry) ? 1 : parity(j)));
+                }
+          }
+        
+        if constexpr (ET == ET_HEX)
+          for (int i = 0; i < p-1; i++)
+            for (int j = 0; j < p-1; j++)
+              for (int k = 0; k < p-1; k++)
+                {
+                  int ind[DIM] = { i+2, j+2, k+2 };
+                  set (ind, 1);
+                }
+        return ii == ndof;
+      }
+    return false;
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  bool H1HighOrderFE<ET,SHAPES,BASE> :: UniformOrder () const
+  {
+    for (int i = 0; i < N_EDGE; i++)
+      if (order_edge[i] != order) return false;
+    for (int i = 0; i < N_FACE; i++)
+      if (order_face[i][0] != order || order_face[i][1] != order) return false;
+    if constexpr (DIM == 3)
+      if (order_cell[0][0] != order || order_cell[0][1] != order || order_cell[0][2] != order)
+        return false;
+    return true;
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  template <typename FUNC>
+  bool H1HighOrderFE<ET,SHAPES,BASE> ::
+  SumFactorize (const SIMD_IntegrationRule & ir, FUNC func) const
+  {
+    if constexpr (ET == ET_QUAD || ET == ET_HEX)
+      {
+        if (order < 2 || !UniformOrder()) return false;
+        auto tables = SumFactorizationTables<DIM>::Get (order, ir);
+        if (!tables) return false;
+
+        // edges and faces are oriented by the ordering of the vertex numbers
+        size_t perm = 0;
+        for (int i = 0; i < N_VERTEX; i++)
+          {
+            int smaller = 0;
+            for (int j = i+1; j < N_VERTEX; j++)
+              if (vnums[j] < vnums[i]) smaller++;
+            perm = perm * (N_VERTEX-i) + smaller;
+          }
+
+        static SumFactorizationCache<TensorProductDofs> dofmaps;
+        auto & dofs = dofmaps.Get ( (perm << 16) + order, [&] ()
+          {
+            TensorProductDofs dofs;
+            dofs.tpind.SetSize (ndof);
+            dofs.tpsign.SetSize (ndof);
+            dofs.valid = GetTensorProductDofs (dofs.tpind, dofs.tpsign);
+            return dofs;
+          });
+        if (!dofs.valid) return false;
+
+        STACK_ARRAY(double, work, SumFactorizationTP<DIM>::WorkSize (*tables));
+        SumFactorizationTP<DIM> sf(*tables, dofs, work);
+        func (sf);
+        return true;
+      }
+    return false;
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  const ShapeTable<ET_trait<ET>::DIM> * H1HighOrderFE<ET,SHAPES,BASE> ::
+  GetShapeTable (const SIMD_IntegrationRule & ir) const
+  {
+    if constexpr (TABULATED)
+      {
+        if (order < 2 || nodalp2 || ir.SelectId() < 0) return nullptr;
+        for (int i = 0; i < N_EDGE; i++)
+          if (order_edge[i] != order) return nullptr;
+        for (int i = 0; i < N_FACE; i++)
+          if (order_face[i][0] != order) return nullptr;
+        if constexpr (DIM == 3)
+          if (order_cell[0][0] != order) return nullptr;
+
+        static ShapeTableContainer<DIM> tables;
+        return tables.Get (ET_trait<ET>::GetClassNr (this->vnums), *this, ir);
+      }
+    return nullptr;
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> ::
+  CalcShape (const SIMD_IntegrationRule & ir,
+             BareSliceMatrix<SIMD<double>> shape) const
+  {
+    if constexpr (TABULATED)
+      if (auto table = GetShapeTable (ir))
+        {
+          table->CalcShape (shape);
+          return;
+        }
+    BASE::CalcShape (ir, shape);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> ::
+  CalcMappedDShape (const SIMD_BaseMappedIntegrationRule & mir,
+                    BareSliceMatrix<SIMD<double>> dshapes) const
+  {
+    if constexpr (TABULATED)
+      if (mir.DimSpace() == DIM)
+        if (auto table = GetShapeTable (mir.IR()))
+          {
+            table->CalcMappedDShape (mir, dshapes);
+            return;
+          }
+    BASE::CalcMappedDShape (mir, dshapes);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> ::
+  Evaluate (const SIMD_IntegrationRule & ir,
+            BareSliceVector<> coefs,
+            BareVector<SIMD<double>> values) const
+  {
+    if (SumFactorize (ir, [&] (auto & sf)
+                      {
+                        sf.Evaluate (coefs, FlatVector<> (sf.GetNIP(), (double*)&values(0)));
+                      }))
+      return;
+    if constexpr (TABULATED)
+      if (auto table = GetShapeTable (ir))
+        {
+          table->Evaluate (coefs, values);
+          return;
+        }
+    BASE::Evaluate (ir, coefs, values);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> ::
+  AddTrans (const SIMD_IntegrationRule & ir,
+            BareVector<SIMD<double>> values,
+            BareSliceVector<> coefs) const
+  {
+    if (SumFactorize (ir, [&] (auto & sf)
+                      {
+                        sf.AddTrans (FlatVector<> (sf.GetNIP(), (double*)&values(0)), coefs);
+                      }))
+      return;
+    if constexpr (TABULATED)
+      if (auto table = GetShapeTable (ir))
+        {
+          table->AddTrans (values, coefs);
+          return;
+        }
+    BASE::AddTrans (ir, values, coefs);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> ::
+  EvaluateGrad (const SIMD_BaseMappedIntegrationRule & bmir,
+                BareSliceVector<> coefs,
+                BareSliceMatrix<SIMD<double>> values) const
+  {
+    if constexpr (DIM > 0)
+      if (bmir.DimSpace() == DIM &&
+          SumFactorize (bmir.IR(), [&] (auto & sf)
+                        {
+                          auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+                          size_t nsimd = mir.Size();
+                          STACK_ARRAY(SIMD<double>, mem, DIM*nsimd);
+                          FlatMatrix<SIMD<double>> refgrad(DIM, nsimd, mem);
+                          sf.EvaluateGrad (coefs, SliceMatrix<> (DIM, sf.GetNIP(), nsimd*SIMD<double>::Size(),
+                                                                 (double*)mem));
+                          for (size_t i = 0; i < nsimd; i++)
+                            {
+                              Vec<DIM,SIMD<double>> grad = refgrad.Col(i);
+                              values.Col(i).Range(DIM) = Trans(mir[i].GetJacobianInverse()) * grad;
+                            }
+                        }))
+        return;
+    if constexpr (TABULATED)
+      if (bmir.DimSpace() == DIM)
+        if (auto table = GetShapeTable (bmir.IR()))
+          {
+            table->EvaluateGrad (bmir, coefs, values);
+            return;
+          }
+    BASE::EvaluateGrad (bmir, coefs, values);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void H1HighOrderFE<ET,SHAPES,BASE> ::
+  AddGradTrans (const SIMD_BaseMappedIntegrationRule & bmir,
+                BareSliceMatrix<SIMD<double>> values,
+                BareSliceVector<> coefs) const
+  {
+    if constexpr (DIM > 0)
+      if (bmir.DimSpace() == DIM &&
+          SumFactorize (bmir.IR(), [&] (auto & sf)
+                        {
+                          auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+                          size_t nsimd = mir.Size();
+                          STACK_ARRAY(SIMD<double>, mem, DIM*nsimd);
+                          FlatMatrix<SIMD<double>> refvalues(DIM, nsimd, mem);
+                          for (size_t i = 0; i < nsimd; i++)
+                            {
+                              Vec<DIM,SIMD<double>> vali = values.Col(i).Range(DIM);
+                              refvalues.Col(i) = mir[i].GetJacobianInverse() * vali;
+                            }
+                          sf.AddGradTrans (SliceMatrix<> (DIM, sf.GetNIP(), nsimd*SIMD<double>::Size(),
+                                                          (double*)mem), coefs);
+                        }))
+        return;
+    if constexpr (TABULATED)
+      if (bmir.DimSpace() == DIM)
+        if (auto table = GetShapeTable (bmir.IR()))
+          {
+            table->AddGradTrans (bmir, values, coefs);
+            return;
+          }
+    BASE::AddGradTrans (bmir, values, coefs);
+  }
+
 }
 
 #endif
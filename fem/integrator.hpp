@@ -61,6 +61,7 @@ namespace ngfem
     mutable bool simd_evaluate = true;
 
     shared_ptr<ngcomp::GridFunction> deformation; // ALE for this integrator
+    size_t deformation_version = 0;  // counts SetDeformation calls
     
   protected:
     void DeleteCurveIPs ( void );
@@ -258,8 +259,10 @@ namespace ngfem
     bool SimdEvaluate () const { return simd_evaluate; }
     void SetSimdEvaluate (bool b = true) { simd_evaluate = b; }
 
-    void SetDeformation (shared_ptr<ngcomp::GridFunction> adeform) { deformation = adeform; } 
+    void SetDeformation (shared_ptr<ngcomp::GridFunction> adeform)
+    { deformation = adeform; deformation_version++; } 
     const shared_ptr<ngcomp::GridFunction> & GetDeformation() const { return deformation; }
+    size_t GetDeformationVersion() const { return deformation_version; }
   };
 
 
@@ -440,6 +443,12 @@ namespace ngfem
     PrecomputeData (const FiniteElement & fel, 
 		    const ElementTransformation & eltrans, 
 		    LocalHeap & lh) const { return 0; }
+
+    /// release data returned by PrecomputeData
+    virtual void DeletePrecomputedData (void * data) const { ; }
+
+    /// values of parameters the precomputed data depends on
+    virtual void GetPrecomputeDependencies (Array<double> & values) const { ; }
   
 
     virtual void 
@@ -798,6 +807,41 @@ namespace ngfem
       throw Exception ("FacetBilinearFormIntegrator::ApplyFacetMatrix for inner facets not implemented!");
     }
 
+    /// data for repeated ApplyFacetMatrix on an inner facet, released by DeletePrecomputedData
+    virtual void *
+      PrecomputeFacetData (const FiniteElement & volumefel1, int LocalFacetNr1,
+                           const ElementTransformation & eltrans1, FlatArray<int> & ElVertices1,
+                           const FiniteElement & volumefel2, int LocalFacetNr2,
+                           const ElementTransformation & eltrans2, FlatArray<int> & ElVertices2,
+                           LocalHeap & lh) const
+    {
+      return nullptr;
+    }
+
+    /// apply using data from PrecomputeFacetData (may be nullptr)
+    virtual void
+      ApplyFacetMatrix (const FiniteElement & volumefel1, int LocalFacetNr1,
+                        const ElementTransformation & eltrans1, FlatArray<int> & ElVertices1,
+                        const FiniteElement & volumefel2, int LocalFacetNr2,
+                        const ElementTransformation & eltrans2, FlatArray<int> & ElVertices2,
+                        FlatVector<double> elx, FlatVector<double> ely,
+                        const void * precomputed, LocalHeap & lh) const
+    {
+      ApplyFacetMatrix (volumefel1, LocalFacetNr1, eltrans1, ElVertices1,
+                        volumefel2, LocalFacetNr2, eltrans2, ElVertices2, elx, ely, lh);
+    }
+    virtual void
+      ApplyFacetMatrix (const FiniteElement & volumefel1, int LocalFacetNr1,
+                        const ElementTransformation & eltrans1, FlatArray<int> & ElVertices1,
+                        const FiniteElement & volumefel2, int LocalFacetNr2,
+                        const ElementTransformation & eltrans2, FlatArray<int> & ElVertices2,
+                        FlatVector<Complex> elx, FlatVector<Complex> ely,
+                        const void * precomputed, LocalHeap & lh) const
+    {
+      ApplyFacetMatrix (volumefel1, LocalFacetNr1, eltrans1, ElVertices1,
+                        volumefel2, LocalFacetNr2, eltrans2, ElVertices2, elx, ely, lh);
+    }
+
 
     virtual void
     CalcFacetMatrix (const FiniteElement & volumefel, int LocalFacetNr,
@@ -3230,6 +3230,7 @@ namespace ngfem
           {
             IntegrationRule ir(eltype, order);
             auto tmp = new SIMD_IntegrationRule(ir);
+            tmp->SetSelectId (int(eltype) + 100*order);
             switch (eltype)
               {
               case ET_SEGM:
@@ -3491,6 +3492,43 @@ namespace ngfem
       }
   }
 
+
+  template <int DIM_ELEMENT, int DIM_SPACE>
+  void SIMD_MappedIntegrationRule<DIM_ELEMENT,DIM_SPACE> ::
+  StoreGeometry (FlatArray<SIMD<double>> data) const
+  {
+    size_t gs = GeometrySize();
+    for (size_t i = 0; i < mips.Size(); i++)
+      {
+        auto di = data.Range(i*gs, (i+1)*gs);
+        for (int j = 0; j < DIM_SPACE; j++)
+          di[j] = mips[i].GetPoint()(j);
+        for (int j = 0; j < DIM_SPACE; j++)
+          for (int k = 0; k < DIM_ELEMENT; k++)
+            di[DIM_SPACE+j*DIM_ELEMENT+k] = mips[i].GetJacobian()(j,k);
+      }
+  }
+
+  template <int DIM_ELEMENT, int DIM_SPACE>
+  void SIMD_MappedIntegrationRule<DIM_ELEMENT,DIM_SPACE> ::
+  LoadGeometry (FlatArray<SIMD<double>> data)
+  {
+    size_t gs = GeometrySize();
+    for (size_t i = 0; i < mips.Size(); i++)
+      {
+        auto di = data.Range(i*gs, (i+1)*gs);
+        for (int j = 0; j < DIM_SPACE; j++)
+          mips[i].Point()(j) = di[j];
+        for (int j = 0; j < DIM_SPACE; j++)
+          for (int k = 0; k < DIM_ELEMENT; k++)
+            mips[i].Jacobian()(j,k) = di[DIM_SPACE+j*DIM_ELEMENT+k];
+        mips[i].Compute();
+      }
+
+    if (ir.Size())
+      if (ir[0].VB() != VOL)
+        ComputeNormalsAndMeasure (eltrans.GetElementType(), ir[0].FacetNr());
+  }
   
   
   template class SIMD_MappedIntegrationRule<0,0>;
@@ -3631,6 +3669,22 @@ namespace ngfem
         hirvol[i].Weight() = hirfacet[i].Weight();
       }
 
+    // the points are fixed by the facet rule and the local vertices the facet
+    // is mapped to, tabulated trace shapes are shared by all facets of this kind
+    if (irfacet.SelectId() >= 0)
+      {
+        int verts = 0;
+        switch (FacetType(fnr))
+          {
+          case ET_POINT: verts = fnr; break;
+          case ET_SEGM:  verts = edges[fnr][0] + 8*edges[fnr][1]; break;
+          case ET_TRIG:  verts = faces[fnr][0] + 8*faces[fnr][1] + 64*faces[fnr][2]; break;
+          case ET_QUAD:  verts = faces[fnr][0] + 8*faces[fnr][1] + 64*faces[fnr][3]; break;
+          default: ;
+          }
+        irvol.SetSelectId ( (1 << 28) + 512*irfacet.SelectId() + verts);
+      }
+
 
     // tensor-product
     switch (eltype)
@@ -2323,6 +2323,7 @@ namespace ngfem
     int dimension = -1;
     size_t nip = -47;
     const SIMD_IntegrationRule *irx = nullptr, *iry = nullptr, *irz = nullptr; // for tensor product IR
+    int select_id = -1;  // identifies rules from SIMD_SelectIntegrationRule and their facet maps, -1 otherwise
   public:
     SIMD_IntegrationRule () = default;
     inline SIMD_IntegrationRule (ELEMENT_TYPE eltype, int order);
@@ -2354,6 +2355,7 @@ namespace ngfem
       ir2.irx = irx;
       ir2.iry = iry;
       ir2.irz = irz;
+      ir2.select_id = select_id;
       return ir2;
     }
 
@@ -2366,6 +2368,10 @@ namespace ngfem
     void SetIRX(const SIMD_IntegrationRule * ir) { irx = ir; }
     void SetIRY(const SIMD_IntegrationRule * ir) { iry = ir; }
     void SetIRZ(const SIMD_IntegrationRule * ir) { irz = ir; }
+
+    /// same id means same points, used as key for tabulated shape functions
+    int SelectId() const { return select_id; }
+    void SetSelectId(int id) { select_id = id; }
   };
 
   extern NGS_DLL_HEADER const SIMD_IntegrationRule & SIMD_SelectIntegrationRule (ELEMENT_TYPE eltype, int order);
@@ -2381,6 +2387,7 @@ namespace ngfem
     irx = ir.irx;
     iry = ir.iry;
     irz = ir.irz;
+    select_id = ir.select_id;
   }
 
 
@@ -2409,6 +2416,7 @@ namespace ngfem
       ir.SetIRY(&air.GetIRY());
       ir.SetIRZ(&air.GetIRZ());
       ir.SetNIP(air.GetNIP());
+      ir.SetSelectId(air.SelectId());
     }
     ~SIMD_BaseMappedIntegrationRule ()
       { ir.NothingToDelete(); }
@@ -2435,6 +2443,11 @@ namespace ngfem
 
     virtual void TransformGradient (BareSliceMatrix<SIMD<double>> grad) const = 0; // covariant transformation
     virtual void TransformGradientTrans (BareSliceMatrix<SIMD<double>> grad) const = 0; // covariant transformation transpose
+
+    // points and Jacobians, to restore the rule without evaluating the element mapping
+    virtual size_t GeometrySize () const = 0;   // per integration point
+    virtual void StoreGeometry (FlatArray<SIMD<double>> data) const = 0;
+    virtual void LoadGeometry (FlatArray<SIMD<double>> data) = 0;
   };
 
   inline ostream & operator<< (ostream & ost, const SIMD_BaseMappedIntegrationRule & mir)
@@ -2491,6 +2504,10 @@ namespace ngfem
 
     virtual void TransformGradient (BareSliceMatrix<SIMD<double>> grad) const override;
     virtual void TransformGradientTrans (BareSliceMatrix<SIMD<double>> grad) const override;
+
+    virtual size_t GeometrySize () const override { return DIM_SPACE*(DIM_ELEMENT+1); }
+    virtual void StoreGeometry (FlatArray<SIMD<double>> data) const override;
+    virtual void LoadGeometry (FlatArray<SIMD<double>> data) override;
   };
 }
 
@@ -121,6 +121,18 @@ namespace ngfem
     NGS_DLL_HEADER virtual void PrecomputeGrad () override;
     NGS_DLL_HEADER virtual void PrecomputeShapes (const IntegrationRule & ir) override;
 
+    // tabulated shapes on simplices for simd integration rules
+    using BASE::CalcShape;
+    using BASE::CalcMappedDShape;
+    using BASE::AddTrans;
+    using BASE::AddGradTrans;
+    NGS_DLL_HEADER virtual void CalcShape (const SIMD_IntegrationRule & ir, BareSliceMatrix<SIMD<double>> shape) const override;
+    NGS_DLL_HEADER virtual void CalcMappedDShape (const SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<SIMD<double>> dshapes) const override;
+    NGS_DLL_HEADER virtual void Evaluate (const SIMD_IntegrationRule & ir, BareSliceVector<> coefs, BareVector<SIMD<double>> values) const override;
+    NGS_DLL_HEADER virtual void AddTrans (const SIMD_IntegrationRule & ir, BareVector<SIMD<double>> values, BareSliceVector<> coefs) const override;
+    NGS_DLL_HEADER virtual void EvaluateGrad (const SIMD_BaseMappedIntegrationRule & mir, BareSliceVector<> coefs, BareSliceMatrix<SIMD<double>> values) const override;
+    NGS_DLL_HEADER virtual void AddGradTrans (const SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<SIMD<double>> values, BareSliceVector<> coefs) const override;
+
     using BASE::Evaluate;
     HD NGS_DLL_HEADER virtual void Evaluate (const IntegrationRule & ir, BareSliceVector<double> coefs, FlatVector<double> vals) const;
     HD NGS_DLL_HEADER virtual void EvaluateTrans (const IntegrationRule & ir, FlatVector<> values, BareSliceVector<> coefs) const override;
@@ -145,6 +157,12 @@ namespace ngfem
       for (auto & d : diag) d = 1.0/d;
       return true;
     }
+
+  protected:
+    /// the vertex class fixes the shape functions only on simplices
+    static constexpr bool TABULATED = (ET == ET_SEGM || ET == ET_TRIG || ET == ET_TET);
+    /// shared table for this vertex class, order and rule, or nullptr
+    const ShapeTable<ET_trait<ET>::DIM> * GetShapeTable (const SIMD_IntegrationRule & ir) const;
   };
 
 }
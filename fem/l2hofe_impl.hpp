@@ -246,6 +246,101 @@ namespace ngfem
     }
 
 
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  const ShapeTable<ET_trait<ET>::DIM> * L2HighOrderFE<ET,SHAPES,BASE> ::
+  GetShapeTable (const SIMD_IntegrationRule & ir) const
+  {
+    if constexpr (TABULATED)
+      {
+        if (order < 2 || ndof != PolDimension (order) || ir.SelectId() < 0) return nullptr;
+        static ShapeTableContainer<DIM> tables;
+        return tables.Get (ET_trait<ET>::GetClassNr (vnums), *this, ir);
+      }
+    return nullptr;
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void L2HighOrderFE<ET,SHAPES,BASE> ::
+  CalcShape (const SIMD_IntegrationRule & ir, BareSliceMatrix<SIMD<double>> shape) const
+  {
+    if constexpr (TABULATED)
+      if (auto table = GetShapeTable (ir))
+        {
+          table->CalcShape (shape);
+          return;
+        }
+    BASE::CalcShape (ir, shape);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void L2HighOrderFE<ET,SHAPES,BASE> ::
+  CalcMappedDShape (const SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<SIMD<double>> dshapes) const
+  {
+    if constexpr (TABULATED)
+      if (mir.DimSpace() == DIM)
+        if (auto table = GetShapeTable (mir.IR()))
+          {
+            table->CalcMappedDShape (mir, dshapes);
+            return;
+          }
+    BASE::CalcMappedDShape (mir, dshapes);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void L2HighOrderFE<ET,SHAPES,BASE> ::
+  Evaluate (const SIMD_IntegrationRule & ir, BareSliceVector<> coefs, BareVector<SIMD<double>> values) const
+  {
+    if constexpr (TABULATED)
+      if (auto table = GetShapeTable (ir))
+        {
+          table->Evaluate (coefs, values);
+          return;
+        }
+    BASE::Evaluate (ir, coefs, values);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void L2HighOrderFE<ET,SHAPES,BASE> ::
+  AddTrans (const SIMD_IntegrationRule & ir, BareVector<SIMD<double>> values, BareSliceVector<> coefs) const
+  {
+    if constexpr (TABULATED)
+      if (auto table = GetShapeTable (ir))
+        {
+          table->AddTrans (values, coefs);
+          return;
+        }
+    BASE::AddTrans (ir, values, coefs);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void L2HighOrderFE<ET,SHAPES,BASE> ::
+  EvaluateGrad (const SIMD_BaseMappedIntegrationRule & mir, BareSliceVector<> coefs, BareSliceMatrix<SIMD<double>> values) const
+  {
+    if constexpr (TABULATED)
+      if (mir.DimSpace() == DIM)
+        if (auto table = GetShapeTable (mir.IR()))
+          {
+            table->EvaluateGrad (mir, coefs, values);
+            return;
+          }
+    BASE::EvaluateGrad (mir, coefs, values);
+  }
+
+  template <ELEMENT_TYPE ET, class SHAPES, class BASE>
+  void L2HighOrderFE<ET,SHAPES,BASE> ::
+  AddGradTrans (const SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<SIMD<double>> values, BareSliceVector<> coefs) const
+  {
+    if constexpr (TABULATED)
+      if (mir.DimSpace() == DIM)
+        if (auto table = GetShapeTable (mir.IR()))
+          {
+            table->AddGradTrans (mir, values, coefs);
+            return;
+          }
+    BASE::AddGradTrans (mir, values, coefs);
+  }
+
+
   template <ELEMENT_TYPE ET, class SHAPES, class BASE>
   void L2HighOrderFE<ET,SHAPES,BASE> :: 
   GetDiagMassMatrix (FlatVector<> mass) const
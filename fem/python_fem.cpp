@@ -1948,6 +1948,9 @@ z : double
 
   py::implicitly_convertible <BaseScalarFiniteElement, FiniteElement >(); 
 
+  m.def("NumShapeTables", &NumShapeTables,
+        "number of shape tables built so far, they are shared by all elements of a class and all forms");
+
   m.def("H1FE", [](ELEMENT_TYPE et, int order)
         {
           SwitchET (et, [order] (auto et2) -> shared_ptr<BaseScalarFiniteElement>
@@ -2810,9 +2813,9 @@ alpha : double
           shared_ptr<CoefficientFunction> trafo;
           try { trafo = MakeCoefficient(trafocf); }
           catch(...) { trafo=nullptr; }
-          Array<string> allowed_types = { "float64", "complex128" };
+          Array<string> allowed_types = { "float64", "float32", "complex128" };
           if(!allowed_types.Contains(py::cast<string>(values.dtype().attr("name"))))
-            throw Exception("Only float64 and complex128 dtype arrays allowed!");
+            throw Exception("Only float64, float32 and complex128 dtype arrays allowed!");
           Array<double> start, end;
           Array<size_t> dim_vals;
           for(auto val : pystart)
@@ -2831,6 +2834,15 @@ alpha : double
               return make_shared<VoxelCoefficientFunction<Complex>>
                 (start, end, dim_vals, move(vals), linear, trafo);
             }
+          if(py::cast<string>(values.dtype().attr("name")) == "float32")
+            {
+              auto f_array = py::cast<py::array_t<float>>(values.attr("ravel")());
+              Array<float> vals(f_array.size());
+              for(auto i : Range(vals))
+                vals[i] = f_array.at(i);
+              return make_shared<VoxelCoefficientFunction<double, float>>
+                (start, end, dim_vals, move(vals), linear, trafo);
+            }
           auto d_array = py::cast<py::array_t<double>>(values.attr("ravel")());
           Array<double> vals(values.size());
           for(auto i : Range(vals))
@@ -2845,6 +2857,8 @@ x1y1z1, x2y1z1, ..., xNy1z1, x1y2z1, ...
 
 If linear is True the function will be interpolated linearly between the values. Otherwise the nearest voxel value is taken.
 
+Values given as float32 array are stored in single precision, which halves the memory (traffic) for large grids.
+
 )delimiter");
 
       const string header = R"CODE(
@@ -2882,6 +2896,15 @@ extern "C" void init_function_name(pybind11::object & res);
 add_header (default = True): wrap the code snippet with the template
 )raw_string" + header + footer;
 
+  m.def("SetCompileCacheDirectory",
+        [](string dir) { compile_cache_dir = dir; },
+        py::arg("directory"),
+        R"raw_string(
+Directory for caching compiled CoefficientFunctions and modules.
+Identical generated code is loaded from the cache instead of being compiled again.
+An empty string disables the cache. Default is the environment variable NGSOLVE_COMPILE_CACHE.
+)raw_string");
+
   m.def("CompilePythonModule",
        [header, footer](string code, string init_function_name, bool add_header)
        {
@@ -0,0 +1,186 @@
+/*********************************************************************/
+/* File:   shapetable.cpp                                            */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+#include <fem.hpp>
+
+namespace ngfem
+{
+
+  template <int DIM>
+  ShapeTable<DIM> :: ShapeTable (const ScalarFiniteElement<DIM> & fel, const SIMD_IntegrationRule & ir)
+    : ndof(fel.GetNDof()), nip(ir.Size()*SIMD<double>::Size()),
+      shapes(ndof, nip), dshapes(DIM*ndof, nip)
+  {
+    constexpr size_t SW = SIMD<double>::Size();
+    Vector<> shape(ndof);
+    Matrix<> dshape(ndof, DIM);
+    for (size_t i = 0; i < nip; i++)
+      {
+        IntegrationPoint ip;
+        for (int k = 0; k < DIM; k++)
+          ip(k) = ir[i/SW](k)[i%SW];
+
+        fel.CalcShape (ip, shape);
+        fel.CalcDShape (ip, dshape);
+        shapes.Col(i) = shape;
+        for (int k = 0; k < DIM; k++)
+          dshapes.Col(i).Range(k*ndof, (k+1)*ndof) = dshape.Col(k);
+      }
+  }
+
+  template <int DIM>
+  void ShapeTable<DIM> :: CalcShape (BareSliceMatrix<SIMD<double>> shape) const
+  {
+    constexpr size_t SW = SIMD<double>::Size();
+    for (size_t j = 0; j < ndof; j++)
+      for (size_t i = 0; i < nip/SW; i++)
+        shape(j,i) = SIMD<double> (&shapes(j, i*SW));
+  }
+
+  template <int DIM>
+  void ShapeTable<DIM> ::
+  CalcMappedDShape (const SIMD_BaseMappedIntegrationRule & bmir,
+                    BareSliceMatrix<SIMD<double>> mdshapes) const
+  {
+    constexpr size_t SW = SIMD<double>::Size();
+    auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+    for (size_t i = 0; i < mir.Size(); i++)
+      {
+        Mat<DIM,DIM,SIMD<double>> jacinv = mir[i].GetJacobianInverse();
+        for (size_t j = 0; j < ndof; j++)
+          {
+            Vec<DIM,SIMD<double>> refgrad;
+            for (int k = 0; k < DIM; k++)
+              refgrad(k) = SIMD<double> (&dshapes(k*ndof+j, i*SW));
+            Vec<DIM,SIMD<double>> grad = Trans(jacinv) * refgrad;
+            for (int k = 0; k < DIM; k++)
+              mdshapes(DIM*j+k, i) = grad(k);
+          }
+      }
+  }
+
+  template <int DIM>
+  void ShapeTable<DIM> ::
+  Evaluate (BareSliceVector<> coefs, BareVector<SIMD<double>> values) const
+  {
+    FlatVector<> (nip, (double*)&values(0)) = Trans(shapes) * coefs.Range(0, ndof);
+  }
+
+  template <int DIM>
+  void ShapeTable<DIM> ::
+  AddTrans (BareVector<SIMD<double>> values, BareSliceVector<> coefs) const
+  {
+    coefs.Range(0, ndof) += shapes * FlatVector<> (nip, (double*)&values(0));
+  }
+
+  template <int DIM>
+  void ShapeTable<DIM> ::
+  EvaluateGrad (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceVector<> coefs,
+                BareSliceMatrix<SIMD<double>> values) const
+  {
+    auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+    size_t nsimd = mir.Size();
+    STACK_ARRAY(SIMD<double>, mem, DIM*nsimd);
+    FlatMatrix<SIMD<double>> refgrad(DIM, nsimd, mem);
+    FlatMatrix<> drefgrad(DIM, nip, (double*)mem);
+    for (int k = 0; k < DIM; k++)
+      drefgrad.Row(k) = Trans(dshapes.Rows(k*ndof, (k+1)*ndof)) * coefs.Range(0, ndof);
+
+    for (size_t i = 0; i < nsimd; i++)
+      {
+        Vec<DIM,SIMD<double>> grad = refgrad.Col(i);
+        values.Col(i).Range(DIM) = Trans(mir[i].GetJacobianInverse()) * grad;
+      }
+  }
+
+  template <int DIM>
+  void ShapeTable<DIM> ::
+  AddGradTrans (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceMatrix<SIMD<double>> values,
+                BareSliceVector<> coefs) const
+  {
+    auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+    size_t nsimd = mir.Size();
+    STACK_ARRAY(SIMD<double>, mem, DIM*nsimd);
+    FlatMatrix<SIMD<double>> refvalues(DIM, nsimd, mem);
+    FlatMatrix<> drefvalues(DIM, nip, (double*)mem);
+    for (size_t i = 0; i < nsimd; i++)
+      {
+        Vec<DIM,SIMD<double>> vali = values.Col(i).Range(DIM);
+        refvalues.Col(i) = mir[i].GetJacobianInverse() * vali;
+      }
+    for (int k = 0; k < DIM; k++)
+      coefs.Range(0, ndof) += dshapes.Rows(k*ndof, (k+1)*ndof) * drefvalues.Row(k);
+  }
+
+
+
+  template <int DIM>
+  ShapeTableContainer<DIM> :: ShapeTableContainer ()
+  {
+    for (auto & b : buckets)
+      b = nullptr;
+  }
+
+  template <int DIM>
+  ShapeTableContainer<DIM> :: ~ShapeTableContainer ()
+  {
+    for (auto & b : buckets)
+      for (Entry * e = b.load(); e; )
+        {
+          Entry * next = e->next;
+          delete e->table;
+          delete e;
+          e = next;
+        }
+  }
+
+  static std::atomic<size_t> num_shape_tables{0};
+
+  template <int DIM>
+  const ShapeTable<DIM> * ShapeTableContainer<DIM> ::
+  Get (int classnr, const ScalarFiniteElement<DIM> & fel, const SIMD_IntegrationRule & ir)
+  {
+    int rule = ir.SelectId();
+    if (rule < 0) return nullptr;
+
+    // at most 2M doubles (16 MB) per table
+    size_t nip = ir.Size()*SIMD<double>::Size();
+    if ((DIM+1) * fel.GetNDof() * nip > (size_t(1) << 21)) return nullptr;
+
+    int order = fel.Order();
+    auto & bucket = buckets[(size_t(classnr) + 32*(size_t(order) + 64*size_t(rule))) % NBUCKETS];
+
+    auto find = [&] () -> ShapeTable<DIM> *
+      {
+        for (Entry * e = bucket.load(std::memory_order_acquire); e; e = e->next)
+          if (e->classnr == classnr && e->order == order && e->rule == rule)
+            return e->table;
+        return nullptr;
+      };
+
+    if (auto table = find()) return table;
+
+    lock_guard<mutex> guard(create_mutex);
+    if (auto table = find()) return table;
+
+    static Timer t("ShapeTable::Create"); RegionTimer reg(t);
+    auto table = new ShapeTable<DIM> (fel, ir);
+    bucket.store (new Entry { classnr, order, rule, table, bucket.load() }, std::memory_order_release);
+    num_shape_tables++;
+    return table;
+  }
+
+  size_t NumShapeTables ()
+  {
+    return num_shape_tables;
+  }
+
+  template class ShapeTable<1>;
+  template class ShapeTable<2>;
+  template class ShapeTable<3>;
+  template class ShapeTableContainer<1>;
+  template class ShapeTableContainer<2>;
+  template class ShapeTableContainer<3>;
+}
@@ -0,0 +1,88 @@
+#ifndef FILE_SHAPETABLE
+#define FILE_SHAPETABLE
+
+/*********************************************************************/
+/* File:   shapetable.hpp                                            */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+
+namespace ngfem
+{
+
+  /**
+     Tabulated shape functions of a scalar element on a simd integration
+     rule from SIMD_SelectIntegrationRule.
+
+     High order shapes depend on the global vertex numbers only through the
+     vertex class (ET_trait<ET>::GetClassNr), so one table for (element
+     class, order, vertex class, rule) serves all elements of this kind.
+     Reference derivatives are stored, mapped derivatives use the Jacobian
+     of the mapped rule.
+   */
+  template <int DIM>
+  class NGS_DLL_HEADER ShapeTable
+  {
+    size_t ndof, nip;   // nip including the padding of the last simd point
+    Matrix<> shapes;    // ndof x nip
+    Matrix<> dshapes;   // DIM*ndof x nip, derivative k of shape j in row k*ndof+j
+
+  public:
+    ShapeTable (const ScalarFiniteElement<DIM> & fel, const SIMD_IntegrationRule & ir);
+
+    size_t NDof() const { return ndof; }
+
+    void CalcShape (BareSliceMatrix<SIMD<double>> shape) const;
+    /// mir must be a SIMD_MappedIntegrationRule<DIM,DIM>
+    void CalcMappedDShape (const SIMD_BaseMappedIntegrationRule & mir,
+                           BareSliceMatrix<SIMD<double>> dshapes) const;
+
+    void Evaluate (BareSliceVector<> coefs, BareVector<SIMD<double>> values) const;
+    void AddTrans (BareVector<SIMD<double>> values, BareSliceVector<> coefs) const;
+    void EvaluateGrad (const SIMD_BaseMappedIntegrationRule & mir, BareSliceVector<> coefs,
+                       BareSliceMatrix<SIMD<double>> values) const;
+    void AddGradTrans (const SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<SIMD<double>> values,
+                       BareSliceVector<> coefs) const;
+  };
+
+
+  /**
+     The shape tables of one element class.
+
+     Tables are built on first use and kept until the end of the run.
+     Lookup does not lock, only building a new table does.
+   */
+  template <int DIM>
+  class NGS_DLL_HEADER ShapeTableContainer
+  {
+    struct Entry
+    {
+      int classnr, order, rule;
+      ShapeTable<DIM> * table;
+      Entry * next;
+    };
+    static constexpr int NBUCKETS = 256;
+    std::atomic<Entry*> buckets[NBUCKETS];
+    std::mutex create_mutex;
+
+  public:
+    ShapeTableContainer ();
+    ~ShapeTableContainer ();
+
+    /// table of fel on ir, nullptr if ir is not a select-rule or the table would be too large
+    const ShapeTable<DIM> * Get (int classnr, const ScalarFiniteElement<DIM> & fel,
+                                 const SIMD_IntegrationRule & ir);
+  };
+
+  /// number of shape tables built so far, in all containers
+  NGS_DLL_HEADER size_t NumShapeTables ();
+
+  extern template class ShapeTable<1>;
+  extern template class ShapeTable<2>;
+  extern template class ShapeTable<3>;
+  extern template class ShapeTableContainer<1>;
+  extern template class ShapeTableContainer<2>;
+  extern template class ShapeTableContainer<3>;
+}
+
+#endif
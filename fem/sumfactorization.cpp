@@ -0,0 +1,284 @@
+/*********************************************************************/
+/* File:   sumfactorization.cpp                                      */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+#include <fem.hpp>
+
+namespace ngfem
+{
+
+  static const SIMD_IntegrationRule & GetIR1D (const SIMD_IntegrationRule & ir, int dir)
+  {
+    switch (dir)
+      {
+      case 0: return ir.GetIRX();
+      case 1: return ir.GetIRY();
+      default: return ir.GetIRZ();
+      }
+  }
+
+  static inline double GetCoord (const SIMD_IntegrationRule & ir, size_t i, int dir)
+  {
+    constexpr size_t SW = SIMD<double>::Size();
+    return ir[i/SW](dir)[i%SW];
+  }
+
+
+  template <int DIM>
+  SumFactorizationTables<DIM> ::
+  SumFactorizationTables (int order, const SIMD_IntegrationRule & ir)
+    : n(order+1)
+  {
+    if (!ir.IsTP()) return;
+
+    size_t nip = 1;
+    for (int d = 0; d < DIM; d++)
+      {
+        nq[d] = GetIR1D(ir, d).GetNIP();
+        nip *= nq[d];
+      }
+    if (nip != ir.GetNIP()) return;
+
+    // the full rule must be the tensor product with x-index slowest
+    for (size_t i = 0; i < nip; i++)
+      {
+        size_t rest = i;
+        for (int d = DIM-1; d >= 0; d--)
+          {
+            size_t id = rest % nq[d];
+            rest /= nq[d];
+            if (fabs (GetCoord(ir, i, d) - GetCoord(GetIR1D(ir, d), id, 0)) > 1e-12)
+              return;
+          }
+      }
+
+    // 1D shape functions and derivatives
+    for (int d = 0; d < DIM; d++)
+      {
+        auto & ir1d = GetIR1D(ir, d);
+        shape[d].SetSize (nq[d], n);
+        dshape[d].SetSize (nq[d], n);
+        for (size_t q = 0; q < nq[d]; q++)
+          {
+            AutoDiff<1> t(GetCoord(ir1d, q, 0), 0);
+            AutoDiff<1> b[2] = { 1-t, t };
+            for (int k = 0; k < 2; k++)
+              {
+                shape[d](q,k) = b[k].Value();
+                dshape[d](q,k) = b[k].DValue(0);
+              }
+            if (order >= 2)
+              IntLegNoBubble::EvalMult (order-2, 2*t-1, t*(1-t),
+                                        SBLambda ([&] (size_t k, AutoDiff<1> val)
+                                                  {
+                                                    shape[d](q,k+2) = val.Value();
+                                                    dshape[d](q,k+2) = val.DValue(0);
+                                                  }));
+          }
+      }
+    valid = true;
+  }
+
+  template <int DIM>
+  const SumFactorizationTables<DIM> * SumFactorizationTables<DIM> ::
+  Get (int order, const SIMD_IntegrationRule & ir)
+  {
+    if (!ir.IsTP() || ir.SelectId() < 0) return nullptr;
+    static SumFactorizationCache<SumFactorizationTables<DIM>> tables;
+    auto & tab = tables.Get ( (size_t(ir.SelectId()) << 16) + order,
+                              [&] () { return SumFactorizationTables<DIM> (order, ir); });
+    return tab.valid ? &tab : nullptr;
+  }
+
+
+  template <int DIM>
+  size_t SumFactorizationTP<DIM> :: WorkSize (const SumFactorizationTables<DIM> & tables)
+  {
+    size_t n = tables.n;
+    auto & hnq = tables.nq;
+    if constexpr (DIM == 2)
+      return n*n + 2*n*hnq[1];
+    else
+      return n*n*n + 2*n*n*hnq[2] + 3*n*hnq[1]*hnq[2];
+  }
+
+
+  template <int DIM>
+  SumFactorizationTP<DIM> ::
+  SumFactorizationTP (const SumFactorizationTables<DIM> & tables, const TensorProductDofs & dofs,
+                      double * awork)
+    : n(tables.n), tpind(dofs.tpind), tpsign(dofs.tpsign), work(awork)
+  {
+    for (int d = 0; d < DIM; d++)
+      {
+        nq[d] = tables.nq[d];
+        shape[d].AssignMemory (nq[d], n, tables.shape[d].Data());
+        dshape[d].AssignMemory (nq[d], n, tables.dshape[d].Data());
+      }
+  }
+
+  template <int DIM>
+  size_t SumFactorizationTP<DIM> :: GetNIP() const
+  {
+    size_t nip = 1;
+    for (int d = 0; d < DIM; d++)
+      nip *= nq[d];
+    return nip;
+  }
+
+
+  template <int DIM>
+  void SumFactorizationTP<DIM> ::
+  Evaluate (BareSliceVector<> coefs, FlatVector<> values) const
+  {
+    double * pw = work;
+    if constexpr (DIM == 2)
+      {
+        FlatMatrix<> u(n, n, pw); pw += n*n;
+        FlatMatrix<> t1(n, nq[1], pw);
+        u = 0.0;
+        for (size_t i : Range(tpind))
+          u(tpind[i]) = tpsign[i] * coefs(i);
+        t1 = u * Trans(shape[1]);
+        FlatMatrix<> (nq[0], nq[1], values.Data()) = shape[0] * t1;
+      }
+    else
+      {
+        FlatMatrix<> u(n*n, n, pw); pw += n*n*n;
+        FlatMatrix<> t1(n*n, nq[2], pw); pw += 2*n*n*nq[2];
+        FlatMatrix<> t2(n, nq[1]*nq[2], pw);
+        u = 0.0;
+        for (size_t i : Range(tpind))
+          u(tpind[i]) = tpsign[i] * coefs(i);
+        t1 = u * Trans(shape[2]);
+        for (size_t a = 0; a < n; a++)
+          FlatMatrix<> (nq[1], nq[2], &t2(a,0)) = shape[1] * t1.Rows(a*n, (a+1)*n);
+        FlatMatrix<> (nq[0], nq[1]*nq[2], values.Data()) = shape[0] * t2;
+      }
+  }
+
+
+  template <int DIM>
+  void SumFactorizationTP<DIM> ::
+  AddTrans (FlatVector<> values, BareSliceVector<> coefs) const
+  {
+    double * pw = work;
+    if constexpr (DIM == 2)
+      {
+        FlatMatrix<> u(n, n, pw); pw += n*n;
+        FlatMatrix<> s1(n, nq[1], pw);
+        s1 = Trans(shape[0]) * FlatMatrix<> (nq[0], nq[1], values.Data());
+        u = s1 * shape[1];
+        for (size_t i : Range(tpind))
+          coefs(i) += tpsign[i] * u(tpind[i]);
+      }
+    else
+      {
+        FlatMatrix<> u(n*n, n, pw); pw += n*n*n;
+        FlatMatrix<> s1(n*n, nq[2], pw); pw += 2*n*n*nq[2];
+        FlatMatrix<> s2(n, nq[1]*nq[2], pw);
+        s2 = Trans(shape[0]) * FlatMatrix<> (nq[0], nq[1]*nq[2], values.Data());
+        for (size_t a = 0; a < n; a++)
+          s1.Rows(a*n, (a+1)*n) = Trans(shape[1]) * FlatMatrix<> (nq[1], nq[2], &s2(a,0));
+        u = s1 * shape[2];
+        for (size_t i : Range(tpind))
+          coefs(i) += tpsign[i] * u(tpind[i]);
+      }
+  }
+
+
+  template <int DIM>
+  void SumFactorizationTP<DIM> ::
+  EvaluateGrad (BareSliceVector<> coefs, SliceMatrix<> values) const
+  {
+    double * pw = work;
+    if constexpr (DIM == 2)
+      {
+        FlatMatrix<> u(n, n, pw); pw += n*n;
+        FlatMatrix<> t1(n, nq[1], pw); pw += n*nq[1];
+        FlatMatrix<> t1d(n, nq[1], pw);
+        u = 0.0;
+        for (size_t i : Range(tpind))
+          u(tpind[i]) = tpsign[i] * coefs(i);
+        t1 = u * Trans(shape[1]);
+        t1d = u * Trans(dshape[1]);
+        FlatMatrix<> (nq[0], nq[1], &values(0,0)) = dshape[0] * t1;
+        FlatMatrix<> (nq[0], nq[1], &values(1,0)) = shape[0] * t1d;
+      }
+    else
+      {
+        size_t nyz = nq[1]*nq[2];
+        FlatMatrix<> u(n*n, n, pw); pw += n*n*n;
+        FlatMatrix<> t1(n*n, nq[2], pw); pw += n*n*nq[2];
+        FlatMatrix<> t1d(n*n, nq[2], pw); pw += n*n*nq[2];
+        FlatMatrix<> t2(n, nyz, pw); pw += n*nyz;
+        FlatMatrix<> t2y(n, nyz, pw); pw += n*nyz;
+        FlatMatrix<> t2z(n, nyz, pw);
+        u = 0.0;
+        for (size_t i : Range(tpind))
+          u(tpind[i]) = tpsign[i] * coefs(i);
+        t1 = u * Trans(shape[2]);
+        t1d = u * Trans(dshape[2]);
+        for (size_t a = 0; a < n; a++)
+          {
+            FlatMatrix<> (nq[1], nq[2], &t2(a,0)) = shape[1] * t1.Rows(a*n, (a+1)*n);
+            FlatMatrix<> (nq[1], nq[2], &t2y(a,0)) = dshape[1] * t1.Rows(a*n, (a+1)*n);
+            FlatMatrix<> (nq[1], nq[2], &t2z(a,0)) = shape[1] * t1d.Rows(a*n, (a+1)*n);
+          }
+        FlatMatrix<> (nq[0], nyz, &values(0,0)) = dshape[0] * t2;
+        FlatMatrix<> (nq[0], nyz, &values(1,0)) = shape[0] * t2y;
+        FlatMatrix<> (nq[0], nyz, &values(2,0)) = shape[0] * t2z;
+      }
+  }
+
+
+  template <int DIM>
+  void SumFactorizationTP<DIM> ::
+  AddGradTrans (SliceMatrix<> values, BareSliceVector<> coefs) const
+  {
+    double * pw = work;
+    if constexpr (DIM == 2)
+      {
+        FlatMatrix<> u(n, n, pw); pw += n*n;
+        FlatMatrix<> s1(n, nq[1], pw); pw += n*nq[1];
+        FlatMatrix<> s1y(n, nq[1], pw);
+        s1 = Trans(dshape[0]) * FlatMatrix<> (nq[0], nq[1], &values(0,0));
+        s1y = Trans(shape[0]) * FlatMatrix<> (nq[0], nq[1], &values(1,0));
+        u = s1 * shape[1];
+        u += s1y * dshape[1];
+        for (size_t i : Range(tpind))
+          coefs(i) += tpsign[i] * u(tpind[i]);
+      }
+    else
+      {
+        size_t nyz = nq[1]*nq[2];
+        FlatMatrix<> u(n*n, n, pw); pw += n*n*n;
+        FlatMatrix<> q(n*n, nq[2], pw); pw += n*n*nq[2];
+        FlatMatrix<> r(n*n, nq[2], pw); pw += n*n*nq[2];
+        FlatMatrix<> s2x(n, nyz, pw); pw += n*nyz;
+        FlatMatrix<> s2y(n, nyz, pw); pw += n*nyz;
+        FlatMatrix<> s2z(n, nyz, pw);
+        s2x = Trans(dshape[0]) * FlatMatrix<> (nq[0], nyz, &values(0,0));
+        s2y = Trans(shape[0]) * FlatMatrix<> (nq[0], nyz, &values(1,0));
+        s2z = Trans(shape[0]) * FlatMatrix<> (nq[0], nyz, &values(2,0));
+        for (size_t a = 0; a < n; a++)
+          {
+            // x- and y-derivative terms both end with the z-shape
+            q.Rows(a*n, (a+1)*n) = Trans(shape[1]) * FlatMatrix<> (nq[1], nq[2], &s2x(a,0));
+            q.Rows(a*n, (a+1)*n) += Trans(dshape[1]) * FlatMatrix<> (nq[1], nq[2], &s2y(a,0));
+            r.Rows(a*n, (a+1)*n) = Trans(shape[1]) * FlatMatrix<> (nq[1], nq[2], &s2z(a,0));
+          }
+        u = q * shape[2];
+        u += r * dshape[2];
+        for (size_t i : Range(tpind))
+          coefs(i) += tpsign[i] * u(tpind[i]);
+      }
+  }
+
+
+  template class SumFactorizationTables<2>;
+  template class SumFactorizationTables<3>;
+  template class SumFactorizationTP<2>;
+  template class SumFactorizationTP<3>;
+}
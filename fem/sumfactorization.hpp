@@ -0,0 +1,153 @@
+#ifndef FILE_SUMFACTORIZATION
+#define FILE_SUMFACTORIZATION
+
+/*********************************************************************/
+/* File:   sumfactorization.hpp                                      */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+
+namespace ngfem
+{
+
+  /**
+     Lookup of data which is built once and kept until the end of the run.
+     Lookup does not lock, only building a new entry does.
+   */
+  template <typename T>
+  class SumFactorizationCache
+  {
+    struct Entry
+    {
+      size_t key;
+      T * data;
+      Entry * next;
+    };
+    static constexpr int NBUCKETS = 256;
+    std::atomic<Entry*> buckets[NBUCKETS];
+    std::mutex create_mutex;
+
+  public:
+    SumFactorizationCache ()
+    {
+      for (auto & b : buckets)
+        b = nullptr;
+    }
+
+    ~SumFactorizationCache ()
+    {
+      for (auto & b : buckets)
+        for (Entry * e = b.load(); e; )
+          {
+            Entry * next = e->next;
+            delete e->data;
+            delete e;
+            e = next;
+          }
+    }
+
+    /// the entry of key, built by create() on first use
+    template <typename FUNC>
+    const T & Get (size_t key, FUNC create)
+    {
+      auto & bucket = buckets[key % NBUCKETS];
+      auto find = [&] () -> T *
+        {
+          for (Entry * e = bucket.load(std::memory_order_acquire); e; e = e->next)
+            if (e->key == key)
+              return e->data;
+          return nullptr;
+        };
+
+      if (auto data = find()) return *data;
+
+      std::lock_guard<std::mutex> guard(create_mutex);
+      if (auto data = find()) return *data;
+
+      auto data = new T(create());
+      bucket.store (new Entry { key, data, bucket.load() }, std::memory_order_release);
+      return *data;
+    }
+  };
+
+
+  /**
+     1D shape functions of order p on the directions of a tensor product
+     integration rule. Tables of rules from SIMD_SelectIntegrationRule
+     (and their facet maps) are shared.
+   */
+  template <int DIM>
+  class NGS_DLL_HEADER SumFactorizationTables
+  {
+  public:
+    int n;                      // 1D basis size, order+1
+    size_t nq[DIM];             // number of points per direction
+    Matrix<> shape[DIM];        // nq[d] x n
+    Matrix<> dshape[DIM];       // nq[d] x n
+    bool valid = false;         // false if ir is not a matching tensor product rule
+
+    SumFactorizationTables (int order, const SIMD_IntegrationRule & ir);
+
+    /// shared tables, nullptr if ir is no selected tensor product rule
+    static const SumFactorizationTables * Get (int order, const SIMD_IntegrationRule & ir);
+  };
+
+
+  /**
+     Tensor index (x-index slowest) and sign of every dof. It depends on the
+     order and on the orientation of edges and faces, i.e. on the
+     permutation of the vertex numbers.
+   */
+  class TensorProductDofs
+  {
+  public:
+    Array<int> tpind;
+    Array<double> tpsign;
+    bool valid = false;
+  };
+
+
+  /**
+     Sum factorization for scalar tensor product bases on quads and hexes.
+
+     The 1D basis of order p is
+        b_0 = 1-t,  b_1 = t,  b_{k+2} = t(1-t) IntLegNoBubble_k(2t-1),
+     the element provides for every dof its tensor index (x-index slowest)
+     and a sign. Evaluation on a tensor product integration rule costs
+     O(p^{DIM+1}) instead of O(p^{2 DIM}).
+   */
+  template <int DIM>
+  class NGS_DLL_HEADER SumFactorizationTP
+  {
+    int n;                      // 1D basis size, order+1
+    FlatArray<int> tpind;       // dof -> tensor index
+    FlatArray<double> tpsign;   // dof -> sign
+    size_t nq[DIM];             // number of points per direction
+    FlatMatrix<> shape[DIM];    // nq[d] x n
+    FlatMatrix<> dshape[DIM];   // nq[d] x n
+    double * work;
+
+  public:
+    /// workspace (in doubles) needed by the kernels
+    static size_t WorkSize (const SumFactorizationTables<DIM> & tables);
+
+    /// work must provide WorkSize(tables) doubles
+    SumFactorizationTP (const SumFactorizationTables<DIM> & tables, const TensorProductDofs & dofs,
+                        double * work);
+
+    size_t GetNIP() const;
+
+    void Evaluate (BareSliceVector<> coefs, FlatVector<> values) const;
+    void AddTrans (FlatVector<> values, BareSliceVector<> coefs) const;
+    /// reference gradient, values is DIM x nip
+    void EvaluateGrad (BareSliceVector<> coefs, SliceMatrix<> values) const;
+    void AddGradTrans (SliceMatrix<> values, BareSliceVector<> coefs) const;
+  };
+
+  extern template class SumFactorizationTables<2>;
+  extern template class SumFactorizationTables<3>;
+  extern template class SumFactorizationTP<2>;
+  extern template class SumFactorizationTP<3>;
+}
+
+#endif
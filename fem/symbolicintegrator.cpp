@@ -2887,6 +2887,141 @@ namespace ngfem
       linearization->CalcElementMatrix(fel, trafo, elmat, lh);
     }
   
+  /*
+    Data kept per element (or inner facet) for repeated ApplyElementMatrix
+    (nonassemble with "precompute"): points and Jacobians of the simd
+    integration rule, and the values of CacheCF sub-trees which depend
+    neither on proxies nor on gridfunctions.
+   */
+  struct SymbolicBFIPrecomputed
+  {
+    Array<SIMD<double>> geometry;
+    Array<SIMD<double>> geometry_other; // neighbour element of a facet
+    Array<bool> cached;                 // per cache_cfs
+    Array<Array<SIMD<double>>> values;  // dim x simd-points, per cache_cfs
+  };
+
+  static bool IsStaticCacheCF (CoefficientFunction & ccf)
+  {
+    bool is_static = !ccf.IsComplex();
+    ccf.TraverseTree
+      ( [&] (CoefficientFunction & nodecf)
+        {
+          if (nodecf.StoreUserData())
+            is_static = false;
+        });
+    return is_static;
+  }
+
+  // as PrecomputeCacheCF, but take the static values from the element data
+  static void RestoreCacheCF (const Array<CoefficientFunction*> & cache_cfs,
+                              const SymbolicBFIPrecomputed & pre,
+                              SIMD_BaseMappedIntegrationRule & mir, LocalHeap & lh)
+  {
+    ProxyUserData & ud = *static_cast<ProxyUserData*> (mir.GetTransformation().userdata);
+    new (&ud.caches) FlatArray<pair<const CoefficientFunction*, void*>> (cache_cfs.Size(), lh);
+
+    for (auto i : Range(cache_cfs))
+      {
+        ud.caches[i] = { nullptr, nullptr };
+        if (pre.cached[i])
+          ud.caches[i] = { cache_cfs[i],
+                           new (lh) FlatMatrix<SIMD<double>> (cache_cfs[i]->Dimension(), mir.Size(),
+                                                              const_cast<SIMD<double>*> (pre.values[i].Data())) };
+      }
+
+    // not yet in the caches, so the CacheCF evaluates its function
+    for (auto i : Range(cache_cfs))
+      if (!pre.cached[i])
+        {
+          if (cache_cfs[i]->IsComplex())
+            {
+              auto * mat = new (lh) FlatMatrix<SIMD<Complex>> (cache_cfs[i]->Dimension(), mir.Size(), lh);
+              cache_cfs[i] -> Evaluate (mir, *mat);
+              ud.caches[i] = { cache_cfs[i], mat };
+            }
+          else
+            {
+              auto * mat = new (lh) FlatMatrix<SIMD<double>> (cache_cfs[i]->Dimension(), mir.Size(), lh);
+              cache_cfs[i] -> Evaluate (mir, *mat);
+              ud.caches[i] = { cache_cfs[i], mat };
+            }
+        }
+  }
+
+  // keep the values of the static caches computed by PrecomputeCacheCF
+  static void StoreStaticCacheCF (const Array<CoefficientFunction*> & cache_cfs,
+                                  const ProxyUserData & ud, SymbolicBFIPrecomputed & pre)
+  {
+    pre.cached.SetSize (cache_cfs.Size());
+    pre.values.SetSize (cache_cfs.Size());
+    for (auto i : Range(cache_cfs))
+      {
+        pre.cached[i] = IsStaticCacheCF (*cache_cfs[i]);
+        if (!pre.cached[i]) continue;
+        auto & mat = *static_cast<FlatMatrix<SIMD<double>>*> (ud.caches[i].second);
+        pre.values[i].SetSize (mat.Height()*mat.Width());
+        FlatMatrix<SIMD<double>> (mat.Height(), mat.Width(), pre.values[i].Data()) = mat;
+      }
+  }
+
+  static void GetCacheCFParameters (const Array<CoefficientFunction*> & cache_cfs,
+                                    Array<double> & values)
+  {
+    for (auto ccf : cache_cfs)
+      if (IsStaticCacheCF (*ccf))
+        ccf->TraverseTree
+          ( [&] (CoefficientFunction & nodecf)
+            {
+              if (auto par = dynamic_cast<ParameterCoefficientFunction<double>*> (&nodecf))
+                values.Append (par->GetValue());
+            });
+  }
+
+  void * SymbolicBilinearFormIntegrator ::
+  PrecomputeData (const FiniteElement & fel, 
+                  const ElementTransformation & trafo, 
+                  LocalHeap & lh) const
+  {
+    if (element_vb != VOL || !simd_evaluate)
+      return nullptr;
+
+    auto save_userdata = trafo.PushUserData();
+    HeapReset hr(lh);
+    try
+      {
+        const SIMD_IntegrationRule & simd_ir = Get_SIMD_IntegrationRule (fel, lh);
+        auto & simd_mir = trafo(simd_ir, lh);
+
+        ProxyUserData ud(trial_proxies.Size(), gridfunction_cfs.Size(), lh);
+        const_cast<ElementTransformation&>(trafo).userdata = &ud;
+        ud.fel = &fel;
+        PrecomputeCacheCF(cache_cfs, simd_mir, lh);
+
+        auto pre = new SymbolicBFIPrecomputed;
+        pre->geometry.SetSize (simd_ir.Size() * simd_mir.GeometrySize());
+        simd_mir.StoreGeometry (pre->geometry);
+
+        StoreStaticCacheCF (cache_cfs, ud, *pre);
+        return pre;
+      }
+    catch (const ExceptionNOSIMD & e)
+      {
+        return nullptr;
+      }
+  }
+
+  void SymbolicBilinearFormIntegrator :: DeletePrecomputedData (void * data) const
+  {
+    delete static_cast<SymbolicBFIPrecomputed*> (data);
+  }
+
+  void SymbolicBilinearFormIntegrator :: GetPrecomputeDependencies (Array<double> & values) const
+  {
+    GetCacheCFParameters (cache_cfs, values);
+  }
+
+  
   void
   SymbolicBilinearFormIntegrator :: ApplyElementMatrix (const FiniteElement & fel, 
                                                         const ElementTransformation & trafo, 
@@ -2919,8 +3054,9 @@ namespace ngfem
 
           HeapReset hr(lh);
 
+          auto pre = static_cast<const SymbolicBFIPrecomputed*> (precomputed);
           const SIMD_IntegrationRule& simd_ir = Get_SIMD_IntegrationRule (fel, lh);
-          auto & simd_mir = trafo(simd_ir, lh);
+          auto & simd_mir = pre ? trafo.MapGeometry(simd_ir, pre->geometry, lh) : trafo(simd_ir, lh);
           
           ProxyUserData ud(trial_proxies.Size(), gridfunction_cfs.Size(), lh);
           const_cast<ElementTransformation&>(trafo).userdata = &ud;
@@ -2928,7 +3064,10 @@ namespace ngfem
 
           {
             // RegionTimer rpre(tpre);          
-          PrecomputeCacheCF(cache_cfs, simd_mir, lh);
+          if (pre)
+            RestoreCacheCF(cache_cfs, *pre, simd_mir, lh);
+          else
+            PrecomputeCacheCF(cache_cfs, simd_mir, lh);
 
           for (ProxyFunction * proxy : trial_proxies)
             ud.AssignMemory (proxy, simd_ir.GetNIP(), proxy->Dimension(), lh);
@@ -4015,6 +4154,66 @@ namespace ngfem
   
 
 
+  void * SymbolicFacetBilinearFormIntegrator ::
+  PrecomputeFacetData (const FiniteElement & fel1, int LocalFacetNr1,
+                       const ElementTransformation & trafo1, FlatArray<int> & ElVertices1,
+                       const FiniteElement & fel2, int LocalFacetNr2,
+                       const ElementTransformation & trafo2, FlatArray<int> & ElVertices2,
+                       LocalHeap & lh) const
+  {
+    if (!simd_evaluate)
+      return nullptr;
+
+    auto save_userdata = trafo1.PushUserData();
+    HeapReset hr(lh);
+    try
+      {
+        int maxorder = max2 (fel1.Order(), fel2.Order());
+        auto eltype1 = trafo1.GetElementType();
+        auto eltype2 = trafo2.GetElementType();
+        auto etfacet = ElementTopology::GetFacetType (eltype1, LocalFacetNr1);
+        
+        Facet2ElementTrafo transform1(eltype1, ElVertices1); 
+        Facet2ElementTrafo transform2(eltype2, ElVertices2); 
+        const SIMD_IntegrationRule& simd_ir_facet = GetSIMDIntegrationRule(etfacet, 2*maxorder+bonus_intorder);
+        
+        auto & simd_mir1 = trafo1(transform1(LocalFacetNr1, simd_ir_facet, lh), lh);
+        auto & simd_mir2 = trafo2(transform2(LocalFacetNr2, simd_ir_facet, lh), lh);
+        simd_mir1.SetOtherMIR(&simd_mir2);
+        simd_mir2.SetOtherMIR(&simd_mir1);
+        simd_mir1.ComputeNormalsAndMeasure(eltype1, LocalFacetNr1);
+        simd_mir2.ComputeNormalsAndMeasure(eltype2, LocalFacetNr2);
+
+        ProxyUserData ud(trial_proxies.Size(), gridfunction_cfs.Size(), lh);
+        const_cast<ElementTransformation&>(trafo1).userdata = &ud;
+        ud.fel = &fel1;
+        PrecomputeCacheCF(cache_cfs, simd_mir1, lh);
+
+        auto pre = new SymbolicBFIPrecomputed;
+        pre->geometry.SetSize (simd_mir1.Size() * simd_mir1.GeometrySize());
+        simd_mir1.StoreGeometry (pre->geometry);
+        pre->geometry_other.SetSize (simd_mir2.Size() * simd_mir2.GeometrySize());
+        simd_mir2.StoreGeometry (pre->geometry_other);
+        StoreStaticCacheCF (cache_cfs, ud, *pre);
+        return pre;
+      }
+    catch (const ExceptionNOSIMD & e)
+      {
+        return nullptr;
+      }
+  }
+
+  void SymbolicFacetBilinearFormIntegrator :: DeletePrecomputedData (void * data) const
+  {
+    delete static_cast<SymbolicBFIPrecomputed*> (data);
+  }
+
+  void SymbolicFacetBilinearFormIntegrator :: GetPrecomputeDependencies (Array<double> & values) const
+  {
+    GetCacheCFParameters (cache_cfs, values);
+  }
+
+  
   void SymbolicFacetBilinearFormIntegrator ::
   ApplyFacetMatrix (const FiniteElement & fel1, int LocalFacetNr1,
                     const ElementTransformation & trafo1, FlatArray<int> & ElVertices1,
@@ -4022,6 +4221,19 @@ namespace ngfem
                     const ElementTransformation & trafo2, FlatArray<int> & ElVertices2,
                     FlatVector<double> elx, FlatVector<double> ely,
                     LocalHeap & lh) const
+  {
+    ApplyFacetMatrix (fel1, LocalFacetNr1, trafo1, ElVertices1,
+                      fel2, LocalFacetNr2, trafo2, ElVertices2,
+                      elx, ely, nullptr, lh);
+  }
+
+  void SymbolicFacetBilinearFormIntegrator ::
+  ApplyFacetMatrix (const FiniteElement & fel1, int LocalFacetNr1,
+                    const ElementTransformation & trafo1, FlatArray<int> & ElVertices1,
+                    const FiniteElement & fel2, int LocalFacetNr2,
+                    const ElementTransformation & trafo2, FlatArray<int> & ElVertices2,
+                    FlatVector<double> elx, FlatVector<double> ely,
+                    const void * precomputed, LocalHeap & lh) const
   {
     if (simd_evaluate)
       {
@@ -4053,11 +4265,15 @@ namespace ngfem
             
             const SIMD_IntegrationRule& simd_ir_facet = GetSIMDIntegrationRule(etfacet, 2*maxorder+bonus_intorder);
             
+            auto pre = static_cast<const SymbolicBFIPrecomputed*> (precomputed);
+            
             auto & simd_ir_facet_vol1 = transform1(LocalFacetNr1, simd_ir_facet, lh);
-            auto & simd_mir1 = trafo1(simd_ir_facet_vol1, lh);
+            auto & simd_mir1 = pre ? trafo1.MapGeometry(simd_ir_facet_vol1, pre->geometry, lh)
+              : trafo1(simd_ir_facet_vol1, lh);
             
             auto & simd_ir_facet_vol2 = transform2(LocalFacetNr2, simd_ir_facet, lh);
-            auto & simd_mir2 = trafo2(simd_ir_facet_vol2, lh);
+            auto & simd_mir2 = pre ? trafo2.MapGeometry(simd_ir_facet_vol2, pre->geometry_other, lh)
+              : trafo2(simd_ir_facet_vol2, lh);
 
             simd_mir1.SetOtherMIR(&simd_mir2);
             simd_mir2.SetOtherMIR(&simd_mir1);
@@ -4071,7 +4287,10 @@ namespace ngfem
             const_cast<ElementTransformation&>(trafo1).userdata = &ud;
             ud.fel = &fel1;   // necessary to check remember-map
 
-            PrecomputeCacheCF(cache_cfs, simd_mir1, lh);
+            if (pre)
+              RestoreCacheCF(cache_cfs, *pre, simd_mir1, lh);
+            else
+              PrecomputeCacheCF(cache_cfs, simd_mir1, lh);
 
             for (ProxyFunction * proxy : trial_proxies)
               ud.AssignMemory (proxy, simd_ir_facet.GetNIP(), proxy->Dimension(), lh);
@@ -772,6 +772,14 @@ public:
                                           FlatMatrix<double> elmat,
                                           LocalHeap & lh) const;
     
+    // geometry and cached coefficients for repeated ApplyElementMatrix
+    NGS_DLL_HEADER virtual void *
+    PrecomputeData (const FiniteElement & fel,
+                    const ElementTransformation & trafo,
+                    LocalHeap & lh) const override;
+    NGS_DLL_HEADER virtual void DeletePrecomputedData (void * data) const override;
+    NGS_DLL_HEADER virtual void GetPrecomputeDependencies (Array<double> & values) const override;
+
     NGS_DLL_HEADER virtual void 
     ApplyElementMatrix (const FiniteElement & fel, 
 			const ElementTransformation & trafo, 
@@ -923,6 +931,23 @@ public:
                       FlatVector<double> elx, FlatVector<double> ely,
                       LocalHeap & lh) const;
 
+    NGS_DLL_HEADER virtual void
+    ApplyFacetMatrix (const FiniteElement & volumefel1, int LocalFacetNr1,
+                      const ElementTransformation & eltrans1, FlatArray<int> & ElVertices1,
+                      const FiniteElement & volumefel2, int LocalFacetNr2,
+                      const ElementTransformation & eltrans2, FlatArray<int> & ElVertices2,
+                      FlatVector<double> elx, FlatVector<double> ely,
+                      const void * precomputed, LocalHeap & lh) const override;
+
+    NGS_DLL_HEADER virtual void *
+    PrecomputeFacetData (const FiniteElement & volumefel1, int LocalFacetNr1,
+                         const ElementTransformation & eltrans1, FlatArray<int> & ElVertices1,
+                         const FiniteElement & volumefel2, int LocalFacetNr2,
+                         const ElementTransformation & eltrans2, FlatArray<int> & ElVertices2,
+                         LocalHeap & lh) const override;
+    NGS_DLL_HEADER virtual void DeletePrecomputedData (void * data) const override;
+    NGS_DLL_HEADER virtual void GetPrecomputeDependencies (Array<double> & values) const override;
+
     NGS_DLL_HEADER virtual void
     CalcTraceValues (const FiniteElement & volumefel, int LocalFacetNr,
 		     const ElementTransformation & eltrans, FlatArray<int> & ElVertices,
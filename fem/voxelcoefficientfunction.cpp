@@ -3,8 +3,8 @@
 
 namespace ngfem
 {
-  template<typename T>
-  T VoxelCoefficientFunction<T> :: T_Evaluate(const BaseMappedIntegrationPoint& ip) const
+  template<typename T, typename TSTORE>
+  T VoxelCoefficientFunction<T,TSTORE> :: T_Evaluate(const BaseMappedIntegrationPoint& ip) const
   {
     // static Timer t("VoxelCF::Eval");
     // RegionTracer reg(TaskManager::GetThreadId(), t);
@@ -140,16 +140,132 @@ namespace ngfem
     */
   }
 
-  template<typename T>
-  Complex VoxelCoefficientFunction<T> :: EvaluateComplex(const BaseMappedIntegrationPoint& ip) const
+  // lane-wise gather from the voxel values, index holds integer values
+  template<typename TSTORE>
+  static auto GatherVoxel(FlatArray<TSTORE> vals, SIMD<double> index)
+  {
+    if constexpr(is_same_v<TSTORE, Complex>)
+      return SIMD<Complex>(SIMD<double>([&](int i) -> double { return vals[size_t(index[i])].real(); }),
+                           SIMD<double>([&](int i) -> double { return vals[size_t(index[i])].imag(); }));
+    else
+      return SIMD<double>([&](int i) -> double { return vals[size_t(index[i])]; });
+  }
+
+  template<typename T, typename TSTORE>
+  void VoxelCoefficientFunction<T,TSTORE> :: T_Evaluate(const SIMD_BaseMappedIntegrationRule& ir,
+                                                        BareSliceMatrix<SIMD<T>> res) const
+  {
+    // static Timer t("VoxelCF::Eval SIMD");
+    // RegionTracer reg(TaskManager::GetThreadId(), t);
+
+    Switch<3> (start.Size()-1, [&] (auto ICDIM) {
+        constexpr int DIM = ICDIM.value+1;
+        size_t np = ir.Size();
+
+        STACK_ARRAY(SIMD<double>, hmem, DIM*np);
+        FlatMatrix<SIMD<double>> pnts(DIM, np, &hmem[0]);
+        if (trafocf)
+          trafocf->Evaluate(ir, pnts);
+        else
+          {
+            auto points = ir.GetPoints();
+            for (int k = 0; k < DIM; k++)
+              for (size_t i = 0; i < np; i++)
+                pnts(k,i) = points(i,k);
+          }
+
+        for (size_t i = 0; i < np; i++)
+          {
+            SIMD<double> ind[DIM], weight[DIM];
+            for (int k = 0; k < DIM; k++)
+              {
+                auto nvals = linear ? dim_vals[k] - 1 : dim_vals[k];
+                double len = (end[k] - start[k])/nvals;
+                SIMD<double> coord = pnts(k,i);
+                coord = If(coord < SIMD<double>(start[k]), SIMD<double>(start[k]), coord);
+                coord = If(SIMD<double>(end[k]) < coord, SIMD<double>(end[k]), coord);
+                SIMD<double> pos = (coord - start[k])/len;
+                ind[k] = floor(pos);
+                if (linear)
+                  weight[k] = 1.-(pos-ind[k]);
+                else  // coord == end belongs to the last voxel
+                  ind[k] = If(SIMD<double>(nvals-1) < ind[k], SIMD<double>(nvals-1), ind[k]);
+              }
+
+            // flat indices are exact in double precision
+            if (!linear)
+              {
+                SIMD<double> index = ind[0];
+                double offset = dim_vals[0];
+                for (int k = 1; k < DIM; k++)
+                  {
+                    index += offset * ind[k];
+                    offset *= dim_vals[k];
+                  }
+                res(0,i) = GatherVoxel<TSTORE>(values, index);
+                continue;
+              }
+
+            SIMD<double> indplus1[DIM];
+            for (int k = 0; k < DIM; k++)
+              indplus1[k] = If(ind[k]+1. < SIMD<double>(dim_vals[k]), ind[k]+1., ind[k]);
+
+            SIMD<T> sum = 0.;
+            for (int c = 0; c < (1 << DIM); c++)
+              {
+                SIMD<double> index = 0., w = 1.;
+                double offset = 1;
+                for (int k = 0; k < DIM; k++)
+                  {
+                    if (c & (1 << k))
+                      {
+                        index += offset * indplus1[k];
+                        w *= 1.-weight[k];
+                      }
+                    else
+                      {
+                        index += offset * ind[k];
+                        w *= weight[k];
+                      }
+                    offset *= dim_vals[k];
+                  }
+                sum += w * GatherVoxel<TSTORE>(values, index);
+              }
+            res(0,i) = sum;
+          }
+      });
+  }
+
+  template<typename T, typename TSTORE>
+  void VoxelCoefficientFunction<T,TSTORE> :: Evaluate(const SIMD_BaseMappedIntegrationRule& ir,
+                                                      BareSliceMatrix<SIMD<double>> values) const
+  {
+    if constexpr(is_same_v<T, double>)
+      T_Evaluate(ir, values);
+    else
+      throw Exception("Real evaluate for complex VoxelCoefficient called!");
+  }
+
+  template<typename T, typename TSTORE>
+  void VoxelCoefficientFunction<T,TSTORE> :: Evaluate(const SIMD_BaseMappedIntegrationRule& ir,
+                                                      BareSliceMatrix<SIMD<Complex>> values) const
+  {
+    if constexpr(is_same_v<T, Complex>)
+      T_Evaluate(ir, values);
+    else
+      CoefficientFunctionNoDerivative::Evaluate(ir, values);
+  }
+
+  template<typename T, typename TSTORE>
+  Complex VoxelCoefficientFunction<T,TSTORE> :: EvaluateComplex(const BaseMappedIntegrationPoint& ip) const
   {
     if constexpr(is_same_v<T, Complex>)
       return T_Evaluate(ip);
     throw Exception("Complex evaluate for real VoxelCoefficient called!");
   }
 
-  template<typename T>
-  void VoxelCoefficientFunction<T> :: Evaluate(const BaseMappedIntegrationPoint& mip, FlatVector<Complex> values) const
+  template<typename T, typename TSTORE>
+  void VoxelCoefficientFunction<T,TSTORE> :: Evaluate(const BaseMappedIntegrationPoint& mip, FlatVector<Complex> values) const
   {
     if constexpr(is_same_v<T, Complex>)
       {
@@ -159,8 +275,8 @@ namespace ngfem
     throw Exception("Complex evaluate for real VoxelCoefficient called!");
   }
 
-  template<typename T>
-  double VoxelCoefficientFunction<T> :: Evaluate(const BaseMappedIntegrationPoint& ip) const
+  template<typename T, typename TSTORE>
+  double VoxelCoefficientFunction<T,TSTORE> :: Evaluate(const BaseMappedIntegrationPoint& ip) const
   {
     if constexpr(is_same_v<T, double>)
       return T_Evaluate(ip);
@@ -168,5 +284,6 @@ namespace ngfem
   }
 
   template class VoxelCoefficientFunction<double>;
+  template class VoxelCoefficientFunction<double, float>;
   template class VoxelCoefficientFunction<Complex>;
 } // namespace ngfem
@@ -5,19 +5,20 @@
 
 namespace ngfem
 {
-  template<typename SCAL>
+  // values of type SCAL, stored as TSTORE (float halves the memory traffic)
+  template<typename SCAL, typename TSTORE = SCAL>
   class VoxelCoefficientFunction : public CoefficientFunctionNoDerivative
   {
     Array<double> start, end;
     Array<size_t> dim_vals;
-    Array<SCAL> values;
+    Array<TSTORE> values;
     bool linear;
     shared_ptr<CoefficientFunction> trafocf;
   public:
     VoxelCoefficientFunction(const Array<double>& _start,
                              const Array<double>& _end,
                              const Array<size_t>& _dim_vals,
-                             Array<SCAL>&& _values,
+                             Array<TSTORE>&& _values,
                              bool _linear,
                              shared_ptr<CoefficientFunction> trafo=nullptr)
       : CoefficientFunctionNoDerivative(1, is_same_v<SCAL, Complex>),
@@ -31,8 +32,12 @@ namespace ngfem
 
     void Evaluate(const BaseMappedIntegrationPoint& mip, FlatVector<Complex> values) const override;
 
+    void Evaluate(const SIMD_BaseMappedIntegrationRule& ir, BareSliceMatrix<SIMD<double>> values) const override;
+    void Evaluate(const SIMD_BaseMappedIntegrationRule& ir, BareSliceMatrix<SIMD<Complex>> values) const override;
+
   private:
     SCAL T_Evaluate(const BaseMappedIntegrationPoint& ip) const;
+    void T_Evaluate(const SIMD_BaseMappedIntegrationRule& ir, BareSliceMatrix<SIMD<SCAL>> values) const;
   };
 } // namespace ngfem
 
@@ -962,6 +962,14 @@ namespace ngla
     return mv2;
   }
 
+  unique_ptr<MultiVector> BaseVectorPtrMV :: SubSet(const Array<int> & indices) const 
+  {
+    auto mv2 = make_unique<BaseVectorPtrMV>(refvec, 0);
+    for (auto i : indices)
+      mv2->vecs.Append (vecs[i]);
+    return mv2;
+  }
+
   void BaseVectorPtrMV :: SetScalar (double s) 
   {
     static Timer t("BaseVector-MV :: SetScalar");
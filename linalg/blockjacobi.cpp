@@ -488,6 +488,14 @@ namespace ngla
     }
 
     /** Invert diagonal blocks **/
+    if constexpr (is_same<TM,double>::value)
+      {
+        // blocks of equal size are inverted together in SIMD lanes
+        RegionTimer reg(tinv);
+        CalcInverseBatched (invdiag);
+      }
+    else
+      {
     SharedLoop2 sl2(blocktable->Size());
     ParallelJob
       ([&] (const TaskInfo & ti)
@@ -501,6 +509,7 @@ namespace ngla
 	   }
          NgProfiler::StopThreadTimer (tpar, TaskManager::GetThreadId());                  
        } );
+      }
 
     cout << IM(3) << "\rBuilding block " << blocktable->Size() << "/" << blocktable->Size() << flush;
     *testout << "block coloring";
@@ -644,6 +644,175 @@ namespace ngla
 
 
 
+  // inner product of the local parts, without global reduction
+  template <class IPTYPE>
+  inline typename SCAL_TRAIT<IPTYPE>::SCAL
+  LocalInnerProduct (const BaseVector & v1, const BaseVector & v2)
+  {
+    return S_InnerProduct<IPTYPE> (*v1.GetLocalVector(), *v2.GetLocalVector());
+  }
+
+  // sums a few scalars over all ranks, Start returns immediately
+  template <typename SCAL>
+  class NonBlockingSum
+  {
+    optional<NgMPI_Comm> comm;
+#ifdef PARALLEL
+    MPI_Request request;
+#endif
+  public:
+    NonBlockingSum (const BaseVector & v)
+      : comm(v.GetCommunicator())
+    {
+      if (comm && comm->Size() == 1)
+        comm = nullopt;
+    }
+
+    void Start (FlatVector<SCAL> data)
+    {
+#ifdef PARALLEL
+      if (comm)
+        MPI_Iallreduce (MPI_IN_PLACE, data.Data(), data.Size(), GetMPIType<SCAL>(),
+                        MPI_SUM, *comm, &request);
+#endif
+    }
+
+    void Wait ()
+    {
+#ifdef PARALLEL
+      if (comm)
+        MPI_Wait (&request, MPI_STATUS_IGNORE);
+#endif
+    }
+  };
+
+
+  template <class IPTYPE>
+  void PipelinedCGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & x) const
+  {
+    static Timer timer ("Pipelined CG solver");
+    static Timer timerwait ("Pipelined CG solver - wait for reduction");
+    RegionTimer reg (timer);
+
+    try
+      {
+	if(sh)
+	  sh->SetThreadPercentage(0);
+
+        // r, w, nv, s, z are distributed, u, m, p, q are cumulated
+        auto r = f.CreateVector();
+        auto w = f.CreateVector();
+        auto nv = f.CreateVector();
+        auto s = f.CreateVector();
+        auto z = f.CreateVector();
+        auto u = x.CreateVector();
+        auto m = x.CreateVector();
+        auto p = x.CreateVector();
+        auto q = x.CreateVector();
+
+        auto precond = [&] (const BaseVector & in, BaseVector & out)
+          {
+            if (c)
+              out = (*c) * in;
+            else
+              out = in;
+            out.Cumulate();
+          };
+
+	if (initialize)
+	  {
+	    x = 0.0;
+	    r = f;
+	  }
+	else
+	  r = f - (*a) * x;
+        r.Distribute();
+        precond (r, u);
+        w = (*a) * u;
+
+        NonBlockingSum<SCAL> sum(r);
+        Vector<SCAL> dots(2);
+	SCAL gamma, gamma_old = 0, delta, al = 1, al_old = 1, be;
+	double err = 0, lwstart = 0, lerr = 0;
+	int n = 0;
+
+	while (true)
+	  {
+            // gamma = (r, M r), delta = (A M r, M r)
+            dots(0) = LocalInnerProduct<IPTYPE> (r, u);
+            dots(1) = LocalInnerProduct<IPTYPE> (w, u);
+            sum.Start (dots);
+
+            precond (w, m);
+            nv = (*a) * m;
+
+            timerwait.Start();
+            sum.Wait();
+            timerwait.Stop();
+            gamma = dots(0);
+            delta = dots(1);
+
+	    if (printrates) cout << IM(1) << n << " " << sqrt(Abs(gamma)) << endl;
+            if (n == 0)
+              {
+                err = stop_absolute ? prec * prec : prec * prec * Abs(gamma);
+                lwstart = log(Abs(gamma));
+                lerr = log(err);
+              }
+            else if (sh)
+	      sh->SetThreadPercentage(100.*max2(double(n)/double(maxsteps),
+						(lwstart-log(Abs(gamma)))/(lwstart-lerr)));
+
+            if (Abs(gamma) <= err || n >= maxsteps || (sh && sh->ShouldTerminate()))
+              break;
+
+            if (n == 0)
+              {
+                if (delta == 0.0) break;
+                al = gamma / delta;
+                z = nv;
+                q = m;
+                s = w;
+                p = u;
+              }
+            else
+              {
+                be = gamma / gamma_old;
+                SCAL denom = delta - be * gamma / al_old;
+                if (denom == 0.0) break;
+                al = gamma / denom;
+                z *= be; z += nv;
+                q *= be; q += m;
+                s *= be; s += w;
+                p *= be; p += u;
+              }
+
+            x += al * p;
+            r -= al * s;
+            u -= al * q;
+            w -= al * z;
+
+            gamma_old = gamma;
+            al_old = al;
+            n++;
+	  }
+
+	const_cast<int&> (steps) = n;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in PipelinedCGSolver::Mult\n");
+	throw;
+      }
+    catch (exception & e)
+      {
+	throw Exception(e.what() +
+			string ("\ncaught in PipelinedCGSolver::Mult\n"));
+      }
+  }
+
+
   template <class IPTYPE>
   void BiCGStabSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & u) const
   {
@@ -1315,10 +1484,437 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
   
  
   
+  /* ******************** Block Krylov solvers ********************* */
+
+  // returns x^H y
+  template <typename SCAL>
+  static Matrix<SCAL> BlockInnerProduct (const MultiVector & x, const MultiVector & y)
+  {
+    if constexpr (is_same<SCAL,double>::value)
+      return x.InnerProductD (y);
+    else
+      return Conj (x.InnerProductC (y, true));
+  }
+
+  // y = mat * x, y = x if there is no matrix
+  static void BlockApply (const BaseMatrix * mat, const MultiVector & x, MultiVector & y)
+  {
+    if (!mat)
+      {
+        y = x;
+        return;
+      }
+    Vector<double> ones(x.Size());
+    ones = 1.0;
+    y = 0.0;
+    mat->MultAdd (ones, x, y);
+  }
+
+  /*
+    Orthonormalizes the columns of mv in place, returns R with mv_old = mv R.
+    A column whose norm drops below 1e-12 of refnorm after the projection
+    is linearly dependent on the previous ones, it is set to zero (with a
+    zero row in R) and counted in ndeflated.
+  */
+  template <typename SCAL>
+  static Matrix<SCAL> BlockOrthonormalize (MultiVector & mv, FlatVector<double> refnorm, int & ndeflated)
+  {
+    size_t n = mv.Size();
+    Matrix<SCAL> rfactor(n);
+    rfactor = SCAL(0.0);
+    if (n == 1)
+      {
+        double norm = mv[0]->L2Norm();
+        if (norm <= 1e-12 * refnorm(0))
+          {
+            *mv[0] = 0.0;
+            ndeflated++;
+          }
+        else
+          {
+            rfactor(0,0) = norm;
+            *mv[0] *= 1.0 / norm;
+          }
+        return rfactor;
+      }
+
+    auto r1 = IntRange(0, n/2);
+    auto r2 = IntRange(n/2, n);
+    auto mv1 = mv.Range(r1);
+    auto mv2 = mv.Range(r2);
+    rfactor.Rows(r1).Cols(r1) = BlockOrthonormalize<SCAL> (*mv1, refnorm.Range(r1), ndeflated);
+    Matrix<SCAL> ip = BlockInnerProduct<SCAL> (*mv1, *mv2);
+    rfactor.Rows(r1).Cols(r2) = ip;
+    ip *= -1;
+    mv2->Add (*mv1, ip);
+    rfactor.Rows(r2).Cols(r2) = BlockOrthonormalize<SCAL> (*mv2, refnorm.Range(r2), ndeflated);
+    return rfactor;
+  }
+
+  template <typename SCAL>
+  static Matrix<SCAL> BlockOrthonormalize (MultiVector & mv, int & ndeflated)
+  {
+    Vector<double> refnorm(mv.Size());
+    for (size_t i = 0; i < mv.Size(); i++)
+      refnorm(i) = mv[i]->L2Norm();
+    return BlockOrthonormalize<SCAL> (mv, refnorm, ndeflated);
+  }
+
+  /*
+    inverts the hermitean positive definite m in place.
+    Returns false, leaving m unchanged, if a Cholesky pivot is below 1e-14
+    of the diagonal, i.e. the block vectors behind m are linearly dependent.
+  */
+  template <typename SCAL>
+  static bool CalcInverseHPD (FlatMatrix<SCAL> m)
+  {
+    size_t n = m.Height();
+    Matrix<SCAL> l = m;
+    for (size_t j = 0; j < n; j++)
+      {
+        double d = Real (l(j,j));
+        for (size_t k = 0; k < j; k++)
+          d -= sqr (Abs (l(j,k)));
+        if (!(d > 1e-14 * Abs (m(j,j))))
+          return false;
+        l(j,j) = sqrt(d);
+        for (size_t i = j+1; i < n; i++)
+          {
+            SCAL sum = l(i,j);
+            for (size_t k = 0; k < j; k++)
+              sum -= l(i,k) * Conj(l(j,k));
+            l(i,j) = sum / l(j,j);
+          }
+      }
+    CalcInverse (m);
+    return true;
+  }
+
+  
+  template <typename SCAL>
+  int BlockCG (const BaseMatrix & mat, const BaseMatrix * pre,
+               const MultiVector & rhs, MultiVector & sol,
+               double tol, int maxsteps, bool initialize, int printrates)
+  {
+    static Timer t("BlockCG");
+    RegionTimer reg(t);
+
+    size_t k = rhs.Size();
+    if (sol.Size() != k)
+      throw Exception ("BlockCG: number of solutions " + ToString(sol.Size())
+                       + " != number of right hand sides " + ToString(k));
+
+    auto r = rhs.RefVec()->CreateMultiVector(k);
+    auto z = rhs.RefVec()->CreateMultiVector(k);
+    auto p = rhs.RefVec()->CreateMultiVector(k);
+    auto q = rhs.RefVec()->CreateMultiVector(k);
+
+    *r = rhs;
+    if (initialize)
+      sol = 0.0;
+    else
+      {
+        Vector<double> mones(k);
+        mones = -1;
+        mat.MultAdd (mones, sol, *r);
+      }
+
+    BlockApply (pre, *r, *z);
+    Matrix<SCAL> rho = BlockInnerProduct<SCAL> (*z, *r);
+
+    Vector<double> err0(k);
+    Array<int> active;
+    for (size_t i = 0; i < k; i++)
+      {
+        err0(i) = sqrt (Abs (rho(i,i)));
+        if (err0(i) > 0) active.Append (i);
+      }
+    if (printrates) cout << IM(1) << "0 " << L2Norm(err0) << endl;
+
+    // views to the columns not yet converged
+    unique_ptr<MultiVector> ra, za, pa, qa, xa;
+    auto restrict_active = [&] ()
+      {
+        ra = r->SubSet(active);
+        za = z->SubSet(active);
+        pa = p->SubSet(active);
+        qa = q->SubSet(active);
+        xa = sol.SubSet(active);
+        *pa = *za;
+        rho = BlockInnerProduct<SCAL> (*za, *ra);
+      };
+    if (active.Size())
+      restrict_active();
+
+    int steps = 0;
+    bool restarted = true;
+    while (active.Size() && steps < maxsteps)
+      {
+        BlockApply (&mat, *pa, *qa);
+
+        // alpha = (P^H A P)^{-1} Z^H R
+        Matrix<SCAL> paq = BlockInnerProduct<SCAL> (*pa, *qa);
+        if (!CalcInverseHPD<SCAL> (paq))
+          {
+            // the search directions became linearly dependent: restart them from
+            // the residuals, if these are dependent too the block cannot continue
+            if (restarted)
+              {
+                cout << IM(1) << "BlockCG: residuals of the remaining "
+                     << active.Size() << " right hand sides are linearly dependent, stopping" << endl;
+                break;
+              }
+            restrict_active();
+            restarted = true;
+            continue;
+          }
+        steps++;
+        Matrix<SCAL> alpha = paq * rho;
+        xa->Add (*pa, alpha);
+        alpha *= -1;
+        ra->Add (*qa, alpha);
+
+        BlockApply (pre, *ra, *za);
+        Matrix<SCAL> rhonew = BlockInnerProduct<SCAL> (*za, *ra);
+
+        Array<int> still_active;
+        double maxerr = 0;
+        for (size_t i = 0; i < active.Size(); i++)
+          {
+            double err = sqrt (Abs (rhonew(i,i)));
+            maxerr = max2 (maxerr, err / err0(active[i]));
+            if (err > tol * err0(active[i]))
+              still_active.Append (active[i]);
+          }
+        if (printrates)
+          cout << IM(1) << steps << " " << maxerr << ", active = " << still_active.Size() << endl;
+
+        if (still_active.Size() < active.Size())
+          {
+            // continue with the remaining columns, restart the search directions
+            active = std::move(still_active);
+            if (active.Size())
+              restrict_active();
+            restarted = true;
+            continue;
+          }
+
+        // P = Z + P (Z_old^H R_old)^{-1} Z^H R
+        if (!CalcInverseHPD<SCAL> (rho))
+          {
+            restrict_active();
+            restarted = true;
+            continue;
+          }
+        Matrix<SCAL> beta = rho * rhonew;
+        *qa = *za;
+        qa->Add (*pa, beta);
+        swap (pa, qa);
+        rho = rhonew;
+        restarted = false;
+      }
+    return steps;
+  }
+
+
+  template <typename SCAL>
+  int BlockGMRes (const BaseMatrix & mat, const BaseMatrix * pre,
+                  const MultiVector & rhs, MultiVector & sol,
+                  double tol, int maxsteps, bool initialize, int printrates,
+                  int restart)
+  {
+    static Timer t("BlockGMRes");
+    RegionTimer reg(t);
+
+    size_t k = rhs.Size();
+    if (sol.Size() != k)
+      throw Exception ("BlockGMRes: number of solutions " + ToString(sol.Size())
+                       + " != number of right hand sides " + ToString(k));
+
+    if (initialize)
+      sol = 0.0;
+
+    /*
+      The block Hessenberg matrix is reduced to triangular form column by
+      column while it is built. Column c has entries down to row c+k, it is
+      eliminated by the Householder reflector I - 2 v v^H / (v^H v) acting
+      on rows c ... c+k, v is stored in row c of refl. The same reflectors
+      are applied to the right hand side g = (S_0, 0, ...)^T, its rows
+      (j+1)k ... (j+2)k hold the least squares residuals after step j.
+      After m steps the method restarts with the new residual.
+    */
+    size_t m = (restart > 0) ? min2 (restart, maxsteps) : maxsteps;
+    size_t nrows = (m+1)*k;
+    Matrix<SCAL> h(nrows, m*k);
+    Matrix<SCAL> g(nrows, k);
+    Matrix<SCAL> refl(m*k, k+1);
+    Vector<double> reflnorm(m*k);
+
+    auto reflect = [&] (size_t c, SliceMatrix<SCAL> a)
+      {
+        if (reflnorm(c) == 0) return;
+        for (size_t l = 0; l < a.Width(); l++)
+          {
+            SCAL ip(0.0);
+            for (size_t i = 0; i <= k; i++)
+              ip += Conj(refl(c,i)) * a(c+i,l);
+            ip *= 2.0 / reflnorm(c);
+            for (size_t i = 0; i <= k; i++)
+              a(c+i,l) -= ip * refl(c,i);
+          }
+      };
+
+    auto r = rhs.RefVec()->CreateMultiVector(k);
+    auto w = rhs.RefVec()->CreateMultiVector(k);
+    Array<shared_ptr<MultiVector>> basis;
+    Vector<double> err0(k);
+    Vector<double> mones(k);
+    mones = -1;
+
+    int steps = 0;
+    for (int cycle = 0; ; cycle++)
+      {
+        *r = rhs;
+        if (cycle > 0 || !initialize)
+          mat.MultAdd (mones, sol, *r);
+
+        basis.SetSize0();
+        basis.Append (rhs.RefVec()->CreateMultiVector(k));
+        BlockApply (pre, *r, *basis[0]);
+
+        // V_0 S_0 = C r, dependent right hand sides give zero columns in V_0
+        int ndeflated = 0;
+        Matrix<SCAL> s0 = BlockOrthonormalize<SCAL> (*basis[0], ndeflated);
+        if (cycle == 0)
+          {
+            for (size_t i = 0; i < k; i++)
+              err0(i) = L2Norm (s0.Col(i));
+            if (printrates) cout << IM(1) << "0 " << L2Norm(err0) << endl;
+
+            bool converged = true;
+            for (size_t i = 0; i < k; i++)
+              if (err0(i) > 0) converged = false;
+            if (converged) return 0;
+          }
+
+        h = SCAL(0.0);
+        g = SCAL(0.0);
+        g.Rows(0, k) = s0;
+
+        size_t nsteps = 0;
+        bool converged = false;
+        bool invariant = false;
+        while (nsteps < m && steps < maxsteps)
+          {
+            size_t j = nsteps++;
+            steps++;
+            auto & vj = *basis[j];
+            BlockApply (&mat, vj, *w);
+            shared_ptr<MultiVector> v = rhs.RefVec()->CreateMultiVector(k);
+            BlockApply (pre, *w, *v);
+
+            auto hj = h.Cols(j*k, (j+1)*k);
+            Vector<double> refnorm(k);
+            for (size_t i = 0; i < k; i++)
+              refnorm(i) = (*v)[i]->L2Norm();
+            for (size_t i = 0; i <= j; i++)
+              {
+                Matrix<SCAL> hij = BlockInnerProduct<SCAL> (*basis[i], *v);
+                hj.Rows(i*k, (i+1)*k) = hij;
+                hij *= -1;
+                v->Add (*basis[i], hij);
+              }
+            ndeflated = 0;
+            hj.Rows((j+1)*k, (j+2)*k) = BlockOrthonormalize<SCAL> (*v, refnorm, ndeflated);
+            basis.Append (v);
+
+            // apply the previous reflectors to the new block column
+            for (size_t c = 0; c < j*k; c++)
+              reflect (c, hj);
+
+            // new reflectors eliminating the subdiagonal block
+            for (size_t c = j*k; c < (j+1)*k; c++)
+              {
+                size_t col = c - j*k;
+                double norm = 0;
+                for (size_t i = 0; i <= k; i++)
+                  norm += sqr (Abs (hj(c+i,col)));
+                norm = sqrt (norm);
+                if (norm == 0)
+                  {
+                    reflnorm(c) = 0;
+                    continue;
+                  }
+                SCAL phase = (Abs (hj(c,col)) > 0) ? hj(c,col) / Abs(hj(c,col)) : SCAL(1.0);
+                SCAL alpha = -norm * phase;
+                double vnorm = 0;
+                for (size_t i = 0; i <= k; i++)
+                  {
+                    refl(c,i) = hj(c+i,col);
+                    if (i == 0) refl(c,i) -= alpha;
+                    vnorm += sqr (Abs (refl(c,i)));
+                  }
+                reflnorm(c) = vnorm;
+                reflect (c, hj.Cols(col, k));
+                reflect (c, g);
+              }
+
+            double maxerr = 0;
+            converged = true;
+            for (size_t i = 0; i < k; i++)
+              if (err0(i) > 0)
+                {
+                  double res = L2Norm (g.Rows((j+1)*k, (j+2)*k).Col(i));
+                  maxerr = max2 (maxerr, res / err0(i));
+                  if (res > tol * err0(i)) converged = false;
+                }
+            if (printrates) cout << IM(1) << steps << " " << maxerr << endl;
+            // the Krylov space is invariant if the whole new block was dependent
+            invariant = (ndeflated == int(k));
+            if (converged || invariant) break;
+          }
+
+        // back substitution, zero pivots belong to deflated directions
+        size_t n = nsteps*k;
+        Matrix<SCAL> y(n, k);
+        for (size_t l = 0; l < k; l++)
+          for (size_t i = n; i-- > 0; )
+            {
+              SCAL sum = g(i,l);
+              for (size_t mm = i+1; mm < n; mm++)
+                sum -= h(i,mm) * y(mm,l);
+              y(i,l) = (h(i,i) != SCAL(0.0)) ? sum / h(i,i) : SCAL(0.0);
+            }
+
+        for (size_t i = 0; i < nsteps; i++)
+          {
+            Matrix<SCAL> yi = y.Rows(i*k, (i+1)*k);
+            sol.Add (*basis[i], yi);
+          }
+
+        if (converged || invariant || steps >= maxsteps)
+          return steps;
+      }
+  }
+
+  template int BlockCG<double> (const BaseMatrix &, const BaseMatrix *, const MultiVector &, MultiVector &,
+                                double, int, bool, int);
+  template int BlockCG<Complex> (const BaseMatrix &, const BaseMatrix *, const MultiVector &, MultiVector &,
+                                 double, int, bool, int);
+  template int BlockGMRes<double> (const BaseMatrix &, const BaseMatrix *, const MultiVector &, MultiVector &,
+                                   double, int, bool, int, int);
+  template int BlockGMRes<Complex> (const BaseMatrix &, const BaseMatrix *, const MultiVector &, MultiVector &,
+                                    double, int, bool, int, int);
+
+
   template class CGSolver<double>;
   template class CGSolver<Complex>;
   template class CGSolver<ComplexConjugate>;
   template class CGSolver<ComplexConjugate2>;
+  template class PipelinedCGSolver<double>;
+  template class PipelinedCGSolver<Complex>;
+  template class PipelinedCGSolver<ComplexConjugate>;
+  template class PipelinedCGSolver<ComplexConjugate2>;
   template class BiCGStabSolver<double>;
   template class BiCGStabSolver<Complex>;
   template class BiCGStabSolver<ComplexConjugate>;
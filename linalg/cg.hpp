@@ -128,6 +128,34 @@ namespace ngla
   };
 
 
+  /**
+     Pipelined conjugate gradient method (Ghysels, Vanroose).
+     Both inner products of an iteration are summed up in one
+     non-blocking reduction, which is overlapped with the application
+     of the preconditioner and the matrix. Uses more vectors and
+     one more matrix product per solve than CGSolver.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER PipelinedCGSolver : public KrylovSpaceSolver
+  {
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    PipelinedCGSolver () 
+      : KrylovSpaceSolver () { ; }
+    ///
+    PipelinedCGSolver (shared_ptr<BaseMatrix> aa)
+      : KrylovSpaceSolver (aa) { ; }
+
+    ///
+    PipelinedCGSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const;
+  };
+
+
   /// The BiCGStab solver
   template <class IPTYPE>
   class NGS_DLL_HEADER BiCGStabSolver : public KrylovSpaceSolver
@@ -231,6 +259,38 @@ namespace ngla
 
 
 
+  /**
+     Block CG for several right hand sides of a symmetric (hermitean)
+     positive definite matrix. All columns share one block Krylov space,
+     the work is done by matrix-multivector products and small dense
+     problems of the block size. Converged columns are removed from the
+     block. Stops if the preconditioned residual of every column is
+     reduced by tol. Linearly dependent search directions restart the
+     block from the residuals, linearly dependent residuals stop the
+     iteration. Returns the number of iterations.
+  */
+  template <typename SCAL>
+  NGS_DLL_HEADER int BlockCG (const BaseMatrix & mat, const BaseMatrix * pre,
+                              const MultiVector & rhs, MultiVector & sol,
+                              double tol, int maxsteps,
+                              bool initialize = true, int printrates = 0);
+
+  /**
+     Block GMRES (left preconditioned) for several right hand sides.
+     Block Arnoldi by Gram-Schmidt on multivectors, the Hessenberg
+     matrix is reduced by Householder reflections as it grows. Linearly
+     dependent basis vectors are dropped (deflation). Restarts after
+     restart block steps, restart <= 0 means no restart.
+  */
+  template <typename SCAL>
+  NGS_DLL_HEADER int BlockGMRes (const BaseMatrix & mat, const BaseMatrix * pre,
+                                 const MultiVector & rhs, MultiVector & sol,
+                                 double tol, int maxsteps,
+                                 bool initialize = true, int printrates = 0,
+                                 int restart = 50);
+
+
+
   /*
 
   // Conjugate residual solver for symmetric, indefinite matrices
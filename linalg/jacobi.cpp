@@ -111,6 +111,73 @@ namespace ngla
   }
 
 
+  /*
+    Greedy coloring such that rows of the same color neither read nor
+    write each other's unknowns, 32 colors are tried per sweep.
+  */
+  template <class TM, class TV_ROW, class TV_COL>
+  void JacobiPrecond<TM,TV_ROW,TV_COL> ::
+  CalcColoring () const
+  {
+    static Timer t("JacobiPrecond::CalcColoring"); RegionTimer r(t);
+
+    Array<int> rowcolor(height);
+    rowcolor = -1;
+    size_t ninner = 0;
+    for (int i = 0; i < height; i++)
+      if (!inner || inner->Test(i))
+        ninner++;
+
+    // mask[i] .. colors of rows reading i, bit[i] .. color of row i
+    Array<unsigned int> mask(height), bit(height);
+    int maxcolor = -1;
+    int basecol = 0;
+    size_t found = 0;
+    while (found < ninner)
+      {
+        mask = 0;
+        bit = 0;
+        for (int i = 0; i < height; i++)
+          {
+            if (rowcolor[i] >= 0 || (inner && !inner->Test(i))) continue;
+
+            unsigned check = mask[i];
+            for (int j : mat.GetRowIndices(i))
+              check |= bit[j];
+            if (check == UINT_MAX) continue;
+
+            unsigned checkbit = 1;
+            int color = basecol;
+            while (check & checkbit)
+              {
+                color++;
+                checkbit *= 2;
+              }
+            rowcolor[i] = color;
+            maxcolor = max2(maxcolor, color);
+            found++;
+
+            bit[i] = checkbit;
+            for (int j : mat.GetRowIndices(i))
+              mask[j] |= checkbit;
+          }
+        basecol += 8*sizeof(unsigned int);
+      }
+
+    TableCreator<int> creator(maxcolor+1);
+    for ( ; !creator.Done(); creator++)
+      for (int i = 0; i < height; i++)
+        if (rowcolor[i] >= 0)
+          creator.Add (rowcolor[i], i);
+    coloring = creator.MoveTable();
+
+    color_balance.SetSize (coloring.Size());
+    for (auto c : Range(coloring))
+      color_balance[c].Calc (coloring[c].Size(),
+                             [&] (size_t i)
+                             { return mat.GetRowIndices(coloring[c][i]).Size(); });
+  }
+  
   ///
   template <class TM, class TV_ROW, class TV_COL>
   void JacobiPrecond<TM,TV_ROW,TV_COL> ::
@@ -123,6 +190,22 @@ namespace ngla
     FlatVector<TV_ROW> fx = x.FV<TV_ROW> ();
     const FlatVector<TV_ROW> fb = b.FV<TV_ROW> ();
 
+    if (task_manager)
+      {
+        std::call_once (coloring_computed, [this] () { CalcColoring(); });
+        for (auto c : Range(coloring))
+          ParallelForRange
+            (color_balance[c], [&] (IntRange r)
+             {
+               for (int i : coloring[c].Range(r))
+                 {
+                   TV_ROW ax = mat.RowTimesVector (i, fx);
+                   fx(i) += invdiag[i] * (fb(i) - ax);
+                 }
+             });
+        return;
+      }
+
     for (int i = 0; i < height; i++)
       if (!this->inner || this->inner->Test(i))
 	{
@@ -144,6 +227,23 @@ namespace ngla
     FlatVector<TV_ROW> fx = x.FV<TV_ROW> ();
     const FlatVector<TV_ROW> fb = b.FV<TV_ROW> ();
 
+    if (task_manager)
+      {
+        // colors in reverse order, the adjoint of GSSmooth
+        std::call_once (coloring_computed, [this] () { CalcColoring(); });
+        for (int c = coloring.Size()-1; c >= 0; c--)
+          ParallelForRange
+            (color_balance[c], [&] (IntRange r)
+             {
+               for (int i : coloring[c].Range(r))
+                 {
+                   TV_ROW ax = mat.RowTimesVector (i, fx);
+                   fx(i) += invdiag[i] * (fb(i) - ax);
+                 }
+             });
+        return;
+      }
+
     for (int i = height-1; i >= 0; i--)
       if (!this->inner || this->inner->Test(i))
 	{
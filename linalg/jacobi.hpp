@@ -52,6 +52,13 @@ namespace ngla
     int height;
     ///
     Array<TM> invdiag;
+    /// coloring of the inner rows for parallel Gauss-Seidel, built on first use
+    mutable Table<int> coloring;
+    ///
+    mutable Array<Partitioning> color_balance;
+    mutable std::once_flag coloring_computed;
+
+    void CalcColoring () const;
   public:
     // typedef typename mat_traits<TM>::TV_ROW TVX;
     typedef typename mat_traits<TM>::TSCAL TSCAL;
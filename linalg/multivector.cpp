@@ -280,6 +280,9 @@ namespace ngla {
     return Rfactor;
   }
   
+  template Matrix<double> MultiVector::T_Orthogonalize<double> (BaseMatrix * ipmat);
+  template Matrix<Complex> MultiVector::T_Orthogonalize<Complex> (BaseMatrix * ipmat);
+  
   void MultiVector :: Orthogonalize (BaseMatrix * ipmat)
   {
     if (IsComplex())
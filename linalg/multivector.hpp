@@ -160,6 +160,7 @@ namespace ngla {
     using MultiVector::MultiVector;
 
     unique_ptr<MultiVector> Range(IntRange r) const override;
+    unique_ptr<MultiVector> SubSet(const Array<int> & indices) const override;
     void SetScalar (double s) override;
     void Add (const MultiVector & v2, FlatMatrix<double> mat) override;
     void Add (const MultiVector & v2, FlatMatrix<Complex> mat) override;
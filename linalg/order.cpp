@@ -35,6 +35,398 @@ namespace ngla
     ar.Do(connected, nconnected);
   }
   
+  /*
+    Nested dissection by multilevel graph bisection:
+    coarsen by heavy edge matching, bisect the coarsest graph by
+    graph growing, and refine the cut greedily on the way back.
+    The vertex separator is built from the boundary of the edge cut.
+  */
+
+  // local graph in compressed row storage, with vertex and edge weights
+  class NDGraph
+  {
+  public:
+    Array<int> firsti, colnr, ewgt, vwgt;
+
+    int Size() const { return vwgt.Size(); }
+    int TotalWeight() const
+    {
+      int sum = 0;
+      for (int w : vwgt) sum += w;
+      return sum;
+    }
+  };
+
+  // a subgraph still to be dissected, its vertices get the numbers from offset on
+  class NDSubGraph
+  {
+  public:
+    NDGraph g;
+    Array<int> verts;
+    int offset = 0, parentnode = -1;
+  };
+
+  static bool CoarsenGraph (const NDGraph & g, NDGraph & coarse, Array<int> & cmap)
+  {
+    int n = g.Size();
+    Array<int> match(n), rep;
+    match = -1;
+    cmap.SetSize(n);
+
+    // heavy edge matching
+    for (int v = 0; v < n; v++)
+      if (match[v] == -1)
+        {
+          int best = v, bestw = 0;
+          for (int j = g.firsti[v]; j < g.firsti[v+1]; j++)
+            {
+              int w = g.colnr[j];
+              if (match[w] == -1 && w != v && g.ewgt[j] > bestw)
+                {
+                  best = w;
+                  bestw = g.ewgt[j];
+                }
+            }
+          match[v] = best;
+          match[best] = v;
+          cmap[v] = cmap[best] = rep.Size();
+          rep.Append (v);
+        }
+
+    int nc = rep.Size();
+    if (nc > 0.9 * n) return false;
+
+    coarse.vwgt.SetSize(nc);
+    coarse.firsti.SetSize(nc+1);
+    coarse.colnr.SetSize0();
+    coarse.ewgt.SetSize0();
+
+    Array<int> pos(nc);
+    pos = -1;
+    for (int c = 0; c < nc; c++)
+      {
+        coarse.firsti[c] = coarse.colnr.Size();
+        int v = rep[c], w = match[v];
+        coarse.vwgt[c] = g.vwgt[v] + ((w != v) ? g.vwgt[w] : 0);
+
+        for (int u : { v, w })
+          {
+            for (int j = g.firsti[u]; j < g.firsti[u+1]; j++)
+              {
+                int cc = cmap[g.colnr[j]];
+                if (cc == c) continue;
+                if (pos[cc] == -1)
+                  {
+                    pos[cc] = coarse.colnr.Size();
+                    coarse.colnr.Append (cc);
+                    coarse.ewgt.Append (g.ewgt[j]);
+                  }
+                else
+                  coarse.ewgt[pos[cc]] += g.ewgt[j];
+              }
+            if (w == v) break;
+          }
+        for (size_t j = coarse.firsti[c]; j < coarse.colnr.Size(); j++)
+          pos[coarse.colnr[j]] = -1;
+      }
+    coarse.firsti[nc] = coarse.colnr.Size();
+    return true;
+  }
+
+  // bfs from start, returns the last vertex reached
+  static int PseudoPeripheralVertex (const NDGraph & g, int start)
+  {
+    int n = g.Size();
+    Array<int> visited(n), queue;
+    for (int sweep = 0; sweep < 2; sweep++)
+      {
+        visited = 0;
+        queue.SetSize0();
+        queue.Append (start);
+        visited[start] = 1;
+        for (size_t qi = 0; qi < queue.Size(); qi++)
+          {
+            int v = queue[qi];
+            for (int j = g.firsti[v]; j < g.firsti[v+1]; j++)
+              if (!visited[g.colnr[j]])
+                {
+                  visited[g.colnr[j]] = 1;
+                  queue.Append (g.colnr[j]);
+                }
+          }
+        start = queue[queue.Size()-1];
+      }
+    return start;
+  }
+
+  // grow part 0 from a peripheral vertex until it has half of the weight
+  static void InitialBisection (const NDGraph & g, Array<int> & part)
+  {
+    int n = g.Size();
+    part.SetSize(n);
+    part = 1;
+    if (n == 0) return;
+
+    int half = g.TotalWeight() / 2;
+    Array<int> visited(n), queue;
+    visited = 0;
+
+    int start = PseudoPeripheralVertex (g, 0);
+    queue.Append (start);
+    visited[start] = 1;
+
+    int w0 = 0, seed = 0;
+    size_t qi = 0;
+    while (w0 < half)
+      {
+        if (qi == queue.Size())
+          {
+            // continue in the next connected component
+            while (visited[seed]) seed++;
+            visited[seed] = 1;
+            queue.Append (seed);
+          }
+        int v = queue[qi++];
+        part[v] = 0;
+        w0 += g.vwgt[v];
+        for (int j = g.firsti[v]; j < g.firsti[v+1]; j++)
+          if (!visited[g.colnr[j]])
+            {
+              visited[g.colnr[j]] = 1;
+              queue.Append (g.colnr[j]);
+            }
+      }
+  }
+
+  // greedy boundary refinement of the edge cut
+  static void RefineBisection (const NDGraph & g, FlatArray<int> part)
+  {
+    int n = g.Size();
+    int total = g.TotalWeight();
+    int limit = (total * 11) / 20 + 1;
+    int wpart[2] = { 0, 0 };
+    for (int v = 0; v < n; v++)
+      wpart[part[v]] += g.vwgt[v];
+
+    for (int pass = 0; pass < 8; pass++)
+      {
+        int moved = 0;
+        for (int v = 0; v < n; v++)
+          {
+            int p = part[v];
+            int ext = 0, internal = 0;
+            for (int j = g.firsti[v]; j < g.firsti[v+1]; j++)
+              if (part[g.colnr[j]] == p)
+                internal += g.ewgt[j];
+              else
+                ext += g.ewgt[j];
+            if (ext == 0) continue;
+
+            int gain = ext - internal;
+            int vw = g.vwgt[v];
+            if ( (gain > 0 && wpart[1-p] + vw <= limit) ||
+                 (gain == 0 && wpart[p] > wpart[1-p] + vw) )
+              {
+                part[v] = 1-p;
+                wpart[p] -= vw;
+                wpart[1-p] += vw;
+                moved++;
+              }
+          }
+        if (!moved) break;
+      }
+  }
+
+  static void MultilevelBisection (const NDGraph & g, Array<int> & part)
+  {
+    NDGraph coarse;
+    Array<int> cmap, cpart;
+    if (g.Size() < 100 || !CoarsenGraph (g, coarse, cmap))
+      InitialBisection (g, part);
+    else
+      {
+        MultilevelBisection (coarse, cpart);
+        part.SetSize (g.Size());
+        for (int v = 0; v < g.Size(); v++)
+          part[v] = cpart[cmap[v]];
+      }
+    RefineBisection (g, part);
+  }
+
+  // the subgraph of all vertices v with part[v] == p
+  static void ExtractSubGraph (const NDGraph & g, FlatArray<int> verts, FlatArray<int> part, int p,
+                               NDGraph & sub, Array<int> & subverts)
+  {
+    int n = g.Size();
+    Array<int> index(n);
+    subverts.SetSize0();
+    for (int v = 0; v < n; v++)
+      if (part[v] == p)
+        {
+          index[v] = subverts.Size();
+          subverts.Append (verts[v]);
+        }
+      else
+        index[v] = -1;
+
+    int ns = subverts.Size();
+    sub.vwgt.SetSize(ns);
+    sub.firsti.SetSize(ns+1);
+    sub.colnr.SetSize0();
+    sub.ewgt.SetSize0();
+    for (int v = 0; v < n; v++)
+      if (part[v] == p)
+        {
+          int i = index[v];
+          sub.firsti[i] = sub.colnr.Size();
+          sub.vwgt[i] = g.vwgt[v];
+          for (int j = g.firsti[v]; j < g.firsti[v+1]; j++)
+            if (index[g.colnr[j]] != -1)
+              {
+                sub.colnr.Append (index[g.colnr[j]]);
+                sub.ewgt.Append (g.ewgt[j]);
+              }
+        }
+    sub.firsti[ns] = sub.colnr.Size();
+  }
+
+
+  NestedDissection :: NestedDissection (const Table<int> & graph, FlatArray<int> vertices, int aleafsize)
+    : leafsize(aleafsize)
+  {
+    static Timer t("NestedDissection"); RegionTimer reg(t);
+
+    int nv = graph.Size();
+    int n = vertices.Size();
+    Array<int> index(nv);
+    index = -1;
+    for (int i = 0; i < n; i++)
+      index[vertices[i]] = i;
+
+    NDGraph g;
+    g.vwgt.SetSize(n);
+    g.vwgt = 1;
+    g.firsti.SetSize(n+1);
+    for (int i = 0; i < n; i++)
+      {
+        g.firsti[i] = g.colnr.Size();
+        for (int w : graph[vertices[i]])
+          if (index[w] != -1 && index[w] != i)
+            {
+              g.colnr.Append (index[w]);
+              g.ewgt.Append (1);
+            }
+      }
+    g.firsti[n] = g.colnr.Size();
+
+    order.SetSize(n);
+
+    /*
+      The separator tree is built level by level, all subgraphs of one
+      level are dissected in parallel. Nodes are numbered in the order of
+      the levels, so the numbering does not depend on the scheduling.
+    */
+    Array<NDSubGraph> level(1);
+    level[0].g = std::move(g);
+    level[0].verts = Array<int>(vertices);
+
+    while (level.Size())
+      {
+        Array<NDSubGraph> parts(2*level.Size());
+        Array<IntRange> ranges(level.Size());
+        Array<bool> split(level.Size());
+
+        ParallelFor (level.Size(), [&] (size_t i)
+          {
+            auto & sg = level[i];
+            int nsub = sg.g.Size();
+            split[i] = Dissect (sg, parts[2*i], parts[2*i+1]);
+            if (split[i])
+              ranges[i] = IntRange(parts[2*i+1].offset+parts[2*i+1].verts.Size(), sg.offset+nsub);
+            else
+              ranges[i] = IntRange(sg.offset, sg.offset+nsub);
+          });
+
+        Array<NDSubGraph> next_level;
+        for (size_t i = 0; i < level.Size(); i++)
+          {
+            int node = nodes.Size();
+            nodes.Append (ranges[i]);
+            parent.Append (level[i].parentnode);
+            if (split[i])
+              for (int p = 0; p < 2; p++)
+                {
+                  parts[2*i+p].parentnode = node;
+                  next_level.Append (std::move(parts[2*i+p]));
+                }
+          }
+        level = std::move(next_level);
+      }
+  }
+
+
+  /*
+    dissects the subgraph sg, the separator gets the last numbers, the two
+    parts are returned in sub0 and sub1. Leaves are numbered directly, then
+    false is returned.
+  */
+  bool NestedDissection :: Dissect (const NDSubGraph & sg, NDSubGraph & sub0, NDSubGraph & sub1)
+  {
+    auto & g = sg.g;
+    FlatArray<int> verts = sg.verts;
+    int offset = sg.offset;
+    int n = g.Size();
+
+    Array<int> part;
+    if (n > leafsize)
+      {
+        MultilevelBisection (g, part);
+
+        // vertex separator: the boundary vertices of the side with fewer of them
+        Array<int> boundary(n);
+        int nb[2] = { 0, 0 };
+        for (int v = 0; v < n; v++)
+          {
+            boundary[v] = 0;
+            for (int j = g.firsti[v]; j < g.firsti[v+1]; j++)
+              if (part[g.colnr[j]] != part[v])
+                boundary[v] = 1;
+            nb[part[v]] += boundary[v];
+          }
+        int sepside = (nb[0] <= nb[1]) ? 0 : 1;
+        int cnt[3] = { 0, 0, 0 };
+        for (int v = 0; v < n; v++)
+          {
+            if (boundary[v] && part[v] == sepside)
+              part[v] = 2;
+            cnt[part[v]]++;
+          }
+        if (cnt[0] == 0 || cnt[1] == 0)
+          part.SetSize0();   // no progress, treat as leaf
+      }
+
+    if (part.Size() == 0)
+      {
+        order.Range(offset, offset+n) = verts;
+        return false;
+      }
+
+    ExtractSubGraph (g, verts, part, 0, sub0.g, sub0.verts);
+    ExtractSubGraph (g, verts, part, 1, sub1.g, sub1.verts);
+    sub0.offset = offset;
+    sub1.offset = offset + sub0.verts.Size();
+
+    // separators are numbered after both parts
+    int sepfirst = sub1.offset + sub1.verts.Size();
+    for (int v = 0, cnt = sepfirst; v < n; v++)
+      if (part[v] == 2)
+        order[cnt++] = verts[v];
+    return true;
+  }
+
+
+
+
   MinimumDegreeOrdering :: MinimumDegreeOrdering (int an)
     :  n(an), 
        cliques(an), order(an), blocknr(an), vertices(an), 
@@ -428,7 +820,7 @@ namespace ngla
 	if (IsMaster (p3->GetVertexNr()))
 	  {
 	    int nclp3 = NumCliques (*p3);
-	    if ( nclp3 == 1)
+	    if ( nclp3 == 1 && SameGroup (v, *p3))
 	      {
 		// only in new clique ==> connect to v
 		SetMaster (v, *p3);
@@ -452,7 +844,7 @@ namespace ngla
             for (CliqueEl * p4 = p3->next; p4 != newp; p4 = p4->next)
               {
                 // have p3 and p4 equivalent cliques ?
-                if (IsMaster (*p4) && NumCliques(*p4) == nclp3)
+                if (IsMaster (*p4) && NumCliques(*p4) == nclp3 && SameGroup (*p3, *p4))
                   { 
                     bool samecl = true;
 
@@ -579,7 +971,7 @@ namespace ngla
     
     // t4.Start();
     // calc master degrees in new clique
-    if (anymaster)
+    if (anymaster && !prescribed.Size())
       {
         CliqueEl * p3 = anymaster;
         do
@@ -631,6 +1023,7 @@ namespace ngla
 
     int minj = -1;
     int lastel = -1;
+    size_t next_prescribed = 0;
 
     if (n > 5000)
       cout << IM(4) << "order " << flush;
@@ -666,6 +1059,18 @@ namespace ngla
 	    EliminateMinionVertex (minj);
 	  }
 
+	else if (prescribed.Size())
+	  {
+	    // next vertex of the prescribed order, or its master
+	    while (vertices[prescribed[next_prescribed]].Eliminated())
+	      next_prescribed++;
+	    minj = vertices[prescribed[next_prescribed]].Master();
+	    priqueue.Invalidate(minj);
+
+	    blocknr[i] = i;
+	    EliminateMasterVertex (minj);
+	  }
+
 	else
 	  {
 	    // find new master vertex
@@ -693,6 +1098,37 @@ namespace ngla
 
 
 
+  void MinimumDegreeOrdering :: OrderNestedDissection (int leafsize)
+  {
+    static Timer t("MinimumDegreeOrdering::OrderNestedDissection");
+    RegionTimer reg(t);
+
+    // graph from the initial edge-cliques
+    Array<int> used;
+    for (int v = 0; v < n; v++)
+      if (!vertices[v].Eliminated())
+        used.Append (v);
+
+    TableCreator<int> creator(n);
+    for ( ; !creator.Done(); creator++)
+      for (int v : used)
+        for (CliqueEl * p1 = cliques[v]; p1; p1 = p1->nextcl)
+          creator.Add (v, p1->next->GetVertexNr());
+    Table<int> graph = creator.MoveTable();
+
+    nd = make_shared<NestedDissection> (graph, used, leafsize);
+
+    prescribed = nd->order;
+    group.SetSize(n);
+    group = -1;
+    for (int i : Range(nd->nodes))
+      for (auto j : nd->nodes[i])
+        group[nd->order[j]] = i;
+
+    Order();
+  }
+
+  
   MinimumDegreeOrdering:: ~MinimumDegreeOrdering ()
   {
     // cout << "~MDO: all data should be deleted, please double-check" << endl;
@@ -138,6 +138,32 @@ namespace ngla
   };
   
 
+  class NDGraph;
+  class NDSubGraph;
+
+  /*
+    nested dissection ordering by multilevel graph bisection.
+    the separator of a subgraph is numbered after its two parts
+  */
+  class NGS_DLL_HEADER NestedDissection
+  {
+  public:
+    /// order[i] is the vertex eliminated in step i
+    Array<int> order;
+    /// nodes of the separator tree (leaves and separators), as ranges of elimination steps
+    Array<IntRange> nodes;
+    /// parent node in the separator tree, -1 for the root. Parents come before their children
+    Array<int> parent;
+
+    /// orders the given vertices of the graph
+    NestedDissection (const Table<int> & graph, FlatArray<int> vertices, int aleafsize = 64);
+
+  private:
+    int leafsize;
+    bool Dissect (const NDSubGraph & sg, NDSubGraph & sub0, NDSubGraph & sub1);
+  };
+
+
   ///
   class MinimumDegreeOrdering
   {
@@ -156,6 +182,12 @@ namespace ngla
     MDOPriorityQueue priqueue;
     ///
     ngstd::BlockAllocator ball;
+    /// eliminate in this order instead of by minimum degree
+    Array<int> prescribed;
+    /// with prescribed order, only vertices of the same group are merged
+    Array<int> group;
+    ///
+    shared_ptr<NestedDissection> nd;
   public:
     ///
     MinimumDegreeOrdering (int an);
@@ -175,6 +207,8 @@ namespace ngla
     void EliminateMinionVertex (int v);
     ///
     void Order();
+    /// nested dissection order, fill-in computed by symbolic elimination
+    void OrderNestedDissection (int leafsize = 64);
     /// 
     ~MinimumDegreeOrdering();
 
@@ -220,6 +254,11 @@ namespace ngla
 
     void SetMaster (int master, int minion);
 
+    bool SameGroup (int v1, int v2) const
+    {
+      return group.Size() == 0 || group[v1] == group[v2];
+    }
+
 
     void StartMemoryTracing() const
     {
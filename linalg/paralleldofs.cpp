@@ -101,6 +101,28 @@ namespace ngla
 	all_dist_procs.Append (i);
 
 
+    // exchange plan for ScatterDofData / ReduceDofData
+    Array<int> nmaster(ntasks), nslave(ntasks);
+    nmaster = 0;
+    nslave = 0;
+    for (int p : all_dist_procs)
+      for (int d : exchangedofs[p])
+        if (ismasterdof.Test(d))
+          nmaster[p]++;
+        else if (dist_procs[d][0] == p)
+          nslave[p]++;
+
+    master_exdofs = Table<int>(nmaster);
+    slave_exdofs = Table<int>(nslave);
+    nmaster = 0;
+    nslave = 0;
+    for (int p : all_dist_procs)
+      for (int d : exchangedofs[p])
+        if (ismasterdof.Test(d))
+          master_exdofs[p][nmaster[p]++] = d;
+        else if (dist_procs[d][0] == p)
+          slave_exdofs[p][nslave[p]++] = d;
+
 
     size_t nlocal = 0;
     for (int i = 0; i < ndof; i++)
@@ -112,6 +134,51 @@ namespace ngla
     for (auto dest : ngstd::Range(mpi_t.Size()))
       if ( IsExchangeProc(dest) )
 	MPI_Type_free(&mpi_t[dest]);
+    for (auto & buffers : exchange_buffers)
+      for (auto & req : buffers->requests)
+        MPI_Request_free (&req);
+  }
+
+  ParallelDofs::ExchangeBuffers & ParallelDofs ::
+  GetExchangeBuffers (size_t elsize, bool reduce) const
+  {
+    for (auto & buffers : exchange_buffers)
+      if (buffers->elsize == elsize && buffers->reduce == reduce)
+        return *buffers;
+
+    // reduce is the transposed communication of scatter
+    const Table<int> & send_dofs = reduce ? slave_exdofs : master_exdofs;
+    const Table<int> & recv_dofs = reduce ? master_exdofs : slave_exdofs;
+
+    auto buffers = make_unique<ExchangeBuffers>();
+    buffers->elsize = elsize;
+    buffers->reduce = reduce;
+    buffers->sendbuf.SetSize (elsize * send_dofs.AsArray().Size());
+    buffers->recvbuf.SetSize (elsize * recv_dofs.AsArray().Size());
+
+    size_t sendpos = 0, recvpos = 0;
+    for (int p : all_dist_procs)
+      {
+        if (size_t n = elsize * send_dofs[p].Size(); n > 0)
+          {
+            MPI_Request req;
+            MPI_Send_init (buffers->sendbuf.Data()+sendpos, n, MPI_BYTE, p,
+                           MPI_TAG_SOLVE, comm, &req);
+            buffers->requests.Append (req);
+            sendpos += n;
+          }
+        if (size_t n = elsize * recv_dofs[p].Size(); n > 0)
+          {
+            MPI_Request req;
+            MPI_Recv_init (buffers->recvbuf.Data()+recvpos, n, MPI_BYTE, p,
+                           MPI_TAG_SOLVE, comm, &req);
+            buffers->requests.Append (req);
+            recvpos += n;
+          }
+      }
+
+    exchange_buffers.Append (move(buffers));
+    return *exchange_buffers.Last();
   }
 
   shared_ptr<ParallelDofs> ParallelDofs :: SubSet (shared_ptr<BitArray> take_dofs) const
@@ -47,6 +47,22 @@ namespace ngla
     /// entry-size
     int es;
     bool complex;
+
+    /// proc 2 dofs I am master of, and dofs owned by proc
+    Table<int> master_exdofs, slave_exdofs;
+
+    /// packed buffers and persistent requests for one element size
+    struct ExchangeBuffers
+    {
+      size_t elsize;
+      bool reduce;
+      Array<char> sendbuf, recvbuf;
+      Array<MPI_Request> requests;
+    };
+    mutable Array<unique_ptr<ExchangeBuffers>> exchange_buffers;
+
+    /// buffers for Scatter (master -> slaves) or Reduce (slaves -> master)
+    ExchangeBuffers & GetExchangeBuffers (size_t elsize, bool reduce) const;
     
   public:
     /**
@@ -213,161 +229,56 @@ namespace ngla
     static Timer t0("ParallelDofs :: ReduceDofData");
     RegionTimer rt(t0);
 
-    auto comm = GetCommunicator();
-    int ntasks = comm.Size();
-    int rank = comm.Rank();
-    if (ntasks <= 1) return;
-
-
-    Array<int> nsend(ntasks), nrecv(ntasks);
-    nsend = 0;
-    nrecv = 0;
-
-    /** Count send/recv size **/
-    for (int i = 0; i < GetNDofLocal(); i++) {
-      auto dps = GetDistantProcs(i);
-      if(!dps.Size()) continue;
-      int master = min2(rank, dps[0]);
-      if(rank==master)
-	for(auto p:dps)
-	  nrecv[p]++;
-      else
-	nsend[master]++;
-    }
+    if (comm.Size() <= 1) return;
 
-    Table<T> send_data(nsend);
-    Table<T> recv_data(nrecv);
-
-    /** Fill send_data **/
-    nsend = 0;
-    for (int i = 0; i < GetNDofLocal(); i++) {
-      auto dps = GetDistantProcs(i);
-      if(!dps.Size()) continue;
-      int master = min2(rank, dps[0]);
-      if(master!=rank)
-	send_data[master][nsend[master]++] = data[i];
-    }
+    auto & buffers = GetExchangeBuffers (sizeof(T), true);
+    T * send_data = reinterpret_cast<T*> (buffers.sendbuf.Data());
+    T * recv_data = reinterpret_cast<T*> (buffers.recvbuf.Data());
 
-    Array<MPI_Request> requests; 
-    for (int i = 0; i < ntasks; i++)
-      {
-	if (nsend[i])
-	  requests.Append (comm.ISend(send_data[i], i, MPI_TAG_SOLVE));
-	if (nrecv[i])
-	  requests.Append (comm.IRecv(recv_data[i], i, MPI_TAG_SOLVE));
-      }
+    size_t cnt = 0;
+    for (auto p : all_dist_procs)
+      for (auto d : slave_exdofs[p])
+        send_data[cnt++] = data[d];
 
-    MyMPI_WaitAll (requests);
+    if (buffers.requests.Size())
+      MPI_Startall (buffers.requests.Size(), buffers.requests.Data());
+    MyMPI_WaitAll (buffers.requests);
 
-    Array<int> cnt(ntasks);
-    cnt = 0;
-    
+    // contributions to a dof are reduced in increasing proc order 
     MPI_Datatype type = GetMPIType<T>();
-    for (int i = 0; i < GetNDofLocal(); i++)
-      if (IsMasterDof(i))
-	{
-	  FlatArray<int> distprocs = GetDistantProcs (i);
-	  for (int j = 0; j < distprocs.Size(); j++)
-	    MPI_Reduce_local (&recv_data[distprocs[j]][cnt[distprocs[j]]++], 
-			      &data[i], 1, type, op);
-	}
+    cnt = 0;
+    for (auto p : all_dist_procs)
+      for (auto d : master_exdofs[p])
+        MPI_Reduce_local (&recv_data[cnt++], &data[d], 1, type, op);
   }    
 
 
 
-
-
   template <typename T>
   void ParallelDofs :: ScatterDofData (FlatArray<T> data) const
   {
     static Timer t0("ParallelDofs :: ScatterDofData");
     RegionTimer rt(t0);
 
-    NgMPI_Comm comm = GetCommunicator();
-    int ntasks = comm.Size();
-    int rank = comm.Rank();
-    if (ntasks <= 1) return;
-
-    Array<int> nsend(ntasks), nrecv(ntasks);
-    nsend = 0;
-    nrecv = 0;
-
-    /** Count send/recv size **/
-    /*
-    for (int i = 0; i < GetNDofLocal(); i++) {
-      auto dps = GetDistantProcs(i);
-      if(!dps.Size()) continue;
-      int master = min2(rank, dps[0]);
-      if(rank==master)
-	for(auto p:dps)
-	  nsend[p]++;
-      else
-	nrecv[master]++;
-    }
-    */
-    for (int i = 0; i < GetNDofLocal(); i++) 
-      if (auto dps = GetDistantProcs(i); dps.Size() > 0)
-        {
-          if (rank < dps[0])
-            for (auto p : dps)
-              nsend[p]++;
-          else
-            nrecv[dps[0]]++;
-        }
-    
-    Table<T> send_data(nsend);
-    Table<T> recv_data(nrecv);
-
-    /** Fill send_data **/
-    nsend = 0;
-    /*
-    for (int i = 0; i < GetNDofLocal(); i++) {
-      auto dps = GetDistantProcs(i);
-      if(!dps.Size()) continue;
-      int master = min2(rank, dps[0]);
-      if(rank==master)
-	for(auto p:dps)
-	  send_data[p][nsend[p]++] = data[i];
-    }
-    */
-    for (int i = 0; i < GetNDofLocal(); i++) 
-      if (auto dps = GetDistantProcs(i); dps.Size() > 0)
-        if (rank < dps[0])
-          for (auto p : dps)
-            send_data[p][nsend[p]++] = data[i];
-    
-    Array<MPI_Request> requests;
-    for (int i = 0; i < ntasks; i++)
-      {
-	if (nsend[i])
-	  requests.Append (comm.ISend (send_data[i], i, MPI_TAG_SOLVE));
-	if (nrecv[i])
-	  requests.Append (comm.IRecv (recv_data[i], i, MPI_TAG_SOLVE));
-      }
-
-    MyMPI_WaitAll (requests);
-
-    Array<int> cnt(ntasks);
-    cnt = 0;
+    if (comm.Size() <= 1) return;
 
-    /*
-    for (int i = 0; i < GetNDofLocal(); i++)
-      if (!IsMasterDof(i))
-	{
-	  FlatArray<int> distprocs = GetDistantProcs (i);
-	  
-	  int master = ntasks;
-	  for (int j = 0; j < distprocs.Size(); j++)
-	    master = min (master, distprocs[j]);
-	  data[i] = recv_data[master][cnt[master]++];
-	}
-    */
-    for (int i = 0; i < GetNDofLocal(); i++)
-      if (!IsMasterDof(i))
-	{
-	  int master = GetDistantProcs (i)[0];
-	  data[i] = recv_data[master][cnt[master]++];
-	}
+    auto & buffers = GetExchangeBuffers (sizeof(T), false);
+    T * send_data = reinterpret_cast<T*> (buffers.sendbuf.Data());
+    T * recv_data = reinterpret_cast<T*> (buffers.recvbuf.Data());
+
+    size_t cnt = 0;
+    for (auto p : all_dist_procs)
+      for (auto d : master_exdofs[p])
+        send_data[cnt++] = data[d];
+
+    if (buffers.requests.Size())
+      MPI_Startall (buffers.requests.Size(), buffers.requests.Data());
+    MyMPI_WaitAll (buffers.requests);
+
+    cnt = 0;
+    for (auto p : all_dist_procs)
+      for (auto d : slave_exdofs[p])
+        data[d] = recv_data[cnt++];
   }    
 
 #endif //PARALLEL
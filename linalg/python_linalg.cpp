@@ -1034,6 +1034,21 @@ inverse : string
     pardiso        - PARDISO, either provided by libpardiso (USE_PARDISO=ON) or Intel MKL (USE_MKL=ON).
                      If neither Pardiso nor Intel MKL was linked at compile-time, NGSolve will look
                      for libmkl_rt in LD_LIBRARY_PATH (Unix) or PATH (Windows) at run-time.
+
+  Options follow the solver name, separated by ':', e.g.
+  "sparsecholesky:multifrontal:ordering=nd" or "sparsecholesky:float:refinementtol=1e-12".
+  Options of sparsecholesky:
+    multifrontal       - supernodal multifrontal factorization (double and complex entries only,
+                         ignored with a warning for matrix valued entries)
+    ordering=nd        - nested dissection ordering instead of minimum degree,
+                         ndleafsize=64 sets the size of the leaves
+    float              - keep the factor in single precision, solutions are corrected
+                         by iterative refinement (double entries and vectors only)
+    refinementsteps=10 - maximal number of refinement steps
+    refinementtol=1e-10 - refinement stops at this relative residual
+    blrtol=0           - block low-rank compression of large blocks with this relative
+                         tolerance, 0 switches it off (double entries and vectors only)
+    blrminsize=64      - minimal block size for the low-rank compression
 )raw_string"), py::call_guard<py::gil_scoped_release>())
     // .def("Inverse", [](BM &m)  { return m.InverseMatrix(); })
 
@@ -1308,6 +1323,20 @@ inverse : string
   ExportSparseMatrix<Mat<3,3,double>>(m);
   ExportSparseMatrix<Mat<3,3,Complex>>(m);
 
+  py::class_<SparseMatrixProduct<double,double,double>>
+    (m, "SparseMatrixProduct", "sparse matrix product a*b, the sparsity pattern is computed once")
+    .def(py::init([] (const SparseMatrix<double> & a, const SparseMatrix<double> & b)
+                  { return new SparseMatrixProduct<double,double,double> (a, b); }),
+         py::arg("a"), py::arg("b"))
+    .def("Update", [] (SparseMatrixProduct<double,double,double> & self,
+                       const SparseMatrix<double> & a, const SparseMatrix<double> & b)
+         { self.Update (a, b); },
+         py::arg("a"), py::arg("b"), py::call_guard<py::gil_scoped_release>(),
+         "recompute the values of the product, the sparsity patterns of a and b must not change")
+    .def_property_readonly("mat", [] (SparseMatrixProduct<double,double,double> & self)
+                           -> shared_ptr<BaseMatrix> { return self.GetProduct(); })
+    ;
+
 
   py::class_<SparseMatrixDynamic<double>, shared_ptr<SparseMatrixDynamic<double>>, BaseMatrix>
     (m, "SparseMatrixDynamic")
@@ -1347,6 +1376,21 @@ inverse : string
                   }))
     ;
 
+  py::class_<SparseMatrixSELL<double>, shared_ptr<SparseMatrixSELL<double>>, BaseMatrix>
+    (m, "SparseMatrixSELL",
+     "sliced ELLPACK (SELL-C-sigma) copy of a real sparse matrix with non-symmetric storage,\n"
+     "with SIMD matrix-vector products. The transposed product is a slow path.")
+    .def(py::init([] (const BaseMatrix & mat, size_t sigma)
+                  {
+                    if (auto ptr = dynamic_cast<const SparseMatrixTM<double>*> (&mat); ptr)
+                      return make_shared<SparseMatrixSELL<double>> (*ptr, sigma);
+                    throw Exception("cannot create SparseMatrixSELL");
+                  }), py::arg("mat"), py::arg("sigma")=256,
+         "sigma: rows are sorted by length within windows of sigma rows")
+    .def_property_readonly("nze_padded", &SparseMatrixSELL<double>::NZEPadded,
+                           "number of stored entries including padding")
+    ;
+
   
   py::class_<BaseBlockJacobiPrecond, shared_ptr<BaseBlockJacobiPrecond>, BaseMatrix>
     (m, "BlockSmoother",
@@ -1382,6 +1426,9 @@ inverse : string
 
   py::class_<SparseCholesky<double>, shared_ptr<SparseCholesky<double>>, SparseFactorization> (m, "SparseCholesky_d")
     .def(NGSPickle<SparseCholesky<double>>())
+    .def_property_readonly("refinementsteps", [] (SparseCholesky<double> & self)
+                           { return self.GetRefinementSteps(); },
+                           "iterative refinement steps of the last solve with the float or blr factor")
     ;
   py::class_<SparseCholesky<Complex>, shared_ptr<SparseCholesky<Complex>>, SparseFactorization> (m, "SparseCholesky_c")
     .def(NGSPickle<SparseCholesky<Complex>>())
@@ -1515,6 +1562,57 @@ precision : float
 maxsteps : int
   input maximal steps. CGSolver stops after this steps.
 
+)raw_string"))
+    ;
+
+  m.def("PipelinedCGSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre,
+                                bool iscomplex, bool printrates,
+                                double precision, int maxsteps, bool conjugate)
+        {
+          shared_ptr<KrylovSpaceSolver> solver;
+          if(mat->IsComplex()) iscomplex = true;
+
+          if (iscomplex)
+            {
+              if(conjugate)
+                solver = make_shared<PipelinedCGSolver<ComplexConjugate>>(mat, pre);
+              else
+                solver = make_shared<PipelinedCGSolver<Complex>> (mat, pre);
+            }
+          else
+            solver = make_shared<PipelinedCGSolver<double>> (mat, pre);
+          solver->SetPrecision(precision);
+          solver->SetMaxSteps(maxsteps);
+          solver->SetPrintRates (printrates);
+          return solver;
+        },
+        py::arg("mat"), py::arg("pre"), py::arg("complex") = false, py::arg("printrates")=true,
+        py::arg("precision")=1e-8, py::arg("maxsteps")=200, py::arg("conjugate")=false,
+        docu_string(R"raw_string(
+A pipelined CG Solver. Both inner products of an iteration are reduced
+in one non-blocking MPI reduction, which overlaps with the preconditioner
+and the matrix application. Pays off for MPI runs with many ranks.
+
+Parameters:
+
+mat : ngsolve.la.BaseMatrix
+  input matrix 
+
+pre : ngsolve.la.BaseMatrix
+  input preconditioner matrix
+
+complex : bool
+  input complex, if not set it is deduced from matrix type
+
+printrates : bool
+  input printrates
+
+precision : float
+  input requested precision. PipelinedCGSolver stops if precision is reached.
+
+maxsteps : int
+  input maximal steps. PipelinedCGSolver stops after this steps.
+
 )raw_string"))
     ;
 
@@ -1553,6 +1651,89 @@ precision : float
 maxsteps : int
   input maximal steps. GMRESSolver stops after this steps.
 
+)raw_string"))
+    ;
+
+  m.def("BlockCG", [](shared_ptr<BaseMatrix> mat, shared_ptr<MultiVector> rhs, shared_ptr<MultiVector> sol,
+                      shared_ptr<BaseMatrix> pre, double tol, int maxsteps, bool initialize, bool printrates)
+        {
+          if (mat->IsComplex())
+            return BlockCG<Complex> (*mat, pre.get(), *rhs, *sol, tol, maxsteps, initialize, printrates);
+          return BlockCG<double> (*mat, pre.get(), *rhs, *sol, tol, maxsteps, initialize, printrates);
+        },
+        py::arg("mat"), py::arg("rhs"), py::arg("sol"), py::arg("pre")=nullptr,
+        py::arg("tol")=1e-8, py::arg("maxsteps")=200, py::arg("initialize")=true,
+        py::arg("printrates")=false, py::call_guard<py::gil_scoped_release>(), docu_string(R"raw_string(
+Block CG solver for several right hand sides of a symmetric positive
+definite matrix. The matrix is applied to all active columns at once,
+converged columns are removed from the block.
+
+Parameters:
+
+mat : ngsolve.la.BaseMatrix
+  input matrix
+
+rhs : ngsolve.la.MultiVector
+  right hand sides
+
+sol : ngsolve.la.MultiVector
+  solutions, used as initial guess if initialize is False
+
+pre : ngsolve.la.BaseMatrix
+  preconditioner
+
+tol : float
+  relative reduction of the preconditioned residual of every column
+
+maxsteps : int
+  maximal number of iterations
+
+Returns the number of iterations.
+
+)raw_string"))
+    ;
+
+  m.def("BlockGMRes", [](shared_ptr<BaseMatrix> mat, shared_ptr<MultiVector> rhs, shared_ptr<MultiVector> sol,
+                         shared_ptr<BaseMatrix> pre, double tol, int maxsteps, bool initialize, bool printrates,
+                         int restart)
+        {
+          if (mat->IsComplex())
+            return BlockGMRes<Complex> (*mat, pre.get(), *rhs, *sol, tol, maxsteps, initialize, printrates, restart);
+          return BlockGMRes<double> (*mat, pre.get(), *rhs, *sol, tol, maxsteps, initialize, printrates, restart);
+        },
+        py::arg("mat"), py::arg("rhs"), py::arg("sol"), py::arg("pre")=nullptr,
+        py::arg("tol")=1e-8, py::arg("maxsteps")=100, py::arg("initialize")=true,
+        py::arg("printrates")=false, py::arg("restart")=50,
+        py::call_guard<py::gil_scoped_release>(), docu_string(R"raw_string(
+Block GMRES solver (left preconditioned, restarted) for several
+right hand sides.
+
+Parameters:
+
+mat : ngsolve.la.BaseMatrix
+  input matrix
+
+rhs : ngsolve.la.MultiVector
+  right hand sides
+
+sol : ngsolve.la.MultiVector
+  solutions, used as initial guess if initialize is False
+
+pre : ngsolve.la.BaseMatrix
+  preconditioner
+
+tol : float
+  relative reduction of the preconditioned residual of every column
+
+maxsteps : int
+  maximal number of block iterations
+
+restart : int
+  number of block iterations before a restart, bounds the memory for the
+  Krylov basis. restart <= 0 means no restart.
+
+Returns the number of iterations.
+
 )raw_string"))
     ;
 
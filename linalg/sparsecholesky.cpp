@@ -140,6 +140,19 @@ namespace ngla
     static Timer t("SparseCholesky - total");
     static Timer ta("SparseCholesky - allocate");
     RegionTimer reg(t);
+    multifrontal = a->GetInverseFlags().GetDefineFlag("multifrontal");
+    if constexpr (!is_same<TM,double>::value && !is_same<TM,Complex>::value)
+      if (multifrontal)
+        {
+          cout << "warning: sparsecholesky:multifrontal is only available for scalar entries, using the standard factorization" << endl;
+          multifrontal = false;
+        }
+    single_precision = a->GetInverseFlags().GetDefineFlag("float");
+    max_refinement_steps = a->GetInverseFlags().GetNumFlag("refinementsteps", 10);
+    refinement_tol = a->GetInverseFlags().GetNumFlag("refinementtol", 1e-10);
+    blr_tol = a->GetInverseFlags().GetNumFlag("blrtol", 0);
+    blr_minsize = a->GetInverseFlags().GetNumFlag("blrminsize", 64);
+
     GetMemoryTracer().SetName("SparseCholesky");
     GetMemoryTracer().Track(order, "order",
                             inv_order, "inv_order",
@@ -241,7 +254,11 @@ namespace ngla
       cout << IM(4) << "start ordering" << endl;
     
     // mdo -> PrintCliques ();
-    mdo->Order();
+    auto & inverseflags = a->GetInverseFlags();
+    if (inverseflags.GetStringFlag("ordering", "mdo") == "nd")
+      mdo->OrderNestedDissection (inverseflags.GetNumFlag("ndleafsize", 64));
+    else
+      mdo->Order();
     nused = mdo->nused;
     endtime = clock();
     if (printstat)
@@ -257,6 +274,14 @@ namespace ngla
     Allocate (mdo->order,  mdo->vertices, mdo->blocknr.Data());
     ta.Stop();
 
+    if (mdo->nd)
+      {
+        separator_parent = mdo->nd->parent;
+        separator_node.SetSize (nused);
+        for (int i = 0; i < nused; i++)
+          separator_node[i] = mdo->group[mdo->order[i]];
+      }
+
     delete mdo;
     mdo = 0;
 
@@ -547,7 +572,11 @@ namespace ngla
       & firstinrow & diag & rowindex2 & firstinrow_ri &
       blocknrs & blocks & block_dependency & microtasks
       & micro_dependency & micro_dependency_trans & mdo
-      & maxrow;
+      & maxrow & multifrontal
+      & lfact_single & single_precision & release_double_factor
+      & max_refinement_steps & refinement_tol
+      & blr_tol & blr_minsize & blr_block & blr_rank & blr_first & blr_data
+      & lfact_blr & firstinrow_blr;
   }
 
   template <class TM>
@@ -561,6 +590,8 @@ namespace ngla
 	cout << IM(4) << "SparseCholesky::FactorNew called with matrix of different size." << endl;
 	return;
       }
+    if (lfact.Size() != nze)  // released after single precision copy
+      lfact = NumaInterleavedArray<TM> (nze);
     lfact = TM(0.0);
 
     if (!inner && !cluster)
@@ -603,6 +634,148 @@ namespace ngla
 	}
     tf.Stop();
     FactorSPD(); 
+
+    if constexpr (is_same<TM,double>::value)
+      if (single_precision)
+        {
+          // keep the factor in float, the double one is released
+          // by SparseCholesky if all solves are refined
+          lfact_single = NumaInterleavedArray<float> (nze);
+          ParallelForRange (nze, [&] (IntRange r)
+                            {
+                              for (auto i : r)
+                                lfact_single[i] = lfact[i];
+                            });
+          if (release_double_factor)
+            lfact = NumaInterleavedArray<TM> (0);
+        }
+
+    if constexpr (is_same<TM,double>::value)
+      if (blr_tol > 0 && !single_precision)
+        CompressBlockLowRank();
+  }
+
+
+  template <class TM>
+  void SparseCholeskyTM<TM> :: CompressBlockLowRank ()
+  {
+    static Timer t("SparseCholesky - BLR compression");
+    RegionTimer reg(t);
+
+    blr_block.SetSize0();
+    size_t nblocks = blocks.Size()-1;
+    if constexpr (is_same<TM,double>::value)
+      {
+        // the external part B (size x extsize) of a block, as truncated SVD B = U V^T
+        Array<Matrix<>> bu(nblocks), bv(nblocks);
+        ParallelFor (nblocks, [&] (size_t bnr)
+          {
+            auto range = BlockDofs (bnr);
+            auto extdofs = BlockExtDofs (bnr);
+            size_t nb = range.Size(), ne = extdofs.Size();
+            if (min(nb, ne) < blr_minsize) return;
+
+            Matrix<> b(nb, ne);
+            for (size_t i = 0; i < nb; i++)
+              b.Row(i) = FlatVector<>(ne, &lfact[firstinrow[range.First()+i] + nb-i-1]);
+
+            // thin QR of B or B^T, whichever is tall, and SVD of the small
+            // square factor: O(nb ne min(nb,ne)) instead of O(max(nb,ne)^3)
+            bool trans = ne >= nb;
+            size_t m = max(nb, ne), r = min(nb, ne);
+            Matrix<> a(m, r), q(m, r);
+            if (trans)
+              a = Trans(b);
+            else
+              a = b;
+            QRFactorization (a, q);
+            Matrix<> rfac = a.Rows(0, r);
+            Matrix<double,ColMajor> ur(r), vr(r);
+            CalcSVD (rfac, ur, vr);   // singular values on the diagonal of rfac
+
+            // B = u diag(sigma) v^T
+            Matrix<> u(nb, r), v(ne, r);
+            if (trans)
+              {
+                u = vr;
+                v = q * ur;
+              }
+            else
+              {
+                u = q * ur;
+                v = vr;
+              }
+
+            auto sigma = rfac.Diag(0);
+            double maxsigma = 0;
+            for (size_t i = 0; i < sigma.Size(); i++)
+              maxsigma = max2(maxsigma, fabs(sigma(i)));
+            Array<int> keep;
+            for (size_t i = 0; i < sigma.Size(); i++)
+              if (fabs(sigma(i)) > blr_tol * maxsigma)
+                keep.Append(i);
+            size_t k = keep.Size();
+            if (k*(nb+ne) >= nb*ne) return;
+
+            bu[bnr].SetSize(nb, k);
+            bv[bnr].SetSize(ne, k);
+            for (size_t j = 0; j < k; j++)
+              {
+                bu[bnr].Col(j) = sigma(keep[j]) * u.Col(keep[j]);
+                bv[bnr].Col(j) = v.Col(keep[j]);
+              }
+          });
+
+        size_t ncomp = 0, ndata = 0;
+        for (size_t bnr = 0; bnr < nblocks; bnr++)
+          if (bu[bnr].Height())
+            {
+              ncomp++;
+              ndata += bu[bnr].AsVector().Size() + bv[bnr].AsVector().Size();
+            }
+        cout << IM(4) << "BLR compressed " << ncomp << " of " << nblocks << " blocks" << endl;
+        if (ncomp == 0) return;
+
+        blr_block.SetSize(nblocks);
+        blr_block = -1;
+        blr_rank.SetSize0();
+        blr_first.SetSize0();
+        blr_data.SetSize(ndata);
+        for (size_t bnr = 0, pos = 0; bnr < nblocks; bnr++)
+          if (bu[bnr].Height())
+            {
+              blr_block[bnr] = blr_rank.Size();
+              blr_rank.Append (bu[bnr].Width());
+              blr_first.Append (pos);
+              size_t nu = bu[bnr].AsVector().Size(), nv = bv[bnr].AsVector().Size();
+              blr_data.Range(pos, pos+nu) = FlatArray<double>(nu, bu[bnr].Data());
+              pos += nu;
+              blr_data.Range(pos, pos+nv) = FlatArray<double>(nv, bv[bnr].Data());
+              pos += nv;
+            }
+
+        // the factor without the compressed external parts
+        firstinrow_blr.SetSize (firstinrow.Size());
+        firstinrow_blr[0] = 0;
+        for (size_t bnr = 0; bnr < nblocks; bnr++)
+          for (auto i : BlockDofs(bnr))
+            {
+              size_t len = firstinrow[i+1]-firstinrow[i];
+              if (blr_block[bnr] >= 0)
+                len = BlockDofs(bnr).end()-i-1;
+              firstinrow_blr[i+1] = firstinrow_blr[i] + len;
+            }
+
+        lfact_blr = NumaInterleavedArray<TM> (firstinrow_blr.Last());
+        ParallelFor (nblocks, [&] (size_t bnr)
+          {
+            for (auto i : BlockDofs(bnr))
+              for (size_t j = 0; j < firstinrow_blr[i+1]-firstinrow_blr[i]; j++)
+                lfact_blr[firstinrow_blr[i]+j] = lfact[firstinrow[i]+j];
+          });
+        if (release_double_factor)
+          lfact = NumaInterleavedArray<TM> (0);
+      }
   }
  
 
@@ -965,6 +1138,12 @@ namespace ngla
         return;
       }
 
+    if (multifrontal)
+      {
+        FactorMultifrontal (dummy);
+        return;
+      }
+
     static Timer factor_timer("SparseCholesky::Factor SPD");
     static Timer factor_dense1("SparseCholesky::Factor SPD - setup dense cholesky");
     static Timer factor_dense("SparseCholesky::Factor SPD - dense cholesky");
@@ -1532,6 +1711,212 @@ namespace ngla
 
 
 
+  /*
+    Supernodal multifrontal factorization:
+    Every block (supernode) assembles its dense frontal matrix from the
+    original entries and the update matrices of its children in the
+    elimination tree, factors it with the dense LDL kernels, and passes the
+    Schur complement on to its parent. Blocks in disjoint subtrees run in
+    parallel, no locking of the L-factor is needed.
+   */
+  template <class TM> template<typename T>
+  void SparseCholeskyTM<TM> :: FactorMultifrontal (T dummy)
+  {
+    static Timer factor_timer("SparseCholesky::Factor multifrontal");
+    static Timer ttree("SparseCholesky::Factor multifrontal - etree");
+    RegionTimer reg (factor_timer);
+
+    size_t n = nused;
+    size_t nblocks = blocks.Size()-1;
+    if (n > 2000)
+      cout << IM(4) << " factor multifrontal " << flush;
+
+    size_t * hfirstinrow = firstinrow.Addr(0);
+    TM * hlfact = lfact.Addr(0);
+
+    // the parent of a block is the block of its first external dof
+    ttree.Start();
+    Array<int> block_of_dof(n);
+    ParallelFor (nblocks, [&] (size_t b)
+                 {
+                   block_of_dof.Range(BlockDofs(b)) = b;
+                 });
+
+    Array<int> parent(nblocks);
+    ParallelFor (nblocks, [&] (size_t b)
+                 {
+                   parent[b] = -1;
+                   if (BlockDofs(b).Size() && BlockExtDofs(b).Size())
+                     parent[b] = block_of_dof[BlockExtDofs(b)[0]];
+                 });
+
+    TableCreator<int> creator(nblocks);
+    TableCreator<int> creator_trans(nblocks);
+    for ( ; !creator.Done(); creator++, creator_trans++)
+      for (size_t b : Range(nblocks))
+        if (parent[b] != -1)
+          {
+            creator.Add (b, parent[b]);
+            creator_trans.Add (parent[b], b);
+          }
+    Table<int> etree = creator.MoveTable();
+    Table<int> children = creator_trans.MoveTable();
+    ttree.Stop();
+
+    // Schur complements waiting for the parent
+    Array<Matrix<TM,ColMajor>> update(nblocks);
+
+    auto factor_block = [&] (int blocknr)
+       {
+         IntRange block = BlockDofs(blocknr);
+         if (block.Size() == 0) return;
+
+         size_t i1 = block.First();
+         size_t last_same = block.Next();
+         size_t mi = block.Size();
+         size_t nk = hfirstinrow[i1+1] - hfirstinrow[i1] + 1;
+         auto ext = BlockExtDofs(blocknr);
+
+         // frontal matrix, lower triangle: block dofs first, then ext dofs
+         ArrayMem<TM,1000> tmpmem(nk*nk);
+         FlatMatrix<TM,ColMajor> tmp(nk, nk, tmpmem.Addr(0));
+         tmp = TM(0.0);
+
+         for (size_t j = 0; j < mi; j++)
+           {
+             tmp(j,j) = diag[i1+j];
+             tmp.Col(j).Range(j+1,nk) = FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]);
+           }
+
+         // extend-add the update matrices of the children
+         for (int c : children[blocknr])
+           {
+             auto extc = BlockExtDofs(c);
+             auto & upd = update[c];
+             ArrayMem<size_t,100> local(extc.Size());
+
+             size_t j = 0;
+             for (size_t k : Range(extc))
+               {
+                 size_t dof = extc[k];
+                 if (dof < last_same)
+                   local[k] = dof - i1;
+                 else
+                   {
+                     while (j < ext.Size() && size_t(ext[j]) < dof) j++;
+                     if (j == ext.Size() || size_t(ext[j]) != dof)
+                       throw Exception ("SparseCholesky::FactorMultifrontal: inconsistent supernode structure");
+                     local[k] = mi + j;
+                   }
+               }
+
+             for (size_t l : Range(extc))
+               {
+                 auto col = tmp.Col(local[l]);
+                 auto ucol = upd.Col(l);
+                 for (size_t k = l; k < extc.Size(); k++)
+                   col(local[k]) += ucol(k);
+               }
+             upd = Matrix<TM,ColMajor>();
+           }
+
+         auto A11 = tmp.Rows(0,mi).Cols(0,mi);
+         auto B   = tmp.Rows(mi,nk).Cols(0,mi);
+         auto A22 = tmp.Rows(mi,nk).Cols(mi,nk);
+
+         CalcLDL (A11);
+         if (mi < nk)
+           {
+             CalcLDL_SolveL (A11,B);
+             CalcLDL_A2 (A11.Diag(),B,A22);
+           }
+
+         for (size_t j = 0; j < mi; j++)
+           {
+             diag[i1+j] = A11(j,j);
+             FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]) = tmp.Col(j).Range(j+1,nk);
+           }
+
+         if (parent[blocknr] != -1)
+           update[blocknr] = A22;
+       };
+
+    /*
+      With a nested dissection ordering the tasks are the nodes of the
+      separator tree, each node factors its blocks in order after all of its
+      subtrees are done. This needs every block within one node, and the
+      elimination tree parent in the same node or in an ancestor node.
+    */
+    bool use_separator_tree = separator_node.Size() == n;
+    Array<int> node_of_block(nblocks);
+    if (use_separator_tree)
+      for (size_t b = 0; b < nblocks; b++)
+        {
+          IntRange block = BlockDofs(b);
+          node_of_block[b] = block.Size() ? separator_node[block.First()] : -1;
+          for (auto d : block)
+            if (separator_node[d] != node_of_block[b])
+              use_separator_tree = false;
+        }
+    if (use_separator_tree)
+      for (size_t b = 0; b < nblocks; b++)
+        if (parent[b] != -1)
+          {
+            int node = node_of_block[b];
+            while (node != -1 && node != node_of_block[parent[b]])
+              node = separator_parent[node];
+            if (node == -1)
+              {
+                use_separator_tree = false;
+                break;
+              }
+          }
+
+    if (use_separator_tree)
+      {
+        size_t nnodes = separator_parent.Size();
+        TableCreator<int> creator_blocks(nnodes);
+        TableCreator<int> creator_up(nnodes);
+        TableCreator<int> creator_down(nnodes);
+        for ( ; !creator_blocks.Done(); creator_blocks++, creator_up++, creator_down++)
+          {
+            for (size_t b = 0; b < nblocks; b++)
+              if (node_of_block[b] != -1)
+                creator_blocks.Add (node_of_block[b], b);
+            for (size_t node = 0; node < nnodes; node++)
+              if (separator_parent[node] != -1)
+                {
+                  creator_up.Add (node, separator_parent[node]);
+                  creator_down.Add (separator_parent[node], node);
+                }
+          }
+        Table<int> node_blocks = creator_blocks.MoveTable();
+        Table<int> node_up = creator_up.MoveTable();
+        Table<int> node_down = creator_down.MoveTable();
+
+        RunParallelDependency
+          (node_up, node_down, [&] (int node)
+           {
+             for (int b : node_blocks[node])
+               factor_block (b);
+           });
+      }
+    else
+      RunParallelDependency (etree, children, factor_block);
+
+    ParallelFor (n, [&] (size_t i)
+      {
+        TM ai = diag[i];
+        for (auto j : Range(hfirstinrow[i], hfirstinrow[i+1]))
+          lfact[j] = lfact[j] * ai;
+      }, TasksPerThread(5));
+
+    if (n > 2000)
+      cout << IM(4) << endl;
+  }
+
+
+
 
 
   
@@ -1676,10 +2061,69 @@ namespace ngla
   template <class TM, class TV_ROW, class TV_COL>
   void SparseCholesky<TM, TV_ROW, TV_COL> :: 
   SolveReordered (FlatVector<TVX> hy) const
+  {
+    if constexpr (is_same<TM,double>::value && is_same<TVX,double>::value)
+      if (this->lfact_single.Size())
+        {
+          SolveReordered (hy, this->lfact_single.Addr(0), firstinrow.Data());
+          return;
+        }
+    if (this->blr_block.Size())
+      {
+        SolveReordered (hy, this->lfact_blr.Addr(0), this->firstinrow_blr.Data());
+        return;
+      }
+    SolveReordered (hy, lfact.Addr(0), firstinrow.Data());
+  }
+
+  template <class TM, class TV_ROW, class TV_COL> template <typename TFACT>
+  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  SolveReordered (FlatVector<TVX> hy, TFACT * hlfact, const size_t * hfirstinrow) const
   {
     static Timer timer1("SparseCholesky<d,d,d>::MultAdd fac1");
     static Timer timer2("SparseCholesky<d,d,d>::MultAdd fac2");
 
+    // external part of a block compressed to U V^T: 
+    // number of the compressed block, -1 if stored dense
+    auto blr_of = [this] (int blocknr)
+      { return this->blr_block.Size() ? this->blr_block[blocknr] : -1; };
+
+    // temp += V.Rows(myr) U^T hy(range)
+    auto blr_forward = [this,hy] (int blr, IntRange range, IntRange myr, FlatVector<TVX> temp)
+      {
+        size_t nb = range.Size(), k = this->blr_rank[blr];
+        const double * pu = &this->blr_data[this->blr_first[blr]];
+        const double * pv = pu + nb*k;
+        VectorMem<100,TVX> w(k);
+        w = TVX(0.0);
+        for (size_t i = 0; i < nb; i++)
+          for (size_t r = 0; r < k; r++)
+            w(r) += pu[i*k+r] * hy(range.First()+i);
+        for (size_t j = 0; j < temp.Size(); j++)
+          for (size_t r = 0; r < k; r++)
+            temp(j) += pv[(myr.First()+j)*k+r] * w(r);
+      };
+
+    // hy(range) -= U V.Rows(myr)^T temp
+    auto blr_backward = [this,hy] (int blr, IntRange range, IntRange myr, FlatVector<TVX> temp)
+      {
+        size_t nb = range.Size(), k = this->blr_rank[blr];
+        const double * pu = &this->blr_data[this->blr_first[blr]];
+        const double * pv = pu + nb*k;
+        VectorMem<100,TVX> w(k);
+        w = TVX(0.0);
+        for (size_t j = 0; j < temp.Size(); j++)
+          for (size_t r = 0; r < k; r++)
+            w(r) += pv[(myr.First()+j)*k+r] * temp(j);
+        for (size_t i = 0; i < nb; i++)
+          {
+            TVX val(0.0);
+            for (size_t r = 0; r < k; r++)
+              val += pu[i*k+r] * w(r);
+            AtomicAdd (hy(range.First()+i), -val);
+          }
+      };
+
     /*
     // sequential verision 
     for (int i = 0; i < blocks.Size()-1; i++)
@@ -1764,6 +2208,7 @@ namespace ngla
                                { // first L, then B
 
                                  auto extdofs = BlockExtDofs (blocknr);
+                                 int blr = blr_of (blocknr);
                                  VectorMem<520,TVX> temp(extdofs.Size());
                                  temp = 0;
 
@@ -1774,22 +2219,24 @@ namespace ngla
                                      size_t size = range.end()-i-1;
                                      if (size > 0)
                                        {
-                                         FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                         FlatVector<TFACT> vlfact(size, hlfact+hfirstinrow[i]);
                                          
                                          auto hyr = hy.Range(i+1, range.end());
                                          for (size_t j = 0; j < size; j++)
                                            hyr(j) -= Trans(vlfact(j)) * hyi;
                                        }
-                                     if (extdofs.Size() == 0)
+                                     if (extdofs.Size() == 0 || blr >= 0)
                                        {
                                          // cerr << "should not be here" << endl;
                                          continue;
                                        }
-                                     size_t first = firstinrow[i] + range.end()-i-1;
-                                     FlatVector<TM> ext_lfact (extdofs.Size(), &lfact[first]);
+                                     size_t first = hfirstinrow[i] + range.end()-i-1;
+                                     FlatVector<TFACT> ext_lfact (extdofs.Size(), hlfact+first);
                                      for (size_t j = 0; j < temp.Size(); j++)
                                        temp(j) += Trans(ext_lfact(j)) * hyi;
                                    }
+                                 if (blr >= 0)
+                                   blr_forward (blr, range, Range(extdofs), temp);
                                  
                                  for (size_t j : Range(extdofs))
                                    AtomicAdd (hy(extdofs[j]), -temp(j));
@@ -1802,7 +2249,7 @@ namespace ngla
                                    {
                                      size_t size = range.end()-i-1;
                                      if (size == 0) continue;
-                                     FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                     FlatVector<TFACT> vlfact(size, hlfact+hfirstinrow[i]);
 
                                      TVX hyi = hy(i);
                                      auto hyr = hy.Range(i+1, range.end());
@@ -1824,11 +2271,14 @@ namespace ngla
                                      VectorMem<520,TVX> temp(extdofs.Size());
                                      temp = 0;
                                      
+                                     if (int blr = blr_of (blocknr); blr >= 0)
+                                       blr_forward (blr, range, myr, temp);
+                                     else
                                      for (auto i : range)
                                        {
-                                         size_t first = firstinrow[i] + range.end()-i-1;
+                                         size_t first = hfirstinrow[i] + range.end()-i-1;
                                          
-                                         FlatVector<TM> ext_lfact (all_extdofs.Size(), &lfact[first]);
+                                         FlatVector<TFACT> ext_lfact (all_extdofs.Size(), hlfact+first);
  
                                          TVX hyi = hy(i);
                                          for (size_t j = 0; j < temp.Size(); j++)
@@ -1880,11 +2330,13 @@ namespace ngla
                                  for (auto j : Range(extdofs))
                                    temp(j) = hy(extdofs[j]);
 
-                                 if (extdofs.Size())
+                                 if (int blr = blr_of (blocknr); blr >= 0)
+                                   blr_backward (blr, range, Range(extdofs), temp);
+                                 else if (extdofs.Size())
                                    for (auto i : range)
                                      {
-                                       size_t first = firstinrow[i] + range.end()-i-1;
-                                       FlatVector<TM> ext_lfact (extdofs.Size(), &lfact[first]);
+                                       size_t first = hfirstinrow[i] + range.end()-i-1;
+                                       FlatVector<TFACT> ext_lfact (extdofs.Size(), hlfact+first);
                                        
                                        TVX val(0.0);
                                        for (auto j : Range(extdofs))
@@ -1895,7 +2347,7 @@ namespace ngla
                                    {
                                      size_t size = range.end()-i-1;
                                      if (size == 0) continue;
-                                     FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                     FlatVector<TFACT> vlfact(size, hlfact+hfirstinrow[i]);
                                      auto hyr = hy.Range(i+1, range.end());
 
                                      TVX hyi = hy(i);
@@ -1913,7 +2365,7 @@ namespace ngla
                                    {
                                      size_t size = range.end()-i-1;
                                      if (size == 0) continue;
-                                     FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                     FlatVector<TFACT> vlfact(size, hlfact+hfirstinrow[i]);
                                      auto hyr = hy.Range(i+1, range.end());
 
                                      TVX hyi = hy(i);
@@ -1937,10 +2389,13 @@ namespace ngla
                                      for (auto j : Range(extdofs))
                                        temp(j) = hy(extdofs[j]);
     
+                                     if (int blr = blr_of (blocknr); blr >= 0)
+                                       blr_backward (blr, range, myr, temp);
+                                     else
                                      for (auto i : range)
                                        {
-                                         size_t first = firstinrow[i] + range.end()-i-1;
-                                         FlatVector<TM> ext_lfact (all_extdofs.Size(), &lfact[first]);
+                                         size_t first = hfirstinrow[i] + range.end()-i-1;
+                                         FlatVector<TFACT> ext_lfact (all_extdofs.Size(), hlfact+first);
     
                                          TVX val(0.0);
                                          for (auto j : Range(extdofs))
@@ -1960,6 +2415,13 @@ namespace ngla
   void SparseCholesky<TM, TV_ROW, TV_COL> :: 
   MultAdd (TSCAL_VEC s, const BaseVector & x, BaseVector & y) const
   {
+    if constexpr (is_same<TM,double>::value && is_same<TVX,double>::value)
+      if ((this->lfact_single.Size() || this->blr_block.Size()) && !cluster)
+        {
+          MultAddRefined (s, x, y);
+          return;
+        }
+
     static Timer timer("SparseCholesky<d,d,d>::MultAdd");
     RegionTimer reg (timer);
     timer.AddFlops (2.0*lfact.Size());
@@ -2017,6 +2479,74 @@ namespace ngla
   
 
 
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  MultAddRefined (TSCAL_VEC s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer timer("SparseCholesky::MultAdd - iterative refinement");
+    RegionTimer reg (timer);
+
+    auto mat = this->matrix.lock();
+    if (!mat)
+      throw Exception("A matrix not available any more, needed for iterative refinement!");
+
+    const FlatVector<TVX> fx = x.FV<TVX> ();
+    FlatVector<TVX> fy = y.FV<TVX> ();
+
+    VVector<TVX> sol(height), res(height);
+    FlatVector<TVX> fsol = sol.FV();
+    FlatVector<TVX> fres = res.FV();
+    Vector<TVX> hy(this->nused);
+
+    // norm on the dofs of the factorization
+    auto norm = [&] (FlatVector<TVX> v)
+      {
+        double sum = 0;
+        for (int i = 0; i < height; i++)
+          if (order[i] != -1)
+            sum += L2Norm2 (v(i));
+        return sqrt(sum);
+      };
+
+    double normx = norm(fx);
+    fsol = 0.0;
+    fres = fx;
+    int steps = 0;
+    double normres = normx;
+    for ( ; normres > this->refinement_tol * normx && steps < this->max_refinement_steps; steps++)
+      {
+        ParallelFor (Range(height), [&] (int i)
+                     {
+                       if (order[i] != -1)
+                         hy(order[i]) = fres(i);
+                     });
+        SolveReordered(hy);
+        ParallelFor (Range(height), [&] (int i)
+                     {
+                       if (order[i] != -1)
+                         fsol(i) += hy(order[i]);
+                     });
+
+        // residual of the original matrix
+        fres = fx;
+        mat->MultAdd (-1, sol, res);
+        normres = norm(fres);
+      }
+
+    this->refinement_steps = steps;
+    if (normres > this->refinement_tol * normx)
+      cout << IM(1) << "warning: SparseCholesky iterative refinement stopped after "
+           << steps << " steps, relative residual " << normres/normx
+           << " > refinementtol = " << this->refinement_tol << endl;
+
+    ParallelFor (Range(height), [&] (int i)
+                 {
+                   if (order[i] != -1)
+                     fy(i) += s * fsol(i);
+                 });
+  }
+
+
   template <class TM, class TV_ROW, class TV_COL>
   void SparseCholesky<TM, TV_ROW, TV_COL> :: 
   Smooth (BaseVector & u, const BaseVector & f, BaseVector & y) const
@@ -2177,6 +2707,9 @@ namespace ngla
 	cerr << "SparseCholesky::Get: access to upper side not available" << endl;
       }
 
+    if (lfact.Size() != nze)
+      throw Exception ("SparseCholesky::Get: factor is only stored in single precision or compressed");
+
     size_t first = firstinrow[i];
     size_t first_ri = firstinrow_ri[i];
     size_t last = firstinrow[i+1];
@@ -2205,6 +2738,12 @@ namespace ngla
 	    << diag[i] << endl;
       }
     ost << endl;
+
+    if (lfact.Size() != nze)
+      {
+        ost << "factor stored in single precision or compressed" << endl;
+        return ost;
+      }
   
     size_t j = 1;
     for (int i = 1; i <= n; i++)
@@ -129,6 +129,42 @@ namespace ngla
     // maximal non-zero entries in a column
     int maxrow;
 
+    // factor by supernodal multifrontal elimination
+    bool multifrontal = false;
+
+    // separator tree of the nested dissection ordering: node of every
+    // reordered dof and parent of every node, empty for other orderings.
+    // The multifrontal factorization runs independent subtrees in parallel
+    Array<int> separator_node;
+    Array<int> separator_parent;
+
+    // L-factor stored in single precision (only for TM = double),
+    // solutions are corrected by iterative refinement
+    NumaInterleavedArray<float> lfact_single;
+    bool single_precision = false;
+    // the full factor is released after the float copy or the BLR compression,
+    // set by SparseCholesky only if all solves go through the refinement
+    // (double vectors, no cluster)
+    bool release_double_factor = false;
+    int max_refinement_steps = 10;
+    double refinement_tol = 1e-10;
+    mutable int refinement_steps = 0;
+
+    // block low-rank compression of the external parts of large blocks
+    // (only for TM = double and double vectors, ignored otherwise),
+    // solutions are corrected by iterative refinement
+    double blr_tol = 0;
+    int blr_minsize = 64;
+    // per block the number of the compressed block, -1 if dense 
+    Array<int> blr_block;
+    // U (size x rank) followed by V (extsize x rank) in blr_data, both row-major
+    Array<int> blr_rank;
+    Array<size_t> blr_first;
+    Array<double> blr_data;
+    // the L-factor without the compressed parts
+    NumaInterleavedArray<TM> lfact_blr;
+    Array<size_t> firstinrow_blr;
+
     // the original matrix
     // const SparseMatrixTM<TM> & mat;
 
@@ -159,6 +195,8 @@ namespace ngla
     void FactorSPD (); 
     template <typename T>
     void FactorSPD1 (T dummy); 
+    template <typename T>
+    void FactorMultifrontal (T dummy);
 #endif
 
     virtual bool SupportsUpdate() const override { return true; }
@@ -170,6 +208,8 @@ namespace ngla
     }
     ///
     void FactorNew (const SparseMatrix<TM> & a);
+    ///
+    void CompressBlockLowRank ();
 
     /**
        A = L+D+L^T
@@ -184,6 +224,10 @@ namespace ngla
 
     virtual Array<MemoryUsage> GetMemoryUsage () const override
     {
+      if (lfact_single.Size())
+        return { MemoryUsage ("SparseChol", nze*sizeof(float), 1) };
+      if (blr_block.Size())
+        return { MemoryUsage ("SparseChol", lfact_blr.Size()*sizeof(TM) + blr_data.Size()*sizeof(double), 1) };
       return { MemoryUsage ("SparseChol", nze*sizeof(TM), 1) };
     }
 
@@ -196,6 +240,8 @@ namespace ngla
     void SetOrig (int i, int j, const TM & val)
     { Set (order[i], order[j], val); }
 
+    // refinement steps of the last solve with the float or blr factor
+    int GetRefinementSteps () const { return refinement_steps; }
 
     // the dofs of block bnr
     IntRange BlockDofs (int bnr) const { return Range(blocks[bnr], blocks[bnr+1]); }
@@ -249,7 +295,28 @@ namespace ngla
 		    shared_ptr<BitArray> ainner = nullptr,
 		    shared_ptr<const Array<int>> acluster = nullptr,
 		    bool allow_refactor = 0)
-      : SparseCholeskyTM<TM> (a, ainner, acluster, allow_refactor) { ; }
+      : SparseCholeskyTM<TM> (a, ainner, acluster, allow_refactor)
+    {
+      if constexpr (is_same<TM,double>::value)
+        if (this->single_precision || this->blr_block.Size())
+          {
+            if (is_same<TVX,double>::value && !cluster)
+              {
+                this->release_double_factor = true;
+                lfact = NumaInterleavedArray<TM> (0);
+              }
+            else
+              {
+                // the solve without refinement needs the full double factor
+                cout << IM(3) << "SparseCholesky: float or blr factor needs double vectors and no cluster, keeping double factor" << endl;
+                this->single_precision = false;
+                this->blr_tol = 0;
+                this->lfact_single = NumaInterleavedArray<float> (0);
+                this->blr_block.SetSize0();
+                this->lfact_blr = NumaInterleavedArray<TM> (0);
+              }
+          }
+    }
     SparseCholesky() {}
 
     ///
@@ -272,6 +339,10 @@ namespace ngla
     void SolveBlockT (int i, FlatVector<TV> hy) const;
   private:
     void SolveReordered(FlatVector<TVX> hy) const;
+    template <typename TFACT>
+    void SolveReordered(FlatVector<TVX> hy, TFACT * hlfact, const size_t * hfirstinrow) const;
+    // solve with the single precision factor and refine against the matrix
+    void MultAddRefined (TSCAL_VEC s, const BaseVector & x, BaseVector & y) const;
   };
 
 
@@ -1260,6 +1260,32 @@ namespace ngla
   {
     INVERSETYPE old_invtype = inversetype;
 
+    // split off solver modifiers, e.g. "sparsecholesky:multifrontal"
+    inverseflags = Flags();
+    auto pos = ainversetype.find(':');
+    if (pos != string::npos)
+      {
+        stringstream opts(ainversetype.substr(pos+1));
+        ainversetype = ainversetype.substr(0, pos);
+        string opt;
+        while (getline(opts, opt, ':'))
+          {
+            auto eq = opt.find('=');
+            if (eq == string::npos)
+              inverseflags.SetFlag (opt);
+            else
+              {
+                string name = opt.substr(0, eq), val = opt.substr(eq+1);
+                char * endptr;
+                double dval = strtod (val.c_str(), &endptr);
+                if (*endptr == 0 && endptr != val.c_str())
+                  inverseflags.SetFlag (name, dval);
+                else
+                  inverseflags.SetFlag (name, val);
+              }
+          }
+      }
+
     if      (ainversetype == "pardiso" )      SetInverseType ( PARDISO );
     else if (ainversetype == "pardisospd")    SetInverseType ( PARDISOSPD );
     else if (ainversetype == "superlu")       SetInverseType ( SUPERLU );
@@ -1397,19 +1423,16 @@ namespace ngla
   }
 
 
+  // graph of the product, values are set to zero
   template <typename TM_Res, typename TM1, typename TM2>
   shared_ptr<SparseMatrixTM<TM_Res>>
-  MatMult (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb)
+  CreateProductMatrix (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb)
   {
-    static Timer t ("sparse matrix multiplication");
     static Timer t1a ("sparse matrix multiplication - setup a");
     static Timer t1b ("sparse matrix multiplication - setup b");
     static Timer t1b1 ("sparse matrix multiplication - setup b1");
-    static Timer t2 ("sparse matrix multiplication - mult"); 
-    RegionTimer reg(t);
 
     t1a.Start();
-
     // find graph of product
     Array<int> cnt(mata.Height());
     cnt = 0;
@@ -1487,6 +1510,20 @@ namespace ngla
 
 
     t1b.Stop();
+    return prod;
+  }
+
+
+  template <typename TM_Res, typename TM1, typename TM2>
+  shared_ptr<SparseMatrixTM<TM_Res>>
+  MatMult (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb)
+  {
+    static Timer t ("sparse matrix multiplication");
+    static Timer t2 ("sparse matrix multiplication - mult"); 
+    RegionTimer reg(t);
+
+    auto prod = CreateProductMatrix<TM_Res> (mata, matb);
+
     t2.Start();
     
     ParallelForRange
@@ -1563,6 +1600,89 @@ namespace ngla
     return MatMult<std::complex<double>, std::complex<double>, std::complex<double>>(mata, matb);
   }
 
+
+  template <typename TM_Res, typename TM1, typename TM2>
+  SparseMatrixProduct<TM_Res,TM1,TM2> ::
+  SparseMatrixProduct (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb)
+  {
+    static Timer t ("SparseMatrixProduct - symbolic");
+    RegionTimer reg(t);
+
+    prod = CreateProductMatrix<TM_Res> (mata, matb);
+    heighta = mata.Height();
+    nzea = mata.NZE();
+    nzeb = matb.NZE();
+
+    // for every product a_ij b_jk its position in row i of the product
+    firstpos.SetSize (heighta+1);
+    ParallelFor (heighta, [&] (size_t i)
+                 {
+                   size_t cnt = 0;
+                   for (auto j : mata.GetRowIndices(i))
+                     cnt += matb.GetRowIndices(j).Size();
+                   firstpos[i+1] = cnt;
+                 });
+    firstpos[0] = 0;
+    for (size_t i = 0; i < heighta; i++)
+      firstpos[i+1] += firstpos[i];
+
+    positions.SetSize (firstpos[heighta]);
+    ParallelForRange
+      (heighta, [&] (IntRange r)
+       {
+         for (auto i : r)
+           {
+             size_t first = prod->First(i);
+             int * pos = &positions[firstpos[i]];
+             for (auto j : mata.GetRowIndices(i))
+               for (auto k : matb.GetRowIndices(j))
+                 *pos++ = prod->GetPosition(i, k) - first;
+           }
+       },
+       TasksPerThread(10));
+
+    Update (mata, matb);
+  }
+
+  template <typename TM_Res, typename TM1, typename TM2>
+  void SparseMatrixProduct<TM_Res,TM1,TM2> ::
+  Update (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb)
+  {
+    static Timer t ("SparseMatrixProduct - numeric");
+    RegionTimer reg(t);
+
+    if (mata.Height() != heighta || mata.NZE() != nzea || matb.NZE() != nzeb)
+      throw Exception ("SparseMatrixProduct::Update: sparsity patterns have changed");
+
+    ParallelForRange
+      (heighta, [&] (IntRange r)
+       {
+         for (auto i : r)
+           {
+             auto matc_vals = prod->GetRowValues(i);
+             matc_vals = TM_Res(0.0);
+
+             const int * pos = &positions[firstpos[i]];
+             auto mata_ci = mata.GetRowIndices(i);
+             auto mata_vals = mata.GetRowValues(i);
+             for (int j : Range(mata_ci))
+               {
+                 auto vala = mata_vals[j];
+                 auto matb_vals = matb.GetRowValues(mata_ci[j]);
+                 for (size_t k = 0; k < matb_vals.Size(); k++)
+                   matc_vals[pos[k]] += vala * matb_vals[k];
+                 pos += matb_vals.Size();
+               }
+           }
+       },
+       TasksPerThread(10));
+  }
+
+  template class SparseMatrixProduct<double, double, double>;
+  template class SparseMatrixProduct<Complex, Complex, Complex>;
+  template class SparseMatrixProduct<Complex, Complex, double>;
+  template class SparseMatrixProduct<Complex, double, Complex>;
+
   template <class TM, class TV>
   shared_ptr<BaseSparseMatrix>
   SparseMatrixSymmetric<TM,TV> :: Restrict (const SparseMatrixTM<double> & prol,
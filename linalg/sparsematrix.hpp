@@ -179,6 +179,8 @@ namespace ngla
   protected:
     /// sparse direct solver
     mutable INVERSETYPE inversetype = default_inversetype;    // C++11 :-) Windows VS2013
+    /// modifiers for the direct solver, given as "sparsecholesky:opt1:opt2=val"
+    mutable Flags inverseflags;
     bool spd = false;
     
   public:
@@ -262,6 +264,11 @@ namespace ngla
     {
       throw Exception ("BaseSparseMatrix::Reorder");
     }
+
+    /// y(rows) += s * A(rows,:) x, returns false if the storage does not allow row-wise products
+    virtual bool MultAddRows (double s, const BaseVector & x, BaseVector & y,
+                              FlatArray<int> rows) const
+    { return false; }
     
     virtual INVERSETYPE SetInverseType ( INVERSETYPE ainversetype ) const override
     {
@@ -276,6 +283,8 @@ namespace ngla
     virtual INVERSETYPE  GetInverseType () const override
     { return inversetype; }
 
+    const Flags & GetInverseFlags () const { return inverseflags; }
+
     void SetSPD (bool aspd = true) { spd = aspd; }
     bool IsSPD () const { return spd; }
     virtual size_t NZE () const override { return nze; }
@@ -641,6 +650,9 @@ namespace ngla
     virtual void MultAdd1 (double s, const BaseVector & x, BaseVector & y,
 			   const BitArray * ainner = NULL,
 			   const Array<int> * acluster = NULL) const override;
+
+    virtual bool MultAddRows (double s, const BaseVector & x, BaseVector & y,
+                              FlatArray<int> rows) const override;
     
     virtual void DoArchive (Archive & ar) override;
   };
@@ -744,6 +756,17 @@ namespace ngla
       MultAdd (s, x, y);
     }
 
+    // only one triangle is stored, the row-wise SpMM does not apply
+    virtual void MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const override
+    {
+      BaseMatrix::MultAdd (alpha, x, y);
+    }
+
+
+    /// rows store only the lower triangle
+    virtual bool MultAddRows (double s, const BaseVector & x, BaseVector & y,
+                              FlatArray<int> rows) const override
+    { return false; }
 
     /*
       y += s L * x
@@ -809,6 +832,31 @@ namespace ngla
   NGS_DLL_HEADER shared_ptr<SparseMatrixTM<std::complex<double>>>
   MatMult (const SparseMatrixTM<std::complex<double>> & mata, const SparseMatrixTM<std::complex<double>> & matb);
 
+
+  /**
+     Sparse matrix product C = A*B for repeated use.
+     The graph of C and the position of every product a_ij b_jk in C are
+     computed once, Update recomputes the values of C for new values of
+     A and B with unchanged sparsity patterns.
+     A Galerkin product P^T A P is formed by two products (A*P and P^T*(AP)),
+     updated in this order.
+   */
+  template <typename TM_Res, typename TM1, typename TM2>
+  class NGS_DLL_HEADER SparseMatrixProduct
+  {
+    shared_ptr<SparseMatrixTM<TM_Res>> prod;
+    Array<size_t> firstpos;   // first entry of row i in positions
+    Array<int> positions;     // position within row of C
+    size_t heighta, nzea, nzeb;
+  public:
+    SparseMatrixProduct (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb);
+
+    /// numeric phase only, A and B must have the patterns of the constructor
+    void Update (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb);
+
+    shared_ptr<SparseMatrixTM<TM_Res>> GetProduct () const { return prod; }
+  };
+
 #ifdef GOLD
 #include <sparsematrix_spec.hpp>
 #endif
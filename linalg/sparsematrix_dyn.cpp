@@ -185,4 +185,158 @@ namespace ngla
 
   template class SparseMatrixVariableBlocks<double>;  
 
+
+
+  template <typename TSCAL>
+  SparseMatrixSELL<TSCAL> ::
+  SparseMatrixSELL (const SparseMatrixTM<TSCAL> & mat, size_t asigma)
+    : height(mat.Height()), width(mat.Width()), sigma(max(asigma, C))
+  {
+    static Timer t("SparseMatrixSELL ctor"); RegionTimer reg(t);
+
+    // symmetric storage keeps only the lower triangle
+    if (dynamic_cast<const SparseMatrixSymmetric<TSCAL,TSCAL>*> (&mat))
+      throw Exception ("SparseMatrixSELL needs a matrix with non-symmetric storage");
+    
+    nchunks = (height+C-1) / C;
+    
+    // sort rows by length within windows of sigma rows
+    perm.SetSize (height);
+    for (size_t i = 0; i < height; i++)
+      perm[i] = i;
+    for (size_t first = 0; first < height; first += sigma)
+      {
+        size_t next = min(first+sigma, height);
+        QuickSort (perm.Range(first, next), [&mat] (int i, int j)
+                   { return mat.GetRowIndices(i).Size() > mat.GetRowIndices(j).Size(); });
+      }
+
+    firstchunk.SetSize (nchunks+1);
+    firstchunk[0] = 0;
+    for (size_t k = 0; k < nchunks; k++)
+      {
+        size_t maxlen = 0;
+        for (size_t i = k*C; i < min((k+1)*C, height); i++)
+          maxlen = max(maxlen, mat.GetRowIndices(perm[i]).Size());
+        firstchunk[k+1] = firstchunk[k] + maxlen;
+      }
+
+    colnr.SetSize (C*firstchunk[nchunks]);
+    data.SetSize (C*firstchunk[nchunks]);
+
+    ParallelFor (nchunks, [&] (size_t k)
+      {
+        size_t len = firstchunk[k+1]-firstchunk[k];
+        for (size_t l = 0; l < C; l++)
+          {
+            size_t i = k*C+l;
+            size_t j = 0;
+            int padcol = 0;
+            if (i < height)
+              {
+                auto rowind = mat.GetRowIndices(perm[i]);
+                auto rowvals = mat.GetRowValues(perm[i]);
+                for ( ; j < rowind.Size(); j++)
+                  {
+                    colnr[C*(firstchunk[k]+j)+l] = rowind[j];
+                    data[C*(firstchunk[k]+j)+l] = rowvals[j];
+                  }
+                if (rowind.Size())
+                  padcol = rowind.Last();
+              }
+            // padding repeats the last column of the row, with value 0
+            for ( ; j < len; j++)
+              {
+                colnr[C*(firstchunk[k]+j)+l] = padcol;
+                data[C*(firstchunk[k]+j)+l] = TSCAL(0.0);
+              }
+          }
+      });
+  }
+
+  template <typename TSCAL>
+  void SparseMatrixSELL<TSCAL> :: Mult (const BaseVector & x, BaseVector & y) const
+  {
+    y = 0.0;
+    MultAdd (1, x, y);
+  }
+
+  template <typename TSCAL>
+  void SparseMatrixSELL<TSCAL> ::
+  MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SparseMatrixSELL::MultAdd"); RegionTimer reg(t);
+    t.AddFlops (data.Size());
+    
+    auto fx = x.FV<TSCAL>();
+    auto fy = y.FV<TSCAL>();
+
+    ParallelForRange
+      (nchunks, [&] (IntRange myrange)
+       {
+         for (size_t k : myrange)
+           {
+             const TSCAL * pdata = &data[C*firstchunk[k]];
+             const int * pcol = &colnr[C*firstchunk[k]];
+             SIMD<double> sum(0.0);
+             for (size_t j = firstchunk[k]; j < firstchunk[k+1]; j++, pdata += C, pcol += C)
+               {
+                 SIMD<double> hx([pcol,fx] (int l) { return fx(pcol[l]); });
+                 sum += SIMD<double>(pdata) * hx;
+               }
+             for (size_t l = 0, i = k*C; l < C && i < height; l++, i++)
+               fy(perm[i]) += s * sum[l];
+           }
+       }, TasksPerThread(4));
+  }
+
+  // slow path: the SELL layout is by rows, the transpose scatters
+  // every entry with an atomic add
+  template <typename TSCAL>
+  void SparseMatrixSELL<TSCAL> ::
+  MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SparseMatrixSELL::MultTransAdd"); RegionTimer reg(t);
+    t.AddFlops (data.Size());
+    
+    auto fx = x.FV<TSCAL>();
+    auto fy = y.FV<TSCAL>();
+
+    ParallelForRange
+      (nchunks, [&] (IntRange myrange)
+       {
+         for (size_t k : myrange)
+           {
+             SIMD<double> hx([&] (int l)
+                             {
+                               size_t i = k*C+l;
+                               return (i < height) ? s*fx(perm[i]) : 0.0;
+                             });
+             const TSCAL * pdata = &data[C*firstchunk[k]];
+             const int * pcol = &colnr[C*firstchunk[k]];
+             for (size_t j = firstchunk[k]; j < firstchunk[k+1]; j++, pdata += C, pcol += C)
+               {
+                 SIMD<double> prod = SIMD<double>(pdata) * hx;
+                 for (size_t l = 0; l < C; l++)
+                   if (pdata[l] != 0.0)
+                     AtomicAdd (fy(pcol[l]), prod[l]);
+               }
+           }
+       }, TasksPerThread(4));
+  }
+
+  template <typename TSCAL>  
+  AutoVector SparseMatrixSELL<TSCAL> :: CreateRowVector () const
+  {
+    return CreateBaseVector(width, false, 1);    
+  }
+
+  template <typename TSCAL>  
+  AutoVector SparseMatrixSELL<TSCAL> :: CreateColVector () const
+  {
+    return CreateBaseVector(height, false, 1);        
+  }
+
+  template class SparseMatrixSELL<double>;  
+
 }
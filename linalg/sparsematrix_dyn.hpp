@@ -83,6 +83,46 @@ namespace ngla
 
 
 
+  /**
+     Sliced ELLPACK (SELL-C-sigma) copy of a scalar sparse matrix.
+     Rows are grouped in chunks of C = SIMD<double>::Size() rows, every chunk
+     is padded to its longest row and stored column-major, such that one
+     SIMD lane works on one row. Within windows of sigma rows, rows are
+     sorted by length to keep the padding small.
+     Matrices with symmetric storage are not accepted. MultTransAdd is
+     a slow path with one atomic add per entry.
+  */
+  template <class TSCAL>
+  class NGS_DLL_HEADER SparseMatrixSELL : public S_BaseMatrix<TSCAL>
+  {
+  protected:
+    size_t height, width, nchunks, sigma;
+    static constexpr size_t C = SIMD<double>::Size();
+    Array<int> perm;           // original row number of sorted row
+    Array<size_t> firstchunk;  // first entry of chunk, in units of C 
+    Array<int> colnr;
+    Array<TSCAL> data;
+    
+  public:
+    SparseMatrixSELL (const SparseMatrixTM<TSCAL> & mat, size_t asigma = 256);
+
+    int VHeight() const override { return height; }
+    int VWidth() const override { return width; }
+
+    void Mult (const BaseVector & x, BaseVector & y) const override;
+    void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+    void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    AutoVector CreateRowVector () const override;
+    AutoVector CreateColVector () const override;
+
+    size_t NChunks() const { return nchunks; }
+    /// number of stored entries including padding
+    size_t NZEPadded() const { return data.Size(); }
+  };
+
+
+
 }
 #endif
   
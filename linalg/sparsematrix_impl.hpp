@@ -215,6 +215,25 @@ namespace ngla
   
   
 
+  template <class TM, class TV_ROW, class TV_COL>
+  bool SparseMatrix<TM,TV_ROW,TV_COL> ::
+  MultAddRows (double s, const BaseVector & x, BaseVector & y,
+               FlatArray<int> rows) const
+  {
+    static Timer timer ("SparseMatrix::MultAddRows");
+    RegionTimer reg (timer);
+
+    FlatVector<TVX> fx = x.FV<TVX>(); 
+    FlatVector<TVY> fy = y.FV<TVY>(); 
+
+    ParallelForRange (rows.Size(), [&] (IntRange r)
+                      {
+                        for (auto i : r)
+                          fy(rows[i]) += s * RowTimesVector (rows[i], fx);
+                      });
+    return true;
+  }
+
   template <class TM, class TV_ROW, class TV_COL>
   void SparseMatrix<TM,TV_ROW,TV_COL> ::
   MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
@@ -276,11 +295,65 @@ namespace ngla
       AddRowConjTransToVector (i, ConvertTo<TSCAL> (s)*fx(i), fy);
   }
 
+  // y[l] += alpha[l] * A x[l] for KS vectors within one sweep over the matrix
+  template <int KS, typename TSCAL>
+  INLINE void SparseMatMultiVecAdd (IntRange rows, const size_t * firsti, const int * colnr,
+                                    const TSCAL * data, TSCAL ** px, TSCAL ** py,
+                                    const double * alpha)
+  {
+    for (auto i : rows)
+      {
+        TSCAL sum[KS];
+        for (int l = 0; l < KS; l++)
+          sum[l] = TSCAL(0.0);
+        for (size_t j = firsti[i]; j < firsti[i+1]; j++)
+          {
+            TSCAL val = data[j];
+            int col = colnr[j];
+            for (int l = 0; l < KS; l++)
+              sum[l] += val * px[l][col];
+          }
+        for (int l = 0; l < KS; l++)
+          py[l][i] += alpha[l] * sum[l];
+      }
+  }
+  
   template <class TM, class TV_ROW, class TV_COL>
   void SparseMatrix<TM,TV_ROW,TV_COL> ::
   MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const
   {
-    BaseMatrix::MultAdd (alpha, x, y);
+    if constexpr ((is_same<TM,double>::value || is_same<TM,Complex>::value) &&
+                  is_same<TM,TV_ROW>::value && is_same<TM,TV_COL>::value)
+      {
+        static Timer t("SparseMatrix::MultAdd MultiVector"); RegionTimer reg(t);
+        t.AddFlops (this->NZE()*alpha.Size()*sizeof(TM)/sizeof(double));
+
+        // blocks of BS vectors share the traversal of colnr and data
+        constexpr size_t BS = 8;
+        size_t k = alpha.Size();
+        ParallelForRange
+          (balance, [&] (IntRange myrange)
+           {
+             TM * px[BS];
+             TM * py[BS];
+             for (size_t k0 = 0; k0 < k; k0 += BS)
+               {
+                 size_t ks = min(BS, k-k0);
+                 for (size_t l = 0; l < ks; l++)
+                   {
+                     px[l] = x[k0+l]->FV<TM>().Data();
+                     py[l] = y[k0+l]->FV<TM>().Data();
+                   }
+                 Switch<BS> (ks-1, [&] (auto KSm1)
+                   {
+                     SparseMatMultiVecAdd<KSm1.value+1> (myrange, firsti.Data(), colnr.Data(), data.Data(),
+                                                         px, py, &alpha(k0));
+                   });
+               }
+           });
+      }
+    else
+      BaseMatrix::MultAdd (alpha, x, y);
   }
   
 
@@ -493,6 +566,11 @@ namespace ngla
   }
 
 
+  // defined in sparsematrix.cpp
+  template <typename TM_Res, typename TM1, typename TM2>
+  shared_ptr<SparseMatrixTM<TM_Res>>
+  MatMult (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb);
+
   template<class TM, class TV_ROW, class TV_COL>
   shared_ptr<BaseSparseMatrix>
   SparseMatrix<TM,TV_ROW,TV_COL> :: Restrict (const SparseMatrixTM<double> & prol,
@@ -502,6 +580,16 @@ namespace ngla
     static Timer tbuild ("sparsematrix - restrict, build matrix");
     static Timer tcomp ("sparsematrix - restrict, compute matrix");
     RegionTimer reg(t);
+
+    // square blocks: parallel P^T A P via two sparse products
+    if constexpr (mat_traits<TM>::HEIGHT == mat_traits<TM>::WIDTH &&
+                  is_same<SparseMatrix<TM>, SparseMatrix<TM,TV_ROW,TV_COL>>::value)
+      if (!acmat)
+        {
+          auto prolT = dynamic_pointer_cast<SparseMatrixTM<double>> (prol.CreateTranspose());
+          auto prod1 = MatMult<TM, TM, double>(*this, prol);
+          return MatMult<TM, double, TM>(*prolT, *prod1);
+        }
     
     int n = this->Height();
 
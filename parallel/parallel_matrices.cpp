@@ -418,6 +418,28 @@ namespace ngla
 #else
       spmat->SetInverseType(MASTERINVERSE);
 #endif
+
+      if (row_paralleldofs && RowType(op) == CUMULATED &&
+          size_t(mat->Width()) == row_paralleldofs->GetNDofLocal())
+        {
+          BitArray exdofs(row_paralleldofs->GetNDofLocal());
+          exdofs.Clear();
+          for (auto p : row_paralleldofs->GetDistantProcs())
+            for (auto d : row_paralleldofs->GetExchangeDofs(p))
+              exdofs.SetBit(d);
+
+          for (int i = 0; i < mat->Height(); i++)
+            {
+              bool coupling = false;
+              for (auto j : spmat->GetRowIndices(i))
+                if (exdofs.Test(j)) coupling = true;
+              if (coupling)
+                interface_rows.Append(i);
+              else
+                interior_rows.Append(i);
+            }
+          overlap = interior_rows.Size() > 0;
+        }
     }
   }
 
@@ -501,6 +523,37 @@ namespace ngla
 
   void ParallelMatrix :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
   {
+    if (overlap)
+      if (auto xpar = dynamic_cast_ParallelBaseVector(&x);
+          xpar && xpar->GetParallelStatus() == DISTRIBUTED)
+        {
+          static Timer t("ParallelMatrix::MultAdd overlapped");
+          RegionTimer reg(t);
+
+          if (ColType(op) == CUMULATED)
+            y.Cumulate();
+          else
+            y.Distribute();
+
+          auto spmat = static_pointer_cast<BaseSparseMatrix>(mat);
+          auto & lx = *x.GetLocalVector();
+          auto & ly = *y.GetLocalVector();
+          
+          xpar->StartCumulate();
+          if (spmat->MultAddRows (s, lx, ly, interior_rows))
+            {
+              xpar->FinishCumulate();
+              spmat->MultAddRows (s, lx, ly, interface_rows);
+            }
+          else
+            {
+              xpar->FinishCumulate();
+              overlap = false;
+              mat->MultAdd (s, lx, ly);
+            }
+          return;
+        }
+    
     // const auto & xpar = dynamic_cast_ParallelBaseVector(x);
     // auto & ypar = dynamic_cast_ParallelBaseVector(y);
     // if (op & char(2))
@@ -70,6 +70,10 @@ namespace ngla
     shared_ptr<ParallelDofs> row_paralleldofs, col_paralleldofs;
 
     PARALLEL_OP op;
+
+    // rows not coupling to exchange dofs are computed while x is cumulated
+    Array<int> interior_rows, interface_rows;
+    mutable bool overlap = false;
     
   public:
     ParallelMatrix (shared_ptr<BaseMatrix> amat, shared_ptr<ParallelDofs> apardofs,
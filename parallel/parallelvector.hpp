@@ -26,6 +26,11 @@ namespace ngla
     
     Array<MPI_Request> sreqs;
     Array<MPI_Request> rreqs;
+    mutable bool cumulate_started = false;
+    /// vector memory the persistent requests are bound to, nullptr if not set up
+    void * request_memory = nullptr;
+
+    void FreeCumulateRequests ();
 
   public:
     ParallelBaseVector ()
@@ -82,6 +87,11 @@ namespace ngla
     { return local_vec; }
     
     virtual void Cumulate () const override; 
+
+    /// posts the exchange of Cumulate, values must not change until FinishCumulate
+    void StartCumulate () const;
+    /// waits for the exchange and adds the received values
+    void FinishCumulate () const;
     
     virtual void Distribute() const override = 0;
     // { cerr << "ERROR -- Distribute called for BaseVector, is not parallel" << endl; }
@@ -92,6 +102,10 @@ namespace ngla
     virtual void IRecvVec ( int dest, MPI_Request & request ) = 0;
     // { cerr << "ERROR -- IRecvVec called for BaseVector, is not parallel" << endl; }
 
+    /// persistent versions of ISend and IRecvVec, started by MPI_Startall
+    virtual void SendInit ( int dest, MPI_Request & request ) const;
+    virtual void RecvInit ( int dest, MPI_Request & request ) = 0;
+
     // virtual void RecvVec ( int dest )
     // { cerr << "ERROR -- IRecvVec called for BaseVector, is not parallel" << endl; }
     
@@ -193,6 +207,7 @@ namespace ngla
     virtual AutoVector Range (DofRange range) const override;
     
     virtual void  IRecvVec ( int dest, MPI_Request & request ) override;
+    virtual void  RecvInit ( int dest, MPI_Request & request ) override;
     // virtual void  RecvVec ( int dest );
     virtual void AddRecvValues( int sender ) override;
     virtual AutoVector CreateVector () const override;
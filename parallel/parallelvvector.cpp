@@ -223,7 +223,13 @@ namespace ngla
   {
     static Timer t("ParallelVector - Cumulate");
     RegionTimer reg(t);
-    
+
+    StartCumulate();
+    FinishCumulate();
+  }
+
+  void ParallelBaseVector :: StartCumulate () const
+  {
     // #ifdef PARALLEL
     if (status != DISTRIBUTED) return;
     
@@ -233,16 +239,37 @@ namespace ngla
     int nexprocs = exprocs.Size();
     
     ParallelBaseVector * constvec = const_cast<ParallelBaseVector * > (this);
-    
-    for (int idest = 0; idest < nexprocs; idest ++ ) 
-      constvec->ISend (exprocs[idest], sreqs[idest] );
-    for (int isender=0; isender < nexprocs; isender++)
-      constvec -> IRecvVec (exprocs[isender], rreqs[isender] );
-    
-    // if (rreqs.Size()) { // apparently Startall with 0 requests fails b/c invalid request ??
-    //   MPI_Startall(rreqs.Size(), &rreqs[0]);
-    //   MPI_Startall(sreqs.Size(), &sreqs[0]);
-    // }
+
+    // requests are set up once, and again if the vector memory was replaced
+    if (request_memory != Memory())
+      {
+        constvec->FreeCumulateRequests();
+        for (int idest = 0; idest < nexprocs; idest ++ ) 
+          constvec->SendInit (exprocs[idest], constvec->sreqs[idest] );
+        for (int isender=0; isender < nexprocs; isender++)
+          constvec -> RecvInit (exprocs[isender], constvec->rreqs[isender] );
+        constvec->request_memory = Memory();
+      }
+
+#ifdef PARALLEL
+    if (nexprocs) { // apparently Startall with 0 requests fails b/c invalid request ??
+      MPI_Startall(rreqs.Size(), constvec->rreqs.Data());
+      MPI_Startall(sreqs.Size(), constvec->sreqs.Data());
+    }
+#endif
+
+    cumulate_started = true;
+    // #endif
+  }
+
+  void ParallelBaseVector :: FinishCumulate () const
+  {
+    if (!cumulate_started) return;
+    cumulate_started = false;
+
+    auto exprocs = paralleldofs->GetDistantProcs();
+    int nexprocs = exprocs.Size();
+    ParallelBaseVector * constvec = const_cast<ParallelBaseVector * > (this);
 
     MyMPI_WaitAll (sreqs);
     
@@ -254,7 +281,6 @@ namespace ngla
       } 
 
     SetStatus(CUMULATED);
-    // #endif
   }
   
 
@@ -268,6 +294,26 @@ namespace ngla
 #endif
   }
 
+  void ParallelBaseVector :: SendInit ( int dest, MPI_Request & request ) const
+  {
+#ifdef PARALLEL
+    MPI_Datatype mpi_t = this->paralleldofs->GetMPI_Type(dest);
+    MPI_Send_init( Memory(), 1, mpi_t, dest, MPI_TAG_SOLVE, this->paralleldofs->GetCommunicator(), &request);
+#endif
+  }
+
+  void ParallelBaseVector :: FreeCumulateRequests ()
+  {
+#ifdef PARALLEL
+    if (!request_memory) return;
+    for (auto & req : sreqs)
+      MPI_Request_free (&req);
+    for (auto & req : rreqs)
+      MPI_Request_free (&req);
+#endif
+    request_memory = nullptr;
+  }
+
   /*
   void ParallelBaseVector :: Send ( int dest ) const
   {
@@ -415,6 +461,7 @@ namespace ngla
   template <class SCAL>
   S_ParallelBaseVectorPtr<SCAL> :: ~S_ParallelBaseVectorPtr ()
   {
+    this->FreeCumulateRequests();
     delete recvvalues;
   }
 
@@ -425,6 +472,7 @@ namespace ngla
   {
     if (this->paralleldofs == aparalleldofs) return;
 
+    this->FreeCumulateRequests();
     this -> paralleldofs = aparalleldofs;
     if ( this -> paralleldofs == 0 ) return;
     
@@ -435,7 +483,7 @@ namespace ngla
     delete this->recvvalues;
     this -> recvvalues = new Table<TSCAL> (exdofs);
 
-    // Initiate persistent send/recv requests for vector cumulate operation
+    // persistent send/recv requests for cumulate are created by StartCumulate
     auto dps = paralleldofs->GetDistantProcs();
     this->sreqs.SetSize(dps.Size());
     this->rreqs.SetSize(dps.Size());
@@ -537,6 +585,18 @@ namespace ngla
 #endif
   }
 
+  template <typename SCAL>
+  void S_ParallelBaseVectorPtr<SCAL> :: RecvInit ( int dest, MPI_Request & request )
+  {
+#ifdef PARALLEL
+    MPI_Datatype MPI_TS = GetMPIType<TSCAL> ();
+    MPI_Recv_init( &( (*recvvalues)[dest][0]), 
+                   (*recvvalues)[dest].Size(), 
+                   MPI_TS, dest, 
+                   MPI_TAG_SOLVE, this->paralleldofs->GetCommunicator(), &request);
+#endif
+  }
+
   /*
   template <typename SCAL>
   void S_ParallelBaseVectorPtr<SCAL> :: RecvVec ( int dest)
@@ -31,7 +31,7 @@ namespace ngsolve
     ///
     bool print;
     ///
-    enum SOLVER { CG, GMRES, QMR/*, NCG */, SIMPLE, DIRECT, BICGSTAB };
+    enum SOLVER { CG, GMRES, QMR/*, NCG */, SIMPLE, DIRECT, BICGSTAB, PIPELINEDCG };
     ///
     enum IP_TYPE { SYMMETRIC, HERMITEAN, CONJ_HERMITEAN };
     ///
@@ -94,6 +94,8 @@ namespace ngsolve
           ost << "DIRECT" << endl; break;
 	case BICGSTAB:
 	  ost << "BiCGStab" << endl; break;
+        case PIPELINEDCG:
+          ost << "pipelined CG" << endl; break;
         default:
           ost << "Unknown solver-type" << endl;
         }
@@ -132,7 +134,7 @@ namespace ngsolve
     if (flags.GetDefineFlag ("direct"))
       cout << "*** warning: flag -direct deprecated: use -solver=direct instead" << endl;
     
-    // new style: -solver=cg|qmr|gmres|direct|bicgstab
+    // new style: -solver=cg|qmr|gmres|direct|bicgstab|pipelinedcg
     {
       string solvername = flags.GetStringFlag("solver","cg");
       if (solvername == "cg")     solver = CG;
@@ -141,6 +143,7 @@ namespace ngsolve
       if (solvername == "simple") solver = SIMPLE;
       if (solvername == "direct") solver = DIRECT;
       if (solvername == "bicgstab") solver = BICGSTAB;
+      if (solvername == "pipelinedcg") solver = PIPELINEDCG;
     }       
     
     string ipflag = flags.GetStringFlag("innerproduct","symmetric");
@@ -226,6 +229,10 @@ namespace ngsolve
 	    cout << IM(1) << "cg solve for real system" << endl;
 	    invmat = new CGSolver<double>(mat, premat);
 	    break;
+	  case PIPELINEDCG:
+	    cout << IM(1) << "pipelined cg solve for real system" << endl;
+	    invmat = new PipelinedCGSolver<double>(mat, premat);
+	    break;
           case BICGSTAB:
 	    cout << IM(1) << "bicgstab solve for real system" << endl;
 	    invmat = new BiCGStabSolver<double>(mat, premat);
@@ -261,6 +268,10 @@ namespace ngsolve
             cout << IM(1) << "cg solve for complex system" << endl;
             invmat = new CGSolver<Complex>(mat, premat);
 	    break;
+          case PIPELINEDCG:
+            cout << IM(1) << "pipelined cg solve for complex system" << endl;
+            invmat = new PipelinedCGSolver<Complex>(mat, premat);
+            break;
           case BICGSTAB:
 	    cout << IM(1) << "bicgstab solve for complex system" << endl;
 	    invmat = new BiCGStabSolver<Complex>(mat, premat);
@@ -297,6 +308,10 @@ namespace ngsolve
             cout << IM(1) << "cg solve for complex system" << endl;
             invmat = new CGSolver<ComplexConjugate>(mat, premat);
 	    break;
+          case PIPELINEDCG:
+            cout << IM(1) << "pipelined cg solve for complex system" << endl;
+            invmat = new PipelinedCGSolver<ComplexConjugate>(mat, premat);
+            break;
           case BICGSTAB:
 	    cout << IM(1) << "bicgstab solve for complex system" << endl;
 	    invmat = new BiCGStabSolver<ComplexConjugate>(mat, premat);
@@ -332,6 +347,10 @@ namespace ngsolve
             cout << IM(1) << "cg solve for complex system" << endl;
             invmat = new CGSolver<ComplexConjugate2>(mat, premat);
 	    break;
+          case PIPELINEDCG:
+            cout << IM(1) << "pipelined cg solve for complex system" << endl;
+            invmat = new PipelinedCGSolver<ComplexConjugate2>(mat, premat);
+            break;
           case BICGSTAB:
 	    cout << IM(1) << "bicgstab solve for complex system" << endl;
 	    invmat = new BiCGStabSolver<ComplexConjugate2>(mat, premat);
@@ -0,0 +1,25 @@
+from ngsolve import *
+import os
+
+def test_checkpoint():
+    comm = MPI_Init()
+    mesh = Mesh('square.vol.gz', comm)
+    fes = H1(mesh, order=3) * L2(mesh, order=2)
+    u = GridFunction(fes, multidim=2)
+    tmp = GridFunction(fes)
+    for i in range(2):
+        tmp.components[0].Set(x*y+i)
+        tmp.components[1].Set(x-i)
+        u.vecs[i].data = tmp.vec
+    filename = "checkpoint_test.ngscp"
+    u.SaveCheckpoint(filename)
+    myfile = filename + "." + str(comm.rank) if comm.size > 1 else filename
+    assert os.path.exists(myfile)
+
+    u2 = GridFunction(fes, multidim=2)
+    u2.LoadCheckpoint(filename)
+    diff = u.vecs[0].CreateVector()
+    for i in range(2):
+        diff.data = u.vecs[i] - u2.vecs[i]
+        assert Norm(diff) < 1e-14 * Norm(u.vecs[i])
+    os.remove(myfile)
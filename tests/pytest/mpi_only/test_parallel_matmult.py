@@ -0,0 +1,23 @@
+from ngsolve import *
+
+def test_overlapped_matmult():
+    comm = MPI_Init()
+    mesh = Mesh('square.vol.gz', comm)
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx + u*v*dx).Assemble()
+    f = LinearForm(x*y*v*dx).Assemble()
+
+    # f.vec is distributed, its cumulation overlaps with the interior rows
+    y1 = a.mat.CreateColVector()
+    y1.data = a.mat * f.vec
+
+    xcum = f.vec.CreateVector()
+    xcum.data = f.vec
+    xcum.Cumulate()
+    y2 = a.mat.CreateColVector()
+    y2.data = a.mat * xcum
+
+    diff = y1.CreateVector()
+    diff.data = y1 - y2
+    assert Norm(diff) < 1e-12 * Norm(y2)
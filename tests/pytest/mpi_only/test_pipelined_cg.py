@@ -0,0 +1,18 @@
+from ngsolve import *
+
+def test_pipelined_cg():
+    comm = MPI_Init()
+    mesh = Mesh('square.vol.gz', comm)
+    fes = H1(mesh, order=2, dirichlet=".*")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx).Assemble()
+    f = LinearForm(v*dx).Assemble()
+    pre = Preconditioner(a, "local")
+    a.Assemble()
+    gfu1 = GridFunction(fes)
+    gfu2 = GridFunction(fes)
+    gfu1.vec.data = la.CGSolver(a.mat, pre.mat, printrates=False, precision=1e-10, maxsteps=500) * f.vec
+    gfu2.vec.data = la.PipelinedCGSolver(a.mat, pre.mat, printrates=False, precision=1e-10, maxsteps=500) * f.vec
+    diff = gfu1.vec.CreateVector()
+    diff.data = gfu1.vec - gfu2.vec
+    assert Norm(diff) < 1e-8 * Norm(gfu1.vec)
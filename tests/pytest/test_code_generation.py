@@ -102,6 +102,24 @@ def test_code_generation_python_module(unit_mesh_3d):
     ne_after = unit_mesh_3d.ne
     assert 8*ne_before==ne_after
 
+def test_code_generation_cache(unit_mesh_3d, tmp_path):
+    from ngsolve.fem import CompilePythonModule, SetCompileCacheDirectory
+
+    SetCompileCacheDirectory(str(tmp_path))
+    try:
+        code = """m.def("mycube", [](double x) {return x*x*x;});"""
+        m1 = CompilePythonModule(code)
+        assert len(list(tmp_path.glob("cf_*.key"))) > 0
+        m2 = CompilePythonModule(code)
+        assert m1.mycube(3) == m2.mycube(3) == 27
+
+        cf = x*y+sin(z)
+        mip = unit_mesh_3d(0.2,0.3,0.4)
+        assert cf.Compile(True, wait=True)(mip) == approx(cf(mip))
+        assert cf.Compile(True, wait=True)(mip) == approx(cf(mip))
+    finally:
+        SetCompileCacheDirectory("")
+
 if __name__ == "__main__":
     test_code_generation_derivatives()
     test_code_generation_volume_terms()
@@ -79,6 +79,30 @@ def test_diff(unit_mesh_3d):
     for cf in cfs:
         assert Integrate( Norm(cf.Diff(u,CF((1,0,0)))-cf.Diff(u)*CF((1,0,0))),unit_mesh_3d) == approx(0.0)
     
+def test_voxel_cf(unit_mesh_2d, unit_mesh_3d):
+    import numpy as np
+    # bilinear functions are reproduced by linear interpolation,
+    # Integrate uses the SIMD evaluation
+    n = 11
+    xs = np.linspace(0, 1, n)
+    vals = np.outer(xs, xs) + xs[np.newaxis,:]   # vals[iy,ix] = x*y+x
+    for dtype in [np.float64, np.float32]:
+        vcf = VoxelCoefficient((0,0), (1,1), vals.astype(dtype), linear=True)
+        assert Integrate((vcf-(x*y+x))**2, unit_mesh_2d) == approx(0)
+        assert vcf(unit_mesh_2d(0.33, 0.71)) == approx(0.33*0.71+0.33, rel=1e-6)
+
+    vals3 = np.einsum("i,j,k->ijk", 1+xs, xs, xs)  # vals3[iz,iy,ix] = x*y*(1+z)
+    vcf = VoxelCoefficient((0,0,0), (1,1,1), vals3, linear=True)
+    assert Integrate((vcf-x*y*(1+z))**2, unit_mesh_3d) == approx(0)
+
+    # nearest voxel value, the structured mesh is aligned with the voxels
+    from ngsolve.meshes import MakeStructured2DMesh
+    vals = np.random.rand(7,5)
+    vcf = VoxelCoefficient((0,0), (1,1), vals, linear=False)
+    mesh = MakeStructured2DMesh(nx=5, ny=7)
+    assert Integrate(vcf, mesh) == approx(vals.mean())
+    assert vcf(mesh(0.5, 0.3)) == approx(vals[2,2])
+
 if __name__ == "__main__":
     test_pow()
     test_ParameterCF()
@@ -87,3 +111,4 @@ if __name__ == "__main__":
     test_domainwise_cf()
     test_evaluate()
     test_diff()
+    test_voxel_cf()
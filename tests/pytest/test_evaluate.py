@@ -24,3 +24,31 @@ def test_eval_curved_surface():
     sinvals = np.sin(phivals)
     assert max(uvals-sinvals) < 1e-5
 
+
+def test_element_search_tree():
+    from netgen.geom2d import unit_square
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3, dim=2)
+    u = GridFunction(fes)
+    u.Set((x*x*y, sin(x)))
+
+    rng = np.random.default_rng(42)
+    pts = rng.uniform(-0.1, 1.1, size=(2000,2))
+    tree = ElementSearchTree(mesh)
+    elnums, refpts = tree.Locate(pts)
+    vals = tree.Evaluate(u, pts)
+
+    inside = np.all((pts >= 0) & (pts <= 1), axis=1)
+    assert np.all((elnums >= 0) == inside)
+    assert np.all(np.isnan(vals[~inside]))
+    mips = mesh(pts[inside,0], pts[inside,1])
+    assert np.max(np.abs(vals[inside] - u(mips))) < 1e-12
+
+    # boxes follow the deformation
+    deform = GridFunction(H1(mesh, order=1, dim=2))
+    deform.Set((0.5, 0))
+    mesh.SetDeformation(deform)
+    tree.Update()
+    elnums, refpts = tree.Locate(np.array([[1.25, 0.5], [0.25, 0.5]]))
+    assert elnums[0] >= 0 and elnums[1] == -1
+    mesh.UnsetDeformation()
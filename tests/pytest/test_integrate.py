@@ -25,3 +25,16 @@ def test_integrate_xy():
     intC = Integrate(1j*x*y,mesh)
     assert abs(intR-1./4) < 1e-14
     assert abs(intC- 1j*1./4) < 1e-14
+
+def test_linearform_boundary_skeleton():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.05))
+    fes = H1(mesh, order=3)
+    v = fes.TestFunction()
+    f = LinearForm(fes)
+    f += (1+x*y)*v*ds
+    fskel = LinearForm(fes)
+    fskel += (1+x*y)*v*ds(skeleton=True)
+    f.Assemble()
+    with TaskManager():
+        fskel.Assemble()
+    assert Norm(f.vec-fskel.vec) < 1e-12 * Norm(f.vec)
@@ -3,6 +3,7 @@ from ngsolve import *
 from netgen.geom2d import unit_square
 from netgen.csg import unit_cube
 import numpy as np
+from ngsolve.meshes import MakeStructured2DMesh, MakeStructured3DMesh
 
 def test_matrix():
     n = 10
@@ -99,7 +100,203 @@ def test_sparsematrix_access():
     a.Assemble()
     assert abs(a.mat[1,1][0,0] - (reference_values[3])) < 1e-8
 
+def assert_same_operator(mat, matref):
+    vx = matref.CreateRowVector()
+    vx.SetRandom()
+    y = matref.CreateColVector()
+    yref = matref.CreateColVector()
+    y.data = mat * vx
+    yref.data = matref * vx
+    assert Norm(y-yref) < 1e-10 * Norm(yref)
+
+def test_nonassemble_sumfactorization():
+    meshes = [MakeStructured2DMesh(quads=True, nx=3, ny=2, mapping = lambda x,y : (x+0.2*y*y, y)),
+              MakeStructured3DMesh(hexes=True, nx=2, ny=2, nz=2, mapping = lambda x,y,z : (x*(0.4+0.4*y)**2,0.75*y,1.25*z))]
+    for mesh in meshes:
+        for order in [1,2,4]:
+            fes = H1(mesh, order=order)
+            u,v = fes.TnT()
+            form = (1+x)*grad(u)*grad(v)*dx + u*v*dx
+            a1 = BilinearForm(form).Assemble()
+            a2 = BilinearForm(form, nonassemble=True).Assemble()
+            assert_same_operator(a2.mat, a1.mat)
+
+def test_assemble_elements():
+    mesh = MakeStructured2DMesh(quads=False, nx=4, ny=4)
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    rho = GridFunction(L2(mesh, order=0))
+    rho.Set(1)
+    form = rho*grad(u)*grad(v)*dx + u*v*dx
+
+    for condense in [False, True]:
+        a = BilinearForm(form, condense=condense, store_elmats=True).Assemble()
+        for el in mesh.Elements():
+            if el.nr % 3 == 0:
+                rho.vec[el.nr] = 2 + el.nr
+        changed = BitArray(mesh.ne)
+        changed.Clear()
+        for i in range(mesh.ne):
+            if i % 3 == 0:
+                changed.Set(i)
+        a.AssembleElements(changed)
+        aref = BilinearForm(form, condense=condense).Assemble()
+        assert_same_operator(a.mat, aref.mat)
+        if condense:
+            assert_same_operator(a.harmonic_extension, aref.harmonic_extension)
+        rho.Set(1)
+
+def test_sparse_matrix_product():
+    mesh = Mesh("square.vol.gz")
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    c = Parameter(1)
+    a = BilinearForm(grad(u)*grad(v)*dx + c*u*v*dx).Assemble()
+    m = BilinearForm(u*v*dx).Assemble()
+
+    prod = la.SparseMatrixProduct(a.mat, m.mat)
+    x = a.mat.CreateRowVector()
+    x.SetRandom()
+    y1 = x.CreateVector()
+    y2 = x.CreateVector()
+
+    for cval in [1, 5]:
+        c.Set(cval)
+        a.Assemble()
+        prod.Update(a.mat, m.mat)
+        y1.data = prod.mat * x
+        y2.data = a.mat * (m.mat * x)
+        assert Norm(y1-y2) < 1e-12 * Norm(y2)
+
+def test_small_matrix_kernels():
+    import ngsolve.bla
+    assert isinstance(ngsolve.bla.__kernel_isa__(), str)
+    # widths up to the end of the dispatch tables hit every small kernel
+    for w in range(1, 26):
+        a = Matrix(11, w)
+        b = Matrix(w, 9)
+        a.NumPy()[:] = np.random.rand(11, w)
+        b.NumPy()[:] = np.random.rand(w, 9)
+        c = a * b
+        assert np.allclose(c.NumPy(), a.NumPy() @ b.NumPy())
+        c = a.T * a
+        assert np.allclose(c.NumPy(), a.NumPy().T @ a.NumPy())
+        c = a * a.T
+        assert np.allclose(c.NumPy(), a.NumPy() @ a.NumPy().T)
+        x = Vector(w)
+        x.NumPy()[:] = np.random.rand(w)
+        y = a * x
+        assert np.allclose(y.NumPy(), a.NumPy() @ x.NumPy())
+
+def test_nonassemble_precompute():
+    mesh = MakeStructured2DMesh(quads=False, nx=4, ny=4, mapping = lambda x,y : (x+0.2*y*y, y))
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    p = Parameter(1)
+    coef = CacheCF((1+x*y)*p)
+    form = coef*grad(u)*grad(v)*dx + coef*u*v*dx
+    a = BilinearForm(form, nonassemble=True, precompute=True).Assemble()
+
+    def check(num_precomputations):
+        assert_same_operator(a.mat, BilinearForm(form).Assemble().mat)
+        assert a.num_precomputations == num_precomputations
+
+    # reused while nothing changes, also by Assemble
+    check(1)
+    check(1)
+    a.Assemble()
+    check(1)
+    p.Set(3)
+    check(2)
+    deform = GridFunction(VectorH1(mesh, order=1))
+    deform.Set((0.1*x*y, 0))
+    mesh.SetDeformation(deform)
+    check(3)
+    # the same deformation changed in place, and set again
+    deform.vec.data = 2 * deform.vec
+    mesh.SetDeformation(deform)
+    check(4)
+    mesh.UnsetDeformation()
+    check(5)
+
+def test_nonassemble_dg_facets():
+    mesh = MakeStructured2DMesh(quads=False, nx=5, ny=5, mapping = lambda x,y : (x+0.2*y*y, y))
+    fes = L2(mesh, order=3)
+    u,v = fes.TnT()
+    n = specialcf.normal(2)
+    b = CF((1+y, 0.5))
+    uup = IfPos(b*n, u, u.Other())
+    c = Parameter(1)
+    form = -c*b*u*grad(v)*dx + c*b*n*uup*v*dx(element_boundary=True)
+    form_facets = -c*b*u*grad(v)*dx + CacheCF(c*b*n)*uup*(v-v.Other())*dx(skeleton=True) \
+        + c*IfPos(b*n, b*n, 0)*u*v*ds(skeleton=True)
+
+    for precompute in [False, True]:
+        c.Set(1)
+        a = BilinearForm(form_facets, nonassemble=True, precompute=precompute).Assemble()
+        for val in [1, 2]:
+            c.Set(val)
+            assert_same_operator(a.mat, BilinearForm(form).Assemble().mat)
+        assert a.num_skeleton_facet_builds == 1
+        # the facet coloring of the space is renewed by an update
+        fes.Update()
+        assert_same_operator(a.mat, BilinearForm(form).Assemble().mat)
+        assert a.num_skeleton_facet_builds == 2
+
+def test_shape_tables():
+    meshes = [Mesh(unit_square.GenerateMesh(maxh=0.3)), Mesh(unit_cube.GenerateMesh(maxh=0.4))]
+    for mesh in meshes:
+        for space in [H1, L2]:
+            for order in [2,3,5]:
+                fes = space(mesh, order=order)
+                u,v = fes.TnT()
+                n = specialcf.normal(mesh.dim)
+                # element_boundary maps facet rules into the element, trace shapes are tabulated too
+                form = (1+x)*grad(u)*grad(v)*dx + u*v*dx + (1+y)*(grad(u)*n)*v*dx(element_boundary=True)
+                aref = BilinearForm(form)
+                for bfi in aref.integrators:
+                    bfi.simd_evaluate = False
+                aref.Assemble()
+                a1 = BilinearForm(form).Assemble()
+                a2 = BilinearForm(form, nonassemble=True).Assemble()
+                for a in [a1, a2]:
+                    assert_same_operator(a.mat, aref.mat)
+                # the same element classes, orders and rules find their tables
+                ntables = fem.NumShapeTables()
+                assert_same_operator(BilinearForm(form).Assemble().mat, aref.mat)
+                assert fem.NumShapeTables() == ntables
+
+def test_condense_batched():
+    # inner blocks are inverted in SIMD batches, of different sizes on trigs and quads
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2, quad_dominated=True))
+    for fes in [H1(mesh, order=4, dirichlet="left"), H1(mesh, order=3, dim=2, dirichlet="left")]:
+        u,v = fes.TnT()
+        form = InnerProduct(grad(u),grad(v))*dx + InnerProduct(u,v)*dx
+        load = (1+x) * (v if fes.dim == 1 else v[0]+y*v[1]) * dx
+
+        aref = BilinearForm(form).Assemble()
+        fref = LinearForm(load).Assemble()
+        ref = GridFunction(fes)
+        ref.vec.data = aref.mat.Inverse(fes.FreeDofs()) * fref.vec
+
+        a = BilinearForm(form, condense=True).Assemble()
+        f = LinearForm(load).Assemble()
+        gfu = GridFunction(fes)
+        f.vec.data += a.harmonic_extension_trans * f.vec
+        gfu.vec.data = a.mat.Inverse(fes.FreeDofs(True)) * f.vec
+        gfu.vec.data += a.harmonic_extension * gfu.vec
+        gfu.vec.data += a.inner_solve * f.vec
+        assert Norm(gfu.vec-ref.vec) < 1e-10 * Norm(ref.vec)
+
 if __name__ == "__main__":
     test_matrix()
     test_matrix_numpy()
     test_sparsematrix_access()
+    test_nonassemble_sumfactorization()
+    test_assemble_elements()
+    test_sparse_matrix_product()
+    test_small_matrix_kernels()
+    test_nonassemble_precompute()
+    test_nonassemble_dg_facets()
+    test_shape_tables()
+    test_condense_batched()
@@ -272,6 +272,32 @@ def test_pickle_sparsecholesky():
     assert Norm(u2.vec) < 1e-16
 
 
+def test_gridfunction_checkpoint(tmp_path):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=3, dirichlet=[1,2,3,4]) * L2(mesh, order=2)
+    u = GridFunction(fes, multidim=3)
+    tmp = GridFunction(fes)
+    for i in range(3):
+        tmp.components[0].Set(x*y+i)
+        tmp.components[1].Set(x-i)
+        u.vecs[i].data = tmp.vec
+    filename = str(tmp_path / "u.ngscp")
+    u.SaveCheckpoint(filename)
+
+    for mmap in [False, True]:
+        u2 = GridFunction(fes, multidim=3)
+        comp = u2.components[1]
+        u2.LoadCheckpoint(filename, mmap=mmap)
+        for i in range(3):
+            assert Norm(u.vecs[i]-u2.vecs[i]) < 1e-14
+        assert Norm(comp.vec-u.components[1].vec) < 1e-14
+
+    othermesh = Mesh(unit_square.GenerateMesh(maxh=0.25))
+    u3 = GridFunction(H1(othermesh, order=3, dirichlet=[1,2,3,4]) * L2(othermesh, order=2), multidim=3)
+    with pytest.raises(Exception):
+        u3.LoadCheckpoint(filename)
+
+
 if __name__ == "__main__":
     test_pickle_volume_fespaces()
     test_pickle_surface_fespaces()
@@ -77,6 +77,236 @@ def test_krylovspace_solvers():
         assert error < 1e-12
 
 
+def test_sparsecholesky_multifrontal():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx+u*v*dx).Assemble()
+    f = LinearForm(x*v*dx).Assemble()
+    gfu1 = GridFunction(fes)
+    gfu2 = GridFunction(fes)
+    gfu1.vec.data = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky") * f.vec
+    gfu2.vec.data = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky:multifrontal") * f.vec
+    assert Norm(gfu1.vec-gfu2.vec) < 1e-10 * Norm(gfu1.vec)
+
+
+def test_sparsecholesky_nested_dissection():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.05))
+    fes = H1(mesh, order=2, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx+u*v*dx).Assemble()
+    f = LinearForm(x*v*dx).Assemble()
+    gfu1 = GridFunction(fes)
+    gfu1.vec.data = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky") * f.vec
+    gfu2 = GridFunction(fes)
+    for inverse in ["sparsecholesky:ordering=nd", "sparsecholesky:ordering=nd:multifrontal",
+                    "sparsecholesky:ordering=nd:ndleafsize=8:multifrontal"]:
+        gfu2.vec.data = a.mat.Inverse(fes.FreeDofs(), inverse=inverse) * f.vec
+        assert Norm(gfu1.vec-gfu2.vec) < 1e-10 * Norm(gfu1.vec)
+
+
+def test_sparsecholesky_float():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx+u*v*dx).Assemble()
+    f = LinearForm(x*v*dx).Assemble()
+    gfu1 = GridFunction(fes)
+    gfu2 = GridFunction(fes)
+    gfu1.vec.data = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky") * f.vec
+    inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky:float")
+    gfu2.vec.data = inv * f.vec
+    # the float factor needs corrections, but converges before the limit
+    assert 1 < inv.refinementsteps < 10
+    assert Norm(gfu1.vec-gfu2.vec) < 1e-6 * Norm(gfu1.vec)
+
+
+def test_sparsematrix_sell():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx+x*u*v*dx).Assemble()
+    sell = la.SparseMatrixSELL(a.mat, sigma=64)
+    assert sell.nze_padded >= a.mat.nze
+    vx = a.mat.CreateRowVector()
+    vx.SetRandom()
+    y1 = a.mat.CreateColVector()
+    y2 = a.mat.CreateColVector()
+    y1.data = a.mat * vx
+    y2.data = sell * vx
+    assert Norm(y1-y2) < 1e-12 * Norm(y1)
+    y1.data = a.mat.T * vx
+    y2.data = sell.T * vx
+    assert Norm(y1-y2) < 1e-12 * Norm(y1)
+    asym = BilinearForm(grad(u)*grad(v)*dx, symmetric=True).Assemble()
+    with pytest.raises(Exception):
+        la.SparseMatrixSELL(asym.mat)
+    f = LinearForm(x*v*dx).Assemble()
+    pre = a.mat.CreateSmoother(fes.FreeDofs())
+    gfu1 = GridFunction(fes)
+    gfu2 = GridFunction(fes)
+    gfu1.vec.data = CGSolver(a.mat, pre, tol=1e-12) * f.vec
+    gfu2.vec.data = CGSolver(sell, pre, tol=1e-12) * f.vec
+    assert Norm(gfu1.vec-gfu2.vec) < 1e-8 * Norm(gfu1.vec)
+
+
+def test_parallel_gauss_seidel():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.05))
+    fes = H1(mesh, order=1, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx).Assemble()
+    f = LinearForm(v*dx).Assemble()
+    gfu = GridFunction(fes)
+    with TaskManager():
+        pre = a.mat.CreateSmoother(fes.FreeDofs(), GS=True)
+        # colored forward and backward sweeps give a symmetric preconditioner
+        vx, vy = a.mat.CreateColVector(), a.mat.CreateColVector()
+        vx.SetRandom()
+        vy.SetRandom()
+        vx.data = Projector(fes.FreeDofs(), True) * vx
+        vy.data = Projector(fes.FreeDofs(), True) * vy
+        assert abs(InnerProduct(pre*vx, vy) - InnerProduct(vx, pre*vy)) < 1e-10 * Norm(vx) * Norm(vy)
+        solver = CGSolver(a.mat, pre, tol=1e-10, maxiter=500)
+        gfu.vec.data = solver * f.vec
+        assert solver.iterations < 500
+    inv = a.mat.Inverse(fes.FreeDofs())
+    ref = (inv * f.vec).Evaluate()
+    assert Norm(gfu.vec-ref) < 1e-7 * Norm(ref)
+
+
+def test_pipelined_cg():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx).Assemble()
+    f = LinearForm(v*dx).Assemble()
+    pre = a.mat.CreateSmoother(fes.FreeDofs())
+    cg = la.CGSolver(a.mat, pre, printrates=False, precision=1e-10, maxsteps=500)
+    pcg = la.PipelinedCGSolver(a.mat, pre, printrates=False, precision=1e-10, maxsteps=500)
+    gfu1 = GridFunction(fes)
+    gfu2 = GridFunction(fes)
+    gfu1.vec.data = cg * f.vec
+    gfu2.vec.data = pcg * f.vec
+    # same Krylov space, iterations differ only by rounding
+    assert abs(pcg.GetSteps() - cg.GetSteps()) <= 2
+    assert Norm(gfu1.vec-gfu2.vec) < 1e-8 * Norm(gfu1.vec)
+
+
+def test_block_krylov():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=2, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx+u*v*dx).Assemble()
+    pre = a.mat.CreateSmoother(fes.FreeDofs())
+    inv = a.mat.Inverse(fes.FreeDofs())
+    loads = [1, x, y, x*y, x*x]
+    rhs = MultiVector(a.mat.CreateColVector(), len(loads))
+    for i, load in enumerate(loads):
+        rhs[i].data = LinearForm(load*v*dx).Assemble().vec
+    ref = a.mat.CreateColVector()
+    for solver in [la.BlockCG, la.BlockGMRes]:
+        sol = MultiVector(a.mat.CreateRowVector(), len(loads))
+        steps = solver(a.mat, rhs, sol, pre=pre, tol=1e-10, maxsteps=200)
+        assert steps < 200
+        for i in range(len(loads)):
+            ref.data = inv * rhs[i]
+            assert Norm(sol[i]-ref) < 1e-8 * Norm(ref)
+
+    # restarted with a short Krylov space
+    sol = MultiVector(a.mat.CreateRowVector(), len(loads))
+    steps = la.BlockGMRes(a.mat, rhs, sol, pre=pre, tol=1e-10, maxsteps=1000, restart=10)
+    assert steps < 1000
+    for i in range(len(loads)):
+        ref.data = inv * rhs[i]
+        assert Norm(sol[i]-ref) < 1e-8 * Norm(ref)
+
+    # linearly dependent right hand sides are deflated
+    rhs2 = MultiVector(a.mat.CreateColVector(), 3)
+    rhs2[0].data = rhs[1]
+    rhs2[1].data = rhs[2]
+    rhs2[2].data = rhs[1] + 2 * rhs[2]
+    sol = MultiVector(a.mat.CreateRowVector(), 3)
+    steps = la.BlockGMRes(a.mat, rhs2, sol, pre=pre, tol=1e-10, maxsteps=200)
+    assert steps < 200
+    for i in range(3):
+        ref.data = inv * rhs2[i]
+        assert Norm(sol[i]-ref) < 1e-8 * Norm(ref)
+
+
+def test_saamg():
+    iterations = []
+    for maxh in [0.1, 0.05, 0.025]:
+        mesh = Mesh(unit_square.GenerateMesh(maxh=maxh))
+        fes = H1(mesh, order=1, dirichlet="left|bottom")
+        u,v = fes.TnT()
+        a = BilinearForm(grad(u)*grad(v)*dx)
+        pre = Preconditioner(a, "saamg", coarsesize=50)
+        a.Assemble()
+        f = LinearForm(v*dx).Assemble()
+        inv = CGSolver(a.mat, pre, tol=1e-10, maxiter=200)
+        gfu = GridFunction(fes)
+        gfu.vec.data = inv * f.vec
+        iterations.append(inv.iterations)
+    # mesh independent: bounded, and not growing under refinement
+    assert max(iterations) < 40
+    assert iterations[-1] <= iterations[0] + 5
+
+    # block entries Mat<2,2>
+    fes = H1(mesh, order=1, dim=2, dirichlet="left")
+    u,v = fes.TnT()
+    eps = lambda w: 0.5*(grad(w)+grad(w).trans)
+    a = BilinearForm(InnerProduct(eps(u),eps(v))*dx + 0.5*Trace(grad(u))*Trace(grad(v))*dx)
+    pre = Preconditioner(a, "saamg", coarsesize=50)
+    a.Assemble()
+    f = LinearForm(CF((0,-1))*v*dx).Assemble()
+    inv = CGSolver(a.mat, pre, tol=1e-10, maxiter=500)
+    gfu = GridFunction(fes)
+    gfu.vec.data = inv * f.vec
+    assert inv.iterations < 200
+    ref = GridFunction(fes)
+    ref.vec.data = a.mat.Inverse(fes.FreeDofs()) * f.vec
+    assert Norm(gfu.vec-ref.vec) < 1e-6 * Norm(ref.vec)
+
+
+def test_sparsecholesky_blr():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.05))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx+u*v*dx).Assemble()
+    f = LinearForm(x*v*dx).Assemble()
+    gfu1 = GridFunction(fes)
+    gfu2 = GridFunction(fes)
+    gfu1.vec.data = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky:ordering=nd") * f.vec
+    inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky:ordering=nd:blrtol=1e-6:blrminsize=16")
+    gfu2.vec.data = inv * f.vec
+    assert Norm(gfu1.vec-gfu2.vec) < 1e-10 * Norm(gfu1.vec)
+
+
+def test_blockjacobi_batched_inverse():
+    import numpy as np
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx+u*v*dx).Assemble()
+    # vertex patches, many of them have the same size
+    blocks = [set(d for el in vert.elements for d in fes.GetDofNrs(el)) for vert in mesh.vertices]
+    pre = a.mat.CreateBlockSmoother(blocks)
+
+    x = a.mat.CreateRowVector()
+    x.SetRandom()
+    y = x.CreateVector()
+    y.data = pre * x
+
+    rows, cols, vals = a.mat.COO()
+    dense = np.zeros((fes.ndof, fes.ndof))
+    np.add.at(dense, (np.array(rows), np.array(cols)), np.array(vals))
+    xnp = x.FV().NumPy()
+    yref = np.zeros_like(xnp)
+    for block in blocks:
+        b = sorted(block)
+        yref[b] += np.linalg.solve(dense[np.ix_(b,b)], xnp[b])
+    assert np.linalg.norm(y.FV().NumPy()-yref) < 1e-10 * np.linalg.norm(yref)
+
 
 if __name__ == "__main__":
     # test_arnoldi()
@@ -0,0 +1,45 @@
+import base64, struct
+import xml.etree.ElementTree as ET
+from pytest import approx
+from meshes import *
+from ngsolve import *
+
+
+def ReadInlineArray(dataarray, fmt):
+    data = base64.b64decode(dataarray.text.strip())
+    nbytes = struct.unpack("<Q", data[:8])[0]
+    return struct.unpack("<" + fmt * (nbytes // struct.calcsize(fmt)), data[8:8+nbytes])
+
+
+def test_vtkoutput_encodings(unit_mesh_2d, tmp_path):
+    mesh = unit_mesh_2d
+    cf = x*y
+    for encoding in ["raw", "base64"]:
+        for compress in [False, True]:
+            filename = str(tmp_path / ("out_"+encoding+str(compress)))
+            vtk = VTKOutput(mesh, coefs=[cf], names=["xy"], filename=filename, subdivision=1,
+                            encoding=encoding, compress=compress)
+            vtk.Do()
+            assert (tmp_path / ("out_"+encoding+str(compress)+".vtu")).exists()
+
+    root = ET.parse(str(tmp_path / "out_base64False.vtu")).getroot()
+    piece = root.find("UnstructuredGrid").find("Piece")
+    npoints = int(piece.get("NumberOfPoints"))
+    ncells = int(piece.get("NumberOfCells"))
+    assert npoints == 3 * 4 * mesh.ne
+    assert ncells == 4 * mesh.ne
+
+    points = ReadInlineArray(piece.find("Points").find("DataArray"), "d")
+    values = ReadInlineArray(piece.find("PointData").find("DataArray"), "d")
+    assert len(values) == npoints
+    for i in range(npoints):
+        assert values[i] == approx(points[3*i] * points[3*i+1])
+
+    types = ReadInlineArray(piece.find("Cells").findall("DataArray")[2], "B")
+    assert all(t == 5 for t in types)
+
+
+if __name__ == "__main__":
+    import pathlib, tempfile
+    from netgen.geom2d import unit_square
+    test_vtkoutput_encodings(Mesh(unit_square.GenerateMesh(maxh=0.2)), pathlib.Path(tempfile.mkdtemp()))